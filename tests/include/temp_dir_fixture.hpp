@@ -0,0 +1,35 @@
+#ifndef XX_TESTS_TEMP_DIR_FIXTURE_HPP
+#define XX_TESTS_TEMP_DIR_FIXTURE_HPP
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+// Gives every test an empty directory of its own, removed again when the test ends.
+struct TempDirFixture : public ::testing::Test {
+	std::filesystem::path root;
+
+	void SetUp() override {
+		const auto* test = ::testing::UnitTest::GetInstance()->current_test_info();
+		root = std::filesystem::temp_directory_path() / ("xx_test_" + std::string(test->test_suite_name()) + "_" + test->name());
+		std::filesystem::remove_all(root);
+		std::filesystem::create_directories(root);
+	}
+
+	void TearDown() override {
+		std::filesystem::remove_all(root);
+	}
+
+	// Replaces the file at relative below root, creating its directory, and returns its path.
+	std::string write_file(const std::filesystem::path& relative, std::string_view content) const {
+		const auto path = root / relative;
+		std::filesystem::create_directories(path.parent_path());
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << content;
+		return path.string();
+	}
+};
+
+#endif // XX_TESTS_TEMP_DIR_FIXTURE_HPP
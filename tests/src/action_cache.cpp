@@ -0,0 +1,200 @@
+#include "detail/action_cache.hpp"
+#include "detail/cache_backends/disk_backend.hpp"
+#include "detail/executor.hpp"
+#include "temp_dir_fixture.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace {
+	struct ActionCacheFixture : public TempDirFixture {
+		std::filesystem::path base;
+		std::string directory;
+		std::shared_ptr<xxlib::action_cache::DiskBackend> backend;
+		Command command{
+			.name = "pack",
+			.cmd = {"./pack.sh"},
+			.inputs = {"assets/*.png"},
+			.outputs = {"out/assets.pak"},
+			.cacheResults = true,
+		};
+
+		void SetUp() override {
+			TempDirFixture::SetUp();
+			std::filesystem::create_directories(root / "work" / "out");
+			base = root / "work";
+			directory = (root / "cache").string();
+			backend = std::make_shared<xxlib::action_cache::DiskBackend>(directory);
+
+			write("assets/a.png", "first");
+			write("assets/b.png", "second");
+		}
+
+		void write(const std::string& relative, const std::string& content) const {
+			write_file(std::filesystem::path("work") / relative, content);
+		}
+
+		std::string read(const std::string& relative) const {
+			std::ifstream file(base / relative, std::ios::binary);
+			std::stringstream content;
+			content << file.rdbuf();
+			return content.str();
+		}
+
+		std::string key(const std::vector<std::string>& extras = {}) const {
+			const auto result = xxlib::action_cache::action_key(command, extras, base);
+			EXPECT_TRUE(result.has_value()) << result.error();
+			return result.value_or("");
+		}
+	};
+} // namespace
+
+TEST_F(ActionCacheFixture, KeyFollowsContentNotTimestamps) {
+	const auto original = key();
+	EXPECT_EQ(original.size(), 64u);
+	EXPECT_EQ(key(), original);
+
+	const auto path = base / "assets/a.png";
+	std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::hours(1));
+	EXPECT_EQ(key(), original);
+
+	EXPECT_NE(key({"level=9"}), original);
+
+	write("assets/a.png", "changed");
+	EXPECT_NE(key(), original);
+}
+
+#ifndef _WIN32
+TEST_F(ActionCacheFixture, KeyFollowsListedEnvironment) {
+	::unsetenv("XX_ACTION_CACHE_TEST_CC");
+	const auto original = key();
+
+	// Only variables named in cache_env count, besides PATH.
+	::setenv("XX_ACTION_CACHE_TEST_CC", "clang", 1);
+	EXPECT_EQ(key(), original);
+
+	command.cacheEnv = {"XX_ACTION_CACHE_TEST_CC"};
+	const auto withClang = key();
+	EXPECT_NE(withClang, original);
+	::setenv("XX_ACTION_CACHE_TEST_CC", "gcc", 1);
+	EXPECT_NE(key(), withClang);
+	::setenv("XX_ACTION_CACHE_TEST_CC", "", 1);
+	const auto empty = key();
+	::unsetenv("XX_ACTION_CACHE_TEST_CC");
+	EXPECT_NE(key(), empty);
+
+	const std::string path = std::getenv("PATH") ? std::getenv("PATH") : "";
+	::setenv("PATH", (path + ":/xx-action-cache-test").c_str(), 1);
+	const auto otherPath = key();
+	::setenv("PATH", path.c_str(), 1);
+	EXPECT_NE(otherPath, key());
+}
+#endif
+
+TEST_F(ActionCacheFixture, StoredOutputsAreRestored) {
+	write("out/assets.pak", "packed");
+	std::filesystem::permissions(base / "out/assets.pak", std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
+
+	const auto entry = xxlib::action_cache::Entry{.log = "packing 2 files\n"};
+	ASSERT_TRUE(xxlib::action_cache::store(*backend, base, key(), entry, command.outputs).has_value());
+
+	std::filesystem::remove_all(base / "out");
+	const auto found = xxlib::action_cache::lookup(*backend, key());
+	ASSERT_TRUE(found.has_value()) << found.error();
+	EXPECT_EQ(found->log, entry.log);
+	ASSERT_EQ(found->outputs.size(), 1u);
+	EXPECT_EQ(found->outputs.front().path, "out/assets.pak");
+
+	ASSERT_TRUE(xxlib::action_cache::restore(*backend, base, *found).has_value());
+	EXPECT_EQ(read("out/assets.pak"), "packed");
+	EXPECT_NE(std::filesystem::status(base / "out/assets.pak").permissions() & std::filesystem::perms::owner_exec, std::filesystem::perms::none);
+
+	EXPECT_FALSE(xxlib::action_cache::lookup(*backend, key({"level=9"})).has_value());
+}
+
+TEST_F(ActionCacheFixture, MissingOutputsAreNotStored) {
+	EXPECT_FALSE(xxlib::action_cache::store(*backend, base, key(), {}, command.outputs).has_value());
+	EXPECT_FALSE(xxlib::action_cache::lookup(*backend, key()).has_value());
+}
+
+TEST_F(ActionCacheFixture, EvictsLeastRecentlyUsedFiles) {
+	const auto now = std::filesystem::file_time_type::clock::now();
+	for (int i = 0; i < 4; ++i) {
+		const auto path = root / "cache" / ("file" + std::to_string(i));
+		std::filesystem::create_directories(path.parent_path());
+		std::ofstream(path, std::ios::binary) << std::string(1000, 'x');
+		std::filesystem::last_write_time(path, now - std::chrono::hours(4 - i));
+	}
+
+	EXPECT_EQ(xxlib::action_cache::evict(directory, 4000).removed, 0u);
+	const auto evicted = xxlib::action_cache::evict(directory, 3000);
+	EXPECT_EQ(evicted.removed, 2000u);
+	EXPECT_EQ(evicted.remaining, 2000u);
+	EXPECT_FALSE(std::filesystem::exists(root / "cache/file0"));
+	EXPECT_FALSE(std::filesystem::exists(root / "cache/file1"));
+	EXPECT_TRUE(std::filesystem::exists(root / "cache/file3"));
+}
+
+TEST_F(ActionCacheFixture, DiskBackendWalksOnlyPastTheLimit) {
+	auto small = xxlib::action_cache::DiskBackend(directory, 3000);
+	const auto digest = std::string(64, 'a');
+	ASSERT_TRUE(small.put(xxlib::action_cache::Kind::Blob, digest, std::string(1000, 'b')).has_value());
+	ASSERT_TRUE(small.put(xxlib::action_cache::Kind::Action, digest, "entry").has_value());
+	EXPECT_TRUE(std::filesystem::exists(root / "cache" / "size"));
+
+	// Files the recorded size does not know about are only found by the next walk.
+	const auto stray = root / "cache" / "stray";
+	std::ofstream(stray, std::ios::binary) << std::string(5000, 's');
+	std::filesystem::last_write_time(stray, std::filesystem::file_time_type::clock::now() - std::chrono::hours(1));
+	ASSERT_TRUE(small.put(xxlib::action_cache::Kind::Action, std::string(64, 'c'), "entry").has_value());
+	EXPECT_TRUE(std::filesystem::exists(stray));
+
+	ASSERT_TRUE(small.put(xxlib::action_cache::Kind::Blob, std::string(64, 'd'), std::string(2500, 'b')).has_value());
+	ASSERT_TRUE(small.put(xxlib::action_cache::Kind::Action, std::string(64, 'e'), "entry").has_value());
+	EXPECT_FALSE(std::filesystem::exists(stray));
+}
+
+#ifndef _WIN32
+TEST_F(ActionCacheFixture, ExecutorReplaysInsteadOfRunning) {
+	const auto previous = std::filesystem::current_path();
+	std::filesystem::current_path(base);
+
+	auto run = [this](std::string& output) {
+		auto copy = Command{
+			.name = "pack",
+			.cmd = {"echo packing && echo run >> runs.log && cat assets/*.png > out/assets.pak"},
+			.inputs = command.inputs,
+			.outputs = command.outputs,
+			.cacheResults = true,
+		};
+		auto context = CommandContext{
+			.output = [&output](std::string_view chunk) {
+				output.append(chunk);
+			},
+			.actionCache = backend,
+		};
+		return xxlib::executor::execute_command(copy, context);
+	};
+
+	std::string first;
+	std::string second;
+	const auto ran = run(first);
+	xxlib::executor::wait_for_uploads();
+	std::filesystem::remove(base / "out/assets.pak");
+	const auto replayed = run(second);
+	std::filesystem::current_path(previous);
+
+	ASSERT_TRUE(ran.has_value()) << ran.error();
+	ASSERT_TRUE(replayed.has_value()) << replayed.error();
+	EXPECT_EQ(*replayed, 0);
+	EXPECT_EQ(first, "packing\n");
+	EXPECT_EQ(second, first);
+	EXPECT_EQ(read("out/assets.pak"), "firstsecond");
+	EXPECT_EQ(read("runs.log"), "run\n");
+}
+#endif
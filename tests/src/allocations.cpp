@@ -0,0 +1,87 @@
+#include "detail/command.hpp"
+#include "detail/command_registry.hpp"
+#include "detail/planner.hpp"
+#include "detail/platform.hpp"
+#include "detail/serializer.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+	std::atomic<size_t> allocationCount{0};
+
+	// Commands made of short strings, so that every counted allocation is a container buffer.
+	std::vector<Command> make_commands(size_t count) {
+		std::vector<Command> commands;
+		for (size_t i = 0; i < count; ++i) {
+			commands.push_back(Command{
+				.name = "alias" + std::to_string(i),
+				.cmd = {"make"},
+				.templateVars = {{"dir", "build"}, {"jobs", "4"}, {"target", "all"}},
+				.envs = {{"CC", "clang"}, {"CXX", "clang++"}, {"LANG", "C"}},
+				.constraints = {{"os", xxlib::platform::os_to_string(xxlib::platform::get_current_os())}},
+			});
+		}
+		return commands;
+	}
+} // namespace
+
+void* operator new(size_t size) {
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (auto* ptr = std::malloc(size == 0 ? 1 : size)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+	std::free(ptr);
+}
+
+TEST(Allocations_ReadCommands, OneBufferPerContainer) {
+	const auto commands = make_commands(100);
+
+	xxlib::serializer::Writer writer;
+	xxlib::serializer::write_commands(writer, commands);
+
+	auto reader = xxlib::serializer::Reader{.data = writer.buffer};
+	const auto before = allocationCount.load();
+	const auto result = xxlib::serializer::read_commands(reader);
+	const auto allocations = allocationCount.load() - before;
+
+	ASSERT_TRUE(result.has_value()) << result.error();
+	ASSERT_EQ(result->size(), commands.size());
+	// The commands vector plus the cmd, template var, env and constraint buffers of each command.
+	EXPECT_LE(allocations, 1 + commands.size() * 4);
+}
+
+TEST(Allocations_PlanSingle, DoesNotAllocate) {
+	const auto commands = make_commands(100);
+
+	const auto before = allocationCount.load();
+	const auto result = xxlib::planner::plan_single(commands, "alias42");
+	const auto allocations = allocationCount.load() - before;
+
+	ASSERT_TRUE(result.has_value()) << result.error();
+	EXPECT_EQ((*result)->name, "alias42");
+	EXPECT_EQ(allocations, 0u);
+}
+
+TEST(Allocations_PlanSingle, RegistryLookupDoesNotAllocate) {
+	const auto registry = xxlib::CommandRegistry(make_commands(100));
+
+	const auto before = allocationCount.load();
+	const auto result = xxlib::planner::plan_single(registry, "alias42");
+	const auto allocations = allocationCount.load() - before;
+
+	ASSERT_TRUE(result.has_value()) << result.error();
+	EXPECT_EQ((*result)->name, "alias42");
+	EXPECT_EQ(allocations, 0u);
+}
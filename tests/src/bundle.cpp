@@ -0,0 +1,97 @@
+#include "detail/bundle.hpp"
+#include "detail/serializer.hpp"
+#include "temp_dir_fixture.hpp"
+#include "xxlib.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+
+namespace {
+	struct BundleFixture : public TempDirFixture {
+		std::string bundlePath;
+
+		void SetUp() override {
+			TempDirFixture::SetUp();
+			bundlePath = (root / "project.xxb").string();
+		}
+
+		void write_raw(const std::string& content) const {
+			write_file("project.xxb", content);
+		}
+	};
+
+	std::vector<Command> sample_commands() {
+		return {
+			Command{
+				.name = "build",
+				.cmd = {"make", "make install"},
+				.envs = {{"CC", "clang"}},
+				.constraints = {{"osfamily", "unix"}},
+			},
+			Command{
+				.name = "script",
+				.cmd = {"return 0"},
+				.executionEngine = xxlib::executor::Engine::Lua,
+			},
+			Command{
+				.name = "templated",
+				.cmd = {"return {{ code }}"},
+				.templateVars = {{"code", "0"}},
+				.renderEngine = xxlib::renderer::Engine::Inja,
+				.executionEngine = xxlib::executor::Engine::Lua,
+			},
+		};
+	}
+} // namespace
+
+TEST_F(BundleFixture, WriteAndLoad) {
+	const auto commands = sample_commands();
+	ASSERT_TRUE(xxlib::bundle::write(bundlePath, commands).has_value());
+
+	const auto bundle = xxlib::bundle::load(bundlePath);
+	ASSERT_TRUE(bundle.has_value()) << bundle.error();
+	EXPECT_EQ(bundle->commands, commands);
+	ASSERT_EQ(bundle->luaChunks.size(), commands.size());
+}
+
+TEST_F(BundleFixture, PrecompilesOnlyUntemplatedLua) {
+	ASSERT_TRUE(xxlib::bundle::write(bundlePath, sample_commands()).has_value());
+
+	const auto bundle = xxlib::bundle::load(bundlePath);
+	ASSERT_TRUE(bundle.has_value()) << bundle.error();
+	EXPECT_TRUE(bundle->luaChunks[0].empty());
+	EXPECT_TRUE(bundle->luaChunks[1].starts_with("\x1bLua"));
+	EXPECT_TRUE(bundle->luaChunks[2].empty());
+}
+
+TEST_F(BundleFixture, RejectsOtherVersions) {
+	xxlib::serializer::Writer writer;
+	writer.u32(xxlib::bundle::MAGIC);
+	writer.u32(xxlib::bundle::FORMAT_VERSION);
+	writer.str("0.0.0-other");
+	xxlib::serializer::write_commands(writer, sample_commands());
+	write_raw(writer.buffer);
+
+	const auto bundle = xxlib::bundle::load(bundlePath);
+	ASSERT_FALSE(bundle.has_value());
+	EXPECT_NE(bundle.error().find("0.0.0-other"), std::string::npos);
+}
+
+TEST_F(BundleFixture, RejectsOtherFiles) {
+	write_raw("alias:\n  build:\n    cmd: make\n");
+
+	const auto bundle = xxlib::bundle::load(bundlePath);
+	ASSERT_FALSE(bundle.has_value());
+	EXPECT_EQ(bundle.error(), "Not a bundle or an unsupported bundle format: " + bundlePath);
+}
+
+TEST_F(BundleFixture, RejectsTruncatedBundles) {
+	ASSERT_TRUE(xxlib::bundle::write(bundlePath, sample_commands()).has_value());
+	std::filesystem::resize_file(bundlePath, std::filesystem::file_size(bundlePath) - 4);
+
+	EXPECT_FALSE(xxlib::bundle::load(bundlePath).has_value());
+}
+
+TEST_F(BundleFixture, MissingFile) {
+	EXPECT_FALSE(xxlib::bundle::load(bundlePath).has_value());
+}
@@ -0,0 +1,107 @@
+#include "detail/cache.hpp"
+#include "temp_dir_fixture.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+	struct CacheFixture : public TempDirFixture {
+		std::filesystem::path cacheDir;
+		std::filesystem::path configPath;
+
+		void SetUp() override {
+			TempDirFixture::SetUp();
+			cacheDir = root / "cache";
+			configPath = root / ".xx.yaml";
+		}
+
+		void write_config(const std::string& content) const {
+			write_file(".xx.yaml", content);
+		}
+	};
+
+	const std::string CONFIG = R"(
+alias:
+  build:
+    - cmd: "echo Building project"
+      constraints:
+        - osfamily: unix
+)";
+} // namespace
+
+TEST_F(CacheFixture, StoreAndLoad) {
+	write_config(CONFIG);
+
+	const auto stamp = xxlib::cache::make_stamp(configPath.string(), CONFIG);
+	ASSERT_TRUE(stamp.has_value()) << stamp.error();
+
+	const auto entryPath = xxlib::cache::entry_path(cacheDir.string(), configPath.string());
+	const auto document = xxlib::parser::Document{
+		.commands = {{.name = "build", .cmd = {"echo Building project"}}},
+		.includes = {"teams/*.yaml"},
+	};
+
+	ASSERT_TRUE(xxlib::cache::store(entryPath, *stamp, document).has_value());
+	EXPECT_TRUE(std::filesystem::exists(entryPath));
+
+	const auto loaded = xxlib::cache::load(entryPath, *stamp);
+	ASSERT_TRUE(loaded.has_value()) << loaded.error();
+	ASSERT_EQ(loaded->commands.size(), 1u);
+	EXPECT_EQ(loaded->commands.at(0).name, "build");
+	EXPECT_EQ(loaded->commands.at(0).cmd.at(0), "echo Building project");
+	EXPECT_EQ(loaded->includes, document.includes);
+}
+
+TEST_F(CacheFixture, StaleWhenContentChanges) {
+	write_config(CONFIG);
+
+	const auto stamp = xxlib::cache::make_stamp(configPath.string(), CONFIG);
+	ASSERT_TRUE(stamp.has_value());
+
+	const auto entryPath = xxlib::cache::entry_path(cacheDir.string(), configPath.string());
+	ASSERT_TRUE(xxlib::cache::store(entryPath, *stamp, {}).has_value());
+
+	auto changedStamp = *stamp;
+	changedStamp.hash ^= 1;
+
+	const auto loaded = xxlib::cache::load(entryPath, changedStamp);
+	ASSERT_FALSE(loaded.has_value());
+	EXPECT_EQ(loaded.error(), "Cache entry is stale");
+}
+
+TEST_F(CacheFixture, RejectsCorruptedEntry) {
+	write_config(CONFIG);
+
+	const auto stamp = xxlib::cache::make_stamp(configPath.string(), CONFIG);
+	ASSERT_TRUE(stamp.has_value());
+
+	const auto entryPath = xxlib::cache::entry_path(cacheDir.string(), configPath.string());
+	std::filesystem::create_directories(cacheDir);
+	std::ofstream(entryPath, std::ios::binary) << "garbage";
+
+	const auto loaded = xxlib::cache::load(entryPath, *stamp);
+	ASSERT_FALSE(loaded.has_value());
+	EXPECT_EQ(loaded.error(), "Cache entry has an incompatible format");
+}
+
+TEST_F(CacheFixture, ParseCachedPopulatesAndReuses) {
+	write_config(CONFIG);
+
+	const auto first = xxlib::cache::parse_cached(configPath.string(), CONFIG, cacheDir.string());
+	ASSERT_TRUE(first.has_value()) << first.error();
+	ASSERT_EQ(first->commands.size(), 1u);
+
+	const auto entryPath = xxlib::cache::entry_path(cacheDir.string(), configPath.string());
+	ASSERT_TRUE(std::filesystem::exists(entryPath));
+
+	const auto stamp = xxlib::cache::make_stamp(configPath.string(), CONFIG);
+	ASSERT_TRUE(stamp.has_value());
+	ASSERT_TRUE(xxlib::cache::load(entryPath, *stamp).has_value());
+
+	const auto second = xxlib::cache::parse_cached(configPath.string(), CONFIG, cacheDir.string());
+	ASSERT_TRUE(second.has_value());
+	ASSERT_EQ(second->commands.size(), 1u);
+	EXPECT_EQ(second->commands.at(0).name, "build");
+	EXPECT_EQ(second->commands.at(0).constraints, first->commands.at(0).constraints);
+}
@@ -0,0 +1,251 @@
+#include "detail/cache_backends/http_backend.hpp"
+#include "detail/executor.hpp"
+#include "detail/hash.hpp"
+#include <gtest/gtest.h>
+
+#ifndef _WIN32
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+	// Stand-in for a remote cache: a loopback HTTP/1.1 server answering GET, HEAD and PUT from memory, one request per
+	// connection.
+	class StandInServer {
+	  public:
+		StandInServer() {
+			listener = ::socket(AF_INET, SOCK_STREAM, 0);
+			const int reuse = 1;
+			::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+			sockaddr_in address{};
+			address.sin_family = AF_INET;
+			address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+			::listen(listener, 64);
+
+			socklen_t length = sizeof(address);
+			::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length);
+			port = ntohs(address.sin_port);
+
+			thread = std::thread([this]() {
+				while (true) {
+					const auto client = ::accept(listener, nullptr, nullptr);
+					if (client < 0) {
+						return;
+					}
+					serve(client);
+					::close(client);
+				}
+			});
+		}
+
+		~StandInServer() {
+			::shutdown(listener, SHUT_RDWR);
+			::close(listener);
+			thread.join();
+		}
+
+		[[nodiscard]] std::string url() const {
+			return "http://127.0.0.1:" + std::to_string(port) + "/cache/";
+		}
+
+		[[nodiscard]] size_t count(const std::string& method) {
+			std::lock_guard lock(mutex);
+			return std::count(methods.begin(), methods.end(), method);
+		}
+
+		std::atomic<bool> refusePuts = false;
+
+	  private:
+		void serve(int client) {
+			std::string request;
+			char chunk[4096];
+			size_t headerEnd = std::string::npos;
+			while (headerEnd == std::string::npos) {
+				const auto received = ::recv(client, chunk, sizeof(chunk), 0);
+				if (received <= 0) {
+					return;
+				}
+				request.append(chunk, static_cast<size_t>(received));
+				headerEnd = request.find("\r\n\r\n");
+			}
+
+			std::istringstream head(request.substr(0, headerEnd));
+			std::string method;
+			std::string target;
+			head >> method >> target;
+
+			size_t contentLength = 0;
+			for (std::string line; std::getline(head, line);) {
+				if (line.starts_with("Content-Length:") || line.starts_with("content-length:")) {
+					contentLength = std::stoul(line.substr(15));
+				}
+			}
+
+			auto body = request.substr(headerEnd + 4);
+			while (body.size() < contentLength) {
+				const auto received = ::recv(client, chunk, sizeof(chunk), 0);
+				if (received <= 0) {
+					return;
+				}
+				body.append(chunk, static_cast<size_t>(received));
+			}
+
+			std::string status = "404 Not Found";
+			std::string content;
+			{
+				std::lock_guard lock(mutex);
+				methods.push_back(method);
+				if (method == "PUT") {
+					status = refusePuts ? "507 Insufficient Storage" : "201 Created";
+					if (!refusePuts) {
+						blobs[target] = body;
+					}
+				} else if (const auto found = blobs.find(target); found != blobs.end()) {
+					status = "200 OK";
+					content = found->second;
+				}
+			}
+
+			auto response = "HTTP/1.1 " + status + "\r\nContent-Length: " + std::to_string(content.size()) + "\r\nConnection: close\r\n\r\n";
+			if (method != "HEAD") {
+				response += content;
+			}
+			::send(client, response.data(), response.size(), MSG_NOSIGNAL);
+		}
+
+		int listener = -1;
+		uint16_t port = 0;
+		std::thread thread;
+		std::mutex mutex;
+		std::map<std::string, std::string> blobs;
+		std::vector<std::string> methods;
+	};
+
+	std::string digest_of(std::string_view content) {
+		return xxlib::hash::to_hex(xxlib::hash::sha256(content));
+	}
+} // namespace
+
+TEST(HttpBackend_StandIn, PutGetAndHead) {
+	StandInServer server;
+	auto backend = xxlib::action_cache::HttpBackend(server.url());
+
+	const auto digest = digest_of("blob");
+	EXPECT_FALSE(backend.contains(xxlib::action_cache::Kind::Blob, digest));
+	const auto missing = backend.get(xxlib::action_cache::Kind::Blob, digest);
+	ASSERT_TRUE(missing.has_value()) << missing.error();
+	EXPECT_FALSE(missing->has_value());
+
+	ASSERT_TRUE(backend.put(xxlib::action_cache::Kind::Blob, digest, "blob").has_value());
+	EXPECT_TRUE(backend.contains(xxlib::action_cache::Kind::Blob, digest));
+	EXPECT_FALSE(backend.contains(xxlib::action_cache::Kind::Action, digest));
+
+	const auto found = backend.get(xxlib::action_cache::Kind::Blob, digest);
+	ASSERT_TRUE(found.has_value()) << found.error();
+	EXPECT_EQ(found->value_or(""), "blob");
+}
+
+TEST(HttpBackend_StandIn, ReportsRefusalsAndUnreachableServers) {
+	std::string unreachable;
+	{
+		StandInServer server;
+		server.refusePuts = true;
+		auto backend = xxlib::action_cache::HttpBackend(server.url());
+		EXPECT_FALSE(backend.put(xxlib::action_cache::Kind::Action, digest_of("entry"), "entry").has_value());
+		unreachable = server.url();
+	}
+
+	auto backend = xxlib::action_cache::HttpBackend(unreachable, std::chrono::milliseconds(2000));
+	EXPECT_TRUE(backend.available());
+	EXPECT_FALSE(backend.get(xxlib::action_cache::Kind::Action, digest_of("entry")).has_value());
+	EXPECT_FALSE(backend.available());
+	EXPECT_FALSE(backend.contains(xxlib::action_cache::Kind::Action, digest_of("entry")));
+}
+
+TEST(HttpBackend_StandIn, GivesUpAfterTheServerIsUnreachable) {
+	StandInServer server;
+	auto backend = xxlib::action_cache::HttpBackend(server.url());
+	ASSERT_TRUE(backend.put(xxlib::action_cache::Kind::Blob, digest_of("blob"), "blob").has_value());
+
+	// Nothing listens on port 9 of the loopback address, so the connection is refused.
+	auto offline = xxlib::action_cache::HttpBackend("http://127.0.0.1:9/cache");
+	EXPECT_FALSE(offline.contains(xxlib::action_cache::Kind::Blob, digest_of("blob")));
+	EXPECT_FALSE(offline.available());
+
+	// Later calls fail without sending anything.
+	EXPECT_EQ(offline.get(xxlib::action_cache::Kind::Blob, digest_of("blob")).error(), "The remote cache is unavailable");
+	EXPECT_FALSE(offline.put(xxlib::action_cache::Kind::Blob, digest_of("blob"), "blob").has_value());
+
+	// A backend that can reach its server is not affected.
+	EXPECT_TRUE(backend.available());
+	EXPECT_TRUE(backend.contains(xxlib::action_cache::Kind::Blob, digest_of("blob")));
+	EXPECT_EQ(server.count("PUT"), 1u);
+}
+
+TEST(HttpBackend_StandIn, ExecutorRunsWithoutAnUnreachableServer) {
+	auto command = Command{.name = "greet", .cmd = {"echo hello"}, .cacheResults = true};
+	std::string output;
+	auto context = CommandContext{
+		.output = [&output](std::string_view chunk) {
+			output.append(chunk);
+		},
+		.actionCache = std::make_shared<xxlib::action_cache::HttpBackend>("http://127.0.0.1:9/cache"),
+	};
+
+	for (int i = 0; i < 2; ++i) {
+		const auto result = xxlib::executor::execute_command(command, context);
+		ASSERT_TRUE(result.has_value()) << result.error();
+		EXPECT_EQ(*result, 0);
+	}
+	xxlib::executor::wait_for_uploads();
+
+	EXPECT_EQ(output, "hello\nhello\n");
+	EXPECT_FALSE(context.actionCache->available());
+}
+
+TEST(HttpBackend_StandIn, SharesResultsBetweenCheckouts) {
+	StandInServer server;
+	auto backend = xxlib::action_cache::HttpBackend(server.url());
+
+	const auto root = std::filesystem::temp_directory_path() / "xx_http_backend_test";
+	std::filesystem::remove_all(root);
+	for (const auto* checkout : {"first", "second"}) {
+		std::filesystem::create_directories(root / checkout / "out");
+	}
+	for (int i = 0; i < 8; ++i) {
+		std::ofstream(root / "first" / "out" / (std::to_string(i) + ".o"), std::ios::binary) << std::string(1000 + i, 'o');
+	}
+
+	const auto key = digest_of("action");
+	const auto entry = xxlib::action_cache::Entry{.log = "compiled 8 files\n"};
+	ASSERT_TRUE(xxlib::action_cache::store(backend, root / "first", key, entry, {"out/*.o"}).has_value());
+	EXPECT_EQ(server.count("PUT"), 9u);
+
+	// Blobs the server has already are not sent again.
+	ASSERT_TRUE(xxlib::action_cache::store(backend, root / "first", key, entry, {"out/*.o"}).has_value());
+	EXPECT_EQ(server.count("PUT"), 10u);
+
+	const auto found = xxlib::action_cache::lookup(backend, key);
+	ASSERT_TRUE(found.has_value()) << found.error();
+	EXPECT_EQ(found->log, entry.log);
+	ASSERT_TRUE(xxlib::action_cache::restore(backend, root / "second", *found).has_value());
+	for (int i = 0; i < 8; ++i) {
+		EXPECT_EQ(std::filesystem::file_size(root / "second" / "out" / (std::to_string(i) + ".o")), 1000u + i);
+	}
+
+	std::filesystem::remove_all(root);
+}
+#endif
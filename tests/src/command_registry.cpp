@@ -0,0 +1,194 @@
+#include "detail/command_registry.hpp"
+#include "detail/planner.hpp"
+#include "detail/platform.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+	const auto currentOs = xxlib::platform::os_to_string(xxlib::platform::get_current_os());
+}
+
+TEST(CommandRegistry_Candidates, FindsEveryName) {
+	std::vector<Command> commands;
+	for (auto i = 0; i < 1000; ++i) {
+		commands.push_back(Command{.name = "alias" + std::to_string(i), .cmd = {"echo " + std::to_string(i)}});
+	}
+
+	const auto registry = xxlib::CommandRegistry(commands);
+	for (auto i = 0; i < 1000; ++i) {
+		const auto candidates = registry.candidates("alias" + std::to_string(i));
+		ASSERT_EQ(candidates.size(), 1u);
+		EXPECT_EQ(registry.commands()[candidates[0]].cmd[0], "echo " + std::to_string(i));
+	}
+}
+
+TEST(CommandRegistry_Candidates, KeepsLoadOrderOfDuplicates) {
+	const auto registry = xxlib::CommandRegistry({
+		{.name = "build", .cmd = {"first"}},
+		{.name = "test", .cmd = {"test"}},
+		{.name = "build", .cmd = {"second"}},
+	});
+
+	const auto candidates = registry.candidates("build");
+	ASSERT_EQ(candidates.size(), 2u);
+	EXPECT_EQ(candidates[0], 0u);
+	EXPECT_EQ(candidates[1], 2u);
+}
+
+TEST(CommandRegistry_Candidates, MissingName) {
+	const auto registry = xxlib::CommandRegistry(std::vector<Command>{{.name = "build", .cmd = {"make"}}});
+
+	EXPECT_TRUE(registry.candidates("deploy").empty());
+	EXPECT_TRUE(xxlib::CommandRegistry().candidates("deploy").empty());
+}
+
+TEST(CommandRegistry_Satisfied, CachesConstraintResults) {
+	const auto registry = xxlib::CommandRegistry({
+		{.name = "here", .constraints = {{"os", currentOs}}},
+		{.name = "elsewhere", .constraints = {{"os", "nonexistent_os"}}},
+	});
+
+	EXPECT_TRUE(registry.satisfied(0));
+	EXPECT_FALSE(registry.satisfied(1));
+}
+
+TEST(CommandRegistry_PlanSingle, PicksSatisfiedCandidate) {
+	const auto registry = xxlib::CommandRegistry({
+		{.name = "build", .cmd = {"elsewhere"}, .constraints = {{"os", "nonexistent_os"}}},
+		{.name = "build", .cmd = {"here"}, .constraints = {{"os", currentOs}}},
+	});
+
+	const auto result = xxlib::planner::plan_single(registry, "build");
+	ASSERT_TRUE(result.has_value()) << result.error();
+	EXPECT_EQ((*result)->cmd[0], "here");
+}
+
+TEST(CommandRegistry_PlanSingle, KeepsErrorSemantics) {
+	const auto registry = xxlib::CommandRegistry({
+		{.name = "build", .constraints = {{"os", currentOs}}},
+		{.name = "build", .constraints = {{"os", currentOs}}},
+		{.name = "test", .constraints = {{"os", "nonexistent_os"}}},
+	});
+
+	const auto ambiguous = xxlib::planner::plan_single(registry, "build");
+	ASSERT_FALSE(ambiguous.has_value());
+	EXPECT_EQ(ambiguous.error(), "Multiple matching commands found for name: build");
+
+	const auto unsatisfied = xxlib::planner::plan_single(registry, "test");
+	ASSERT_FALSE(unsatisfied.has_value());
+	EXPECT_EQ(unsatisfied.error(), "No matching command found for name: test");
+
+	const auto missing = xxlib::planner::plan_single(registry, "deploy");
+	ASSERT_FALSE(missing.has_value());
+	EXPECT_EQ(missing.error(), "No matching command found for name: deploy");
+}
+
+TEST(CommandRegistry_NamesWithPrefix, SortedAndDistinct) {
+	const auto registry = xxlib::CommandRegistry(std::vector<Command>{
+		{.name = "test"},
+		{.name = "build-release"},
+		{.name = "build"},
+		{.name = "build"},
+		{.name = "bump"},
+	});
+
+	EXPECT_EQ(registry.names_with_prefix("bu"), (std::vector<std::string_view>{"build", "build-release", "bump"}));
+	EXPECT_EQ(registry.names_with_prefix("build"), (std::vector<std::string_view>{"build", "build-release"}));
+	EXPECT_EQ(registry.names_with_prefix("te"), (std::vector<std::string_view>{"test"}));
+	EXPECT_TRUE(registry.names_with_prefix("deploy").empty());
+	EXPECT_TRUE(xxlib::CommandRegistry().names_with_prefix("a").empty());
+}
+
+TEST(CommandRegistry_Suggestions, ClosestFirst) {
+	const auto registry = xxlib::CommandRegistry(std::vector<Command>{
+		{.name = "build"},
+		{.name = "guild"},
+		{.name = "test"},
+		{.name = "rebuild"},
+		{.name = "lint"},
+	});
+
+	EXPECT_EQ(registry.suggestions("uild"), (std::vector<std::string_view>{"build", "guild"}));
+	EXPECT_EQ(registry.suggestions("buld", 1), (std::vector<std::string_view>{"build"}));
+	EXPECT_EQ(registry.suggestions("tset", 2, 1), (std::vector<std::string_view>{"test"}));
+	EXPECT_TRUE(registry.suggestions("deploy").empty());
+	EXPECT_TRUE(xxlib::CommandRegistry().suggestions("build").empty());
+}
+
+TEST(CommandRegistry_Suggestions, MatchesBruteForce) {
+	std::vector<Command> commands;
+	for (auto i = 0; i < 500; ++i) {
+		commands.push_back(Command{.name = "task" + std::to_string(i * 7919 % 1000)});
+	}
+	const auto registry = xxlib::CommandRegistry(commands);
+
+	const auto distance = [](std::string_view a, std::string_view b) {
+		std::vector<std::vector<size_t>> d(a.size() + 1, std::vector<size_t>(b.size() + 1));
+		for (size_t i = 0; i <= a.size(); ++i) {
+			d[i][0] = i;
+		}
+		for (size_t j = 0; j <= b.size(); ++j) {
+			d[0][j] = j;
+		}
+		for (size_t i = 1; i <= a.size(); ++i) {
+			for (size_t j = 1; j <= b.size(); ++j) {
+				d[i][j] = std::min({d[i - 1][j] + 1, d[i][j - 1] + 1, d[i - 1][j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1)});
+			}
+		}
+		return d[a.size()][b.size()];
+	};
+
+	for (const auto* query : {"task12", "tsak500", "taks99x", "job1"}) {
+		size_t expected = 0;
+		for (const auto& name : registry.names_with_prefix("")) {
+			expected += distance(query, name) <= 2 ? 1 : 0;
+		}
+		EXPECT_EQ(registry.suggestions(query, 2, SIZE_MAX).size(), expected) << query;
+	}
+}
+
+TEST(CommandRegistry_PlanSingle, ResolvesUniquePrefix) {
+	const auto registry = xxlib::CommandRegistry(std::vector<Command>{
+		{.name = "build", .cmd = {"make"}},
+		{.name = "bump", .cmd = {"bump"}},
+		{.name = "test", .cmd = {"ctest"}},
+	});
+
+	const auto resolved = xxlib::planner::plan_single(registry, "bui");
+	ASSERT_TRUE(resolved.has_value()) << resolved.error();
+	EXPECT_EQ((*resolved)->name, "build");
+
+	const auto ambiguous = xxlib::planner::plan_single(registry, "bu");
+	ASSERT_FALSE(ambiguous.has_value());
+	EXPECT_EQ(ambiguous.error(), "Ambiguous command name 'bu', it could be: build, bump");
+
+	const auto typo = xxlib::planner::plan_single(registry, "tets");
+	ASSERT_FALSE(typo.has_value());
+	EXPECT_EQ(typo.error(), "No matching command found for name: tets, did you mean: test?");
+}
+
+TEST(CommandRegistry_Suggestions, DISABLED_MissIsFast) {
+	std::vector<Command> commands;
+	for (auto i = 0; i < 5000; ++i) {
+		commands.push_back(Command{.name = "project-" + std::to_string(i / 100) + "-task-" + std::to_string(i % 100)});
+	}
+	const auto registry = xxlib::CommandRegistry(std::move(commands));
+
+	constexpr auto QUERIES = 100;
+	const auto start = std::chrono::steady_clock::now();
+	size_t found = 0;
+	for (auto i = 0; i < QUERIES; ++i) {
+		found += registry.names_with_prefix("deploy-" + std::to_string(i)).size();
+		found += registry.suggestions("deploy-" + std::to_string(i)).size();
+	}
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+	EXPECT_EQ(found, 0u);
+	RecordProperty("miss_us", static_cast<int>(elapsed.count() / QUERIES));
+	// A prefix listing and a suggestion pass over 5000 names, in well under a millisecond.
+	EXPECT_LT(elapsed.count() / QUERIES, 1000);
+}
@@ -0,0 +1,167 @@
+#include "detail/completion.hpp"
+#include "detail/executors/platform_executor.hpp"
+#include "detail/loader.hpp"
+#include "temp_dir_fixture.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+namespace {
+	struct CompletionFixture : public TempDirFixture {
+		std::string cacheDirectory;
+
+		void SetUp() override {
+			TempDirFixture::SetUp();
+			cacheDirectory = (root / "cache").string();
+		}
+
+		void load(const std::string& path) const {
+			const auto loaded = xxlib::loader::load_sources({{.path = path, .strict = true}}, {.useCache = true, .cacheDirectory = cacheDirectory});
+			ASSERT_TRUE(loaded.has_value()) << loaded.error();
+		}
+	};
+
+	std::vector<std::string> names_of(const std::vector<xxlib::completion::Entry>& entries) {
+		std::vector<std::string> names;
+		for (const auto& entry : entries) {
+			names.push_back(entry.name);
+		}
+		return names;
+	}
+} // namespace
+
+TEST_F(CompletionFixture, IndexIsWrittenWithTheCache) {
+	write_file("shared.yaml", "alias:\n  lint:\n    cmd: make lint\n");
+	const auto project = write_file("project.yaml", "include: shared.yaml\nalias:\n  build:\n    cmd: make\n    template_vars:\n      target: all\n");
+
+	EXPECT_FALSE(xxlib::completion::read_indexed({project}, cacheDirectory).has_value());
+
+	load(project);
+
+	const auto entries = xxlib::completion::read_indexed({project}, cacheDirectory);
+	ASSERT_TRUE(entries.has_value()) << entries.error();
+	EXPECT_EQ(names_of(*entries), (std::vector<std::string>{"build", "lint"}));
+	EXPECT_EQ(entries->at(0).templateVars, (std::vector<std::string>{"target"}));
+}
+
+TEST_F(CompletionFixture, StaleIndexIsRejected) {
+	const auto project = write_file("project.yaml", "alias:\n  build:\n    cmd: make\n");
+	load(project);
+	ASSERT_TRUE(xxlib::completion::read_indexed({project}, cacheDirectory).has_value());
+
+	write_file("project.yaml", "alias:\n  build:\n    cmd: make\n  test:\n    cmd: make test\n");
+
+	const auto entries = xxlib::completion::read_indexed({project}, cacheDirectory);
+	ASSERT_FALSE(entries.has_value());
+	EXPECT_NE(entries.error().find("stale"), std::string::npos) << entries.error();
+}
+
+TEST_F(CompletionFixture, MissingFilesAreSkipped) {
+	const auto project = write_file("project.yaml", "alias:\n  build:\n    cmd: make\n");
+	load(project);
+
+	const auto entries = xxlib::completion::read_indexed({project, (root / "missing.yaml").string()}, cacheDirectory);
+	ASSERT_TRUE(entries.has_value()) << entries.error();
+	EXPECT_EQ(names_of(*entries), (std::vector<std::string>{"build"}));
+}
+
+TEST(Completion_Complete, AliasNames) {
+	const std::vector<xxlib::completion::Entry> entries{
+		{.name = "build"},
+		{.name = "bump"},
+		{.name = "build"},
+		{.name = "test"},
+		{.name = "bundle", .constraintMask = xxlib::constraint::UNSATISFIABLE},
+	};
+
+	EXPECT_EQ(xxlib::completion::complete(entries, {}), (std::vector<std::string>{"build", "bump", "test"}));
+	EXPECT_EQ(xxlib::completion::complete(entries, {""}), (std::vector<std::string>{"build", "bump", "test"}));
+	EXPECT_EQ(xxlib::completion::complete(entries, {"bu"}), (std::vector<std::string>{"build", "bump"}));
+	EXPECT_EQ(xxlib::completion::complete(entries, {"-n", "--yolo", "t"}), (std::vector<std::string>{"test"}));
+	EXPECT_TRUE(xxlib::completion::complete(entries, {"x"}).empty());
+}
+
+TEST(Completion_Complete, TemplateVars) {
+	const std::vector<xxlib::completion::Entry> entries{
+		{.name = "deploy", .templateVars = {"env", "region"}},
+		{.name = "deploy", .templateVars = {"env", "version"}},
+		{.name = "build", .templateVars = {"target"}},
+	};
+
+	EXPECT_EQ(xxlib::completion::complete(entries, {"deploy", ""}), (std::vector<std::string>{"env=", "region=", "version="}));
+	EXPECT_EQ(xxlib::completion::complete(entries, {"deploy", "env=prod", "-n", "re"}), (std::vector<std::string>{"region="}));
+	EXPECT_EQ(xxlib::completion::complete(entries, {"deploy", "env=prod", ""}), (std::vector<std::string>{"region=", "version="}));
+	EXPECT_TRUE(xxlib::completion::complete(entries, {"missing", ""}).empty());
+}
+
+TEST(Completion_Complete, SeveralAliases) {
+	const std::vector<xxlib::completion::Entry> entries{
+		{.name = "deploy", .templateVars = {"env", "region"}},
+		{.name = "build", .templateVars = {"target"}},
+	};
+
+	EXPECT_EQ(xxlib::completion::complete(entries, {"deploy", "b"}), (std::vector<std::string>{"build"}));
+	EXPECT_EQ(xxlib::completion::complete(entries, {"deploy", "build", ""}), (std::vector<std::string>{"target="}));
+	EXPECT_EQ(xxlib::completion::complete(entries, {"deploy[env=prod]", "target=x", "build", "target=y", "d"}), (std::vector<std::string>{"deploy"}));
+	EXPECT_EQ(xxlib::completion::complete(entries, {"build", "deploy", "env=prod", ""}), (std::vector<std::string>{"region="}));
+}
+
+TEST(Completion_Script, EveryShell) {
+	for (const auto* shell : {"bash", "zsh", "fish"}) {
+		const auto text = xxlib::completion::script(xxlib::completion::string_to_shell(shell));
+		EXPECT_NE(text.find("__complete"), std::string_view::npos) << shell;
+		EXPECT_NE(text.find(shell), std::string_view::npos) << shell;
+		EXPECT_EQ(text.find("@SUBCOMMANDS@"), std::string_view::npos) << shell;
+		EXPECT_NE(text.find(" pick "), std::string_view::npos) << shell;
+	}
+}
+
+#ifndef _WIN32
+TEST_F(CompletionFixture, DISABLED_Benchmark) {
+	// Set by the benchmark test registered in tests/CMakeLists.txt.
+	const auto* binary = std::getenv("XX_BINARY");
+	if (!binary) {
+		GTEST_SKIP() << "XX_BINARY does not name the xx binary";
+	}
+
+	std::string yaml = "alias:\n";
+	for (auto i = 0; i < 2000; ++i) {
+		yaml += "  alias" + std::to_string(i) + ":\n";
+		yaml += "    cmd: \"make target" + std::to_string(i) + "\"\n";
+		yaml += "    template_vars:\n      mode: debug\n";
+	}
+	const auto project = write_file("project.yaml", yaml);
+
+	const auto invocation = xxlib::platform_executor::DirectCommand{
+		.assignments = {{"XDG_CACHE_HOME", cacheDirectory}},
+		.argv = {binary, "--project", "-c", project, "__complete", "alias19"},
+	};
+	const auto complete = [&invocation, binary]() {
+		std::string output;
+		const auto exitCode = xxlib::platform_executor::spawn(binary, invocation, [&output](std::string_view chunk) {
+			output.append(chunk);
+		});
+		EXPECT_EQ(exitCode.value_or(-1), 0);
+		return output;
+	};
+
+	// The first run parses the configuration and leaves the cache and its completion index behind.
+	complete();
+
+	constexpr auto RUNS = 20;
+	std::string output;
+	const auto start = std::chrono::steady_clock::now();
+	for (auto i = 0; i < RUNS; ++i) {
+		output = complete();
+	}
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / RUNS;
+
+	EXPECT_EQ(std::count(output.begin(), output.end(), '\n'), 111);
+	RecordProperty("complete_us", static_cast<int>(elapsed));
+	// Startup to exit of a release build, several times what it needs; a delay past this is felt on every Tab.
+	EXPECT_LT(elapsed, 50000);
+}
+#endif
@@ -0,0 +1,86 @@
+#include "detail/constraint.hpp"
+#include "detail/platform.hpp"
+#include <bit>
+#include <gtest/gtest.h>
+
+namespace {
+	const std::string currentOs = xxlib::platform::os_to_string(xxlib::platform::get_current_os());
+	const std::string currentArch = xxlib::platform::architecture_to_string(xxlib::platform::get_current_architecture());
+	const std::string currentOsFamily = xxlib::platform::os_family_to_string(xxlib::platform::get_current_os_family());
+	const std::string otherOs = currentOs == "linux" ? "windows" : "linux";
+} // namespace
+
+TEST(Constraint_Compile, EmptyAllowsEverything) {
+	EXPECT_EQ(xxlib::constraint::compile({}), xxlib::constraint::ALL);
+	EXPECT_TRUE(xxlib::constraint::matches(xxlib::constraint::compile({})));
+}
+
+TEST(Constraint_Compile, SingleValues) {
+	using namespace xxlib::constraint;
+
+	EXPECT_EQ(compile({{"os", "linux"}}), OS_LINUX | ARCH_ALL | FAMILY_ALL);
+	EXPECT_EQ(compile({{"os", "linux"}, {"arch", "arm64"}}), OS_LINUX | ARCH_ARM64 | FAMILY_ALL);
+	EXPECT_EQ(compile({{"osfamily", "unix"}}), OS_ALL | ARCH_ALL | FAMILY_UNIX);
+}
+
+TEST(Constraint_Compile, AnyOf) {
+	using namespace xxlib::constraint;
+
+	EXPECT_EQ(compile({{"os", "linux,macos"}}), OS_LINUX | OS_MACOS | ARCH_ALL | FAMILY_ALL);
+	EXPECT_EQ(compile({{"os", "linux, macos"}}), OS_LINUX | OS_MACOS | ARCH_ALL | FAMILY_ALL);
+}
+
+TEST(Constraint_Compile, Negation) {
+	using namespace xxlib::constraint;
+
+	EXPECT_EQ(compile({{"not_os", "windows"}}), OS_LINUX | OS_MACOS | ARCH_ALL | FAMILY_ALL);
+	EXPECT_EQ(compile({{"not_arch", "x86_64,arm64"}}), OS_ALL | FAMILY_ALL);
+}
+
+TEST(Constraint_Compile, SameDimensionTermsIntersect) {
+	using namespace xxlib::constraint;
+
+	EXPECT_EQ(compile({{"os", "linux,macos"}, {"not_os", "macos"}}), OS_LINUX | ARCH_ALL | FAMILY_ALL);
+	EXPECT_EQ(compile({{"os", "linux"}, {"os", "macos"}}), ARCH_ALL | FAMILY_ALL);
+}
+
+TEST(Constraint_Compile, UnknownKeyNeverMatches) {
+	std::vector<std::string> warnings;
+	const auto mask = xxlib::constraint::compile({{"os", currentOs}, {"shell", "bash"}}, warnings);
+
+	EXPECT_EQ(mask, xxlib::constraint::UNSATISFIABLE);
+	EXPECT_FALSE(xxlib::constraint::matches(mask));
+	ASSERT_EQ(warnings.size(), 1u);
+	EXPECT_NE(warnings[0].find("'shell'"), std::string::npos);
+}
+
+TEST(Constraint_Compile, UnknownValueIsReported) {
+	std::vector<std::string> warnings;
+	const auto mask = xxlib::constraint::compile({{"os", "linux,plan9"}}, warnings);
+
+	EXPECT_EQ(mask, xxlib::constraint::OS_LINUX | xxlib::constraint::ARCH_ALL | xxlib::constraint::FAMILY_ALL);
+	ASSERT_EQ(warnings.size(), 1u);
+	EXPECT_NE(warnings[0].find("'plan9'"), std::string::npos);
+}
+
+TEST(Constraint_Matches, Host) {
+	using xxlib::constraint::compile;
+	using xxlib::constraint::matches;
+
+	EXPECT_TRUE(matches(compile({{"os", currentOs}, {"arch", currentArch}, {"osfamily", currentOsFamily}})));
+	EXPECT_TRUE(matches(compile({{"os", otherOs + "," + currentOs}})));
+	EXPECT_TRUE(matches(compile({{"not_os", otherOs}})));
+
+	EXPECT_FALSE(matches(compile({{"os", otherOs}})));
+	EXPECT_FALSE(matches(compile({{"not_os", currentOs}})));
+	EXPECT_FALSE(matches(compile({{"os", currentOs}, {"not_arch", currentArch}})));
+}
+
+TEST(Constraint_HostMask, OneBitPerDimension) {
+	const auto host = xxlib::constraint::host_mask();
+
+	EXPECT_EQ(std::popcount(host & xxlib::constraint::OS_ALL), 1);
+	EXPECT_EQ(std::popcount(host & xxlib::constraint::ARCH_ALL), 1);
+	EXPECT_EQ(std::popcount(host & xxlib::constraint::FAMILY_ALL), 1);
+	EXPECT_EQ(host & xxlib::constraint::UNSATISFIABLE, 0u);
+}
@@ -0,0 +1,84 @@
+#include "detail/discovery.hpp"
+#include "temp_dir_fixture.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+namespace {
+	struct DiscoveryFixture : public TempDirFixture {
+		std::filesystem::path nested;
+
+		void SetUp() override {
+			TempDirFixture::SetUp();
+			nested = root / "a" / "b" / "c";
+			std::filesystem::create_directories(nested);
+		}
+
+		std::string write_config(const std::filesystem::path& directory) const {
+			return write_file(directory.lexically_relative(root) / ".xx.yaml", "alias:\n  build:\n    cmd: make\n");
+		}
+
+		std::string cache_directory() const {
+			return (root / "cache").string();
+		}
+	};
+} // namespace
+
+TEST_F(DiscoveryFixture, FindsClosestConfig) {
+	write_config(root / "a");
+	const auto closest = write_config(root / "a" / "b");
+
+	const auto lookup = xxlib::discovery::find_configs(nested.string(), ".xx.yaml", true);
+
+	ASSERT_EQ(lookup.configs.size(), 1u);
+	EXPECT_EQ(lookup.configs[0], closest);
+	EXPECT_EQ(lookup.directories.size(), 2u);
+}
+
+TEST_F(DiscoveryFixture, FindsAllConfigsClosestFirst) {
+	const auto outer = write_config(root / "a");
+	const auto inner = write_config(root / "a" / "b");
+
+	const auto lookup = xxlib::discovery::find_configs(nested.string(), ".xx.yaml", false);
+
+	ASSERT_GE(lookup.configs.size(), 2u);
+	EXPECT_EQ(lookup.configs[0], inner);
+	EXPECT_EQ(lookup.configs[1], outer);
+}
+
+TEST_F(DiscoveryFixture, NoConfigFound) {
+	const auto lookup = xxlib::discovery::find_configs(nested.string(), ".xx-discovery-test-missing.yaml", true);
+
+	EXPECT_TRUE(lookup.configs.empty());
+	EXPECT_FALSE(lookup.directories.empty());
+}
+
+TEST_F(DiscoveryFixture, CachedLookupMatchesWalk) {
+	const auto config = write_config(root / "a");
+
+	const auto first = xxlib::discovery::find_configs_cached(nested.string(), ".xx.yaml", true, cache_directory());
+	const auto second = xxlib::discovery::find_configs_cached(nested.string(), ".xx.yaml", true, cache_directory());
+
+	ASSERT_EQ(first.size(), 1u);
+	EXPECT_EQ(first[0], config);
+	EXPECT_EQ(second, first);
+	EXPECT_TRUE(std::filesystem::exists(root / "cache" / "discovery.xxd"));
+}
+
+TEST_F(DiscoveryFixture, CachedLookupInvalidatedByNewConfig) {
+	const auto outer = write_config(root / "a");
+
+	const auto first = xxlib::discovery::find_configs_cached(nested.string(), ".xx.yaml", true, cache_directory());
+	ASSERT_EQ(first.size(), 1u);
+	EXPECT_EQ(first[0], outer);
+
+	const auto inner = write_config(root / "a" / "b");
+	// Coarse filesystem timestamps may not register the change on their own.
+	const auto directory = root / "a" / "b";
+	std::filesystem::last_write_time(directory, std::filesystem::last_write_time(directory) + std::chrono::seconds(5));
+
+	const auto second = xxlib::discovery::find_configs_cached(nested.string(), ".xx.yaml", true, cache_directory());
+	ASSERT_EQ(second.size(), 1u);
+	EXPECT_EQ(second[0], inner);
+}
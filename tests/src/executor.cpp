@@ -1,6 +1,10 @@
 #include "detail/command.hpp"
 #include "detail/executor.hpp"
+#include "detail/executors/platform_executor.hpp"
 #include <gtest/gtest.h>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
 
 TEST(Executor_StringToExecutionEngine, System) {
 	EXPECT_EQ(xxlib::executor::string_to_execution_engine("system"), xxlib::executor::Engine::System);
@@ -50,6 +54,28 @@ TEST(Executor_ExecuteCommand, LuaEngine) {
 	EXPECT_EQ(result.value(), 0);
 }
 
+#ifndef _WIN32
+TEST(Executor_ExecuteCommand, LuaShellCommandOutputIsCaptured) {
+	auto command = Command{
+		.name = "test",
+		.cmd = {"return 'echo from-shell'"},
+		.executionEngine = xxlib::executor::Engine::Lua,
+	};
+
+	std::string output;
+	auto context = CommandContext{
+		.output = [&output](std::string_view chunk) {
+			output.append(chunk);
+		},
+	};
+
+	auto result = xxlib::executor::execute_command(command, context);
+	ASSERT_TRUE(result.has_value()) << result.error();
+	EXPECT_EQ(result.value(), 0);
+	EXPECT_EQ(output, "from-shell\n");
+}
+#endif
+
 TEST(Executor_ExecuteCommand, DotnetRunEngine) {
     auto command = Command{
         .name = "test",
@@ -81,3 +107,102 @@ TEST(Executor_ExecuteCommand, UnknownEngine) {
 	EXPECT_FALSE(result.has_value());
 	EXPECT_EQ(result.error(), "Unknown execution engine");
 }
+
+#ifndef _WIN32
+TEST(Executor_ExecuteCommand, SystemEngineCapturesOutput) {
+	auto command = Command{
+		.name = "test",
+		.cmd = {"echo", "hello;", "echo", "oops", "1>&2;", "exit", "3"},
+		.executionEngine = xxlib::executor::Engine::System,
+	};
+
+	std::string output;
+	auto context = CommandContext{
+		.output = [&output](std::string_view chunk) {
+			output += chunk;
+		},
+	};
+
+	auto result = xxlib::executor::execute_command(command, context);
+	ASSERT_TRUE(result.has_value()) << result.error();
+	EXPECT_EQ(result.value(), 3);
+	EXPECT_EQ(output, "hello\noops\n");
+}
+#endif
+
+#ifndef _WIN32
+TEST(PlatformExecutor_ParsePlain, PlainWords) {
+	const auto direct = xxlib::platform_executor::parse_plain("CC=clang  MODE=  cmake --build build/ -j8 --target=all ");
+	ASSERT_TRUE(direct.has_value());
+	EXPECT_EQ(direct->assignments, (std::vector<std::pair<std::string, std::string>>{{"CC", "clang"}, {"MODE", ""}}));
+	EXPECT_EQ(direct->argv, (std::vector<std::string>{"cmake", "--build", "build/", "-j8", "--target=all"}));
+}
+
+TEST(PlatformExecutor_ParsePlain, ShellSyntaxNeedsTheShell) {
+	for (const auto* line : {"echo $HOME", "echo \"a b\"", "ls *.cpp", "a && b", "a | b", "a > out", "echo ~", "echo a\nb", "1X=2 env", "A=1", "", "echo {a,b}"}) {
+		EXPECT_FALSE(xxlib::platform_executor::parse_plain(line).has_value()) << line;
+	}
+}
+
+TEST(PlatformExecutor_FindProgram, FindsProgramsButNotBuiltins) {
+	const auto find = [](std::vector<std::string> argv, std::vector<std::pair<std::string, std::string>> assignments = {}) {
+		return xxlib::platform_executor::find_program({.assignments = std::move(assignments), .argv = std::move(argv)});
+	};
+
+	const auto sh = find({"sh"});
+	ASSERT_TRUE(sh.has_value());
+	EXPECT_TRUE(sh->ends_with("/sh"));
+	EXPECT_EQ(find({"/bin/sh"}), "/bin/sh");
+	EXPECT_FALSE(find({"cd"}).has_value());
+	EXPECT_FALSE(find({"exit"}).has_value());
+	EXPECT_FALSE(find({"xx-no-such-program"}).has_value());
+	EXPECT_FALSE(find({"sh"}, {{"PATH", "/nowhere"}}).has_value());
+}
+
+TEST(PlatformExecutor_Spawn, CapturesOutputAndExitCode) {
+	std::string output;
+	const auto result = xxlib::platform_executor::spawn("/bin/sh", {.assignments = {{"XX_SPAWN_TEST", "value"}}, .argv = {"sh", "-c", "echo \"$XX_SPAWN_TEST\"; echo err >&2; exit 4"}}, [&output](std::string_view chunk) {
+		output += chunk;
+	});
+
+	ASSERT_TRUE(result.has_value()) << result.error();
+	EXPECT_EQ(*result, 4);
+	EXPECT_EQ(output, "value\nerr\n");
+}
+
+TEST(PlatformExecutor_Spawn, ReportsSignals) {
+	const auto result = xxlib::platform_executor::spawn("/bin/sh", {.argv = {"sh", "-c", "kill -TERM $$"}});
+	ASSERT_TRUE(result.has_value()) << result.error();
+	EXPECT_EQ(*result, 128 + SIGTERM);
+}
+
+TEST(PlatformExecutor_Spawn, InterruptsReachOnlyTheChild) {
+	// Ctrl-C goes to the whole process group; xx has to outlive it and report how the child ended.
+	const auto result = xxlib::platform_executor::spawn("/bin/sh", {.argv = {"sh", "-c", "kill -INT $PPID; kill -INT $$; exit 3"}});
+	ASSERT_TRUE(result.has_value()) << result.error();
+	EXPECT_EQ(*result, 128 + SIGINT);
+}
+
+TEST(PlatformExecutor_Spawn, DISABLED_Benchmark) {
+	constexpr auto RUNS = 50;
+	// 'true' is a builtin of some shells, so a real program keeps the comparison fair.
+	const auto direct = xxlib::platform_executor::parse_plain("uname").value();
+	const auto program = xxlib::platform_executor::find_program(direct).value();
+
+	auto start = std::chrono::steady_clock::now();
+	for (auto i = 0; i < RUNS; ++i) {
+		ASSERT_EQ(xxlib::platform_executor::spawn(program, direct, [](std::string_view) {}).value_or(-1), 0);
+	}
+	const auto spawnMicros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / RUNS;
+
+	start = std::chrono::steady_clock::now();
+	for (auto i = 0; i < RUNS; ++i) {
+		ASSERT_EQ(std::system("uname >/dev/null"), 0);
+	}
+	const auto shellMicros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / RUNS;
+
+	RecordProperty("spawn_us", static_cast<int>(spawnMicros));
+	RecordProperty("shell_us", static_cast<int>(shellMicros));
+	EXPECT_LT(spawnMicros, shellMicros);
+}
+#endif
@@ -0,0 +1,103 @@
+#include "detail/fuzzy.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+	std::vector<std::string> sample_names() {
+		return {"build", "build-release", "rebuild", "Deploy", "db-migrate", "docker-build", "lint"};
+	}
+
+	std::vector<std::string_view> views(const std::vector<std::string>& names) {
+		return {names.begin(), names.end()};
+	}
+
+	std::vector<std::string_view> matched_names(const xxlib::FuzzyIndex& index, const std::vector<xxlib::FuzzyIndex::Match>& matches) {
+		std::vector<std::string_view> result;
+		for (const auto& match : matches) {
+			result.push_back(index.name(match.index));
+		}
+		return result;
+	}
+} // namespace
+
+TEST(FuzzyIndex_Score, Subsequence) {
+	EXPECT_GE(xxlib::FuzzyIndex::score("build", "bld"), 0);
+	EXPECT_GE(xxlib::FuzzyIndex::score("build", ""), 0);
+	EXPECT_LT(xxlib::FuzzyIndex::score("build", "dlb"), 0);
+	EXPECT_LT(xxlib::FuzzyIndex::score("build", "builds"), 0);
+}
+
+TEST(FuzzyIndex_Score, PrefersConsecutiveAndBoundaryMatches) {
+	EXPECT_GT(xxlib::FuzzyIndex::score("build", "bui"), xxlib::FuzzyIndex::score("bxuxi", "bui"));
+	EXPECT_GT(xxlib::FuzzyIndex::score("db-migrate", "dm"), xxlib::FuzzyIndex::score("deploy-them", "dm"));
+	EXPECT_GT(xxlib::FuzzyIndex::score("build", "b"), xxlib::FuzzyIndex::score("rebuild", "b"));
+}
+
+TEST(FuzzyIndex_Filter, RanksMatches) {
+	const auto names = sample_names();
+	const auto index = xxlib::FuzzyIndex(views(names));
+
+	EXPECT_EQ(matched_names(index, index.filter("build")), (std::vector<std::string_view>{"build", "docker-build", "build-release", "rebuild"}));
+	EXPECT_EQ(matched_names(index, index.filter("DEP")), (std::vector<std::string_view>{"Deploy"}));
+	EXPECT_EQ(matched_names(index, index.filter("d b")), matched_names(index, index.filter("db")));
+	EXPECT_TRUE(index.filter("zz").empty());
+}
+
+TEST(FuzzyIndex_Filter, EmptyQueryKeepsOrder) {
+	const auto names = sample_names();
+	const auto index = xxlib::FuzzyIndex(views(names));
+
+	EXPECT_EQ(matched_names(index, index.filter("")), views(names));
+}
+
+TEST(FuzzyIndex_Filter, IncrementalMatchesFull) {
+	std::vector<std::string> names;
+	for (auto i = 0; i < 2000; ++i) {
+		names.push_back("svc-" + std::to_string(i % 37) + "-deploy-" + std::to_string(i) + (i % 3 == 0 ? "-canary" : ""));
+	}
+	const auto index = xxlib::FuzzyIndex(views(names));
+
+	const std::string query = "s1dpl9can";
+	auto previous = index.filter("");
+	for (size_t length = 1; length <= query.size(); ++length) {
+		const auto prefix = std::string_view(query).substr(0, length);
+		auto incremental = index.filter(prefix, previous);
+		const auto full = index.filter(prefix);
+
+		ASSERT_EQ(incremental.size(), full.size()) << prefix;
+		for (size_t i = 0; i < full.size(); ++i) {
+			EXPECT_EQ(incremental[i].index, full[i].index) << prefix;
+			EXPECT_EQ(incremental[i].score, full[i].score) << prefix;
+		}
+		previous = std::move(incremental);
+	}
+}
+
+TEST(FuzzyIndex_Filter, DISABLED_Benchmark) {
+	std::vector<std::string> names;
+	for (auto i = 0; i < 10000; ++i) {
+		names.push_back("project-" + std::to_string(i / 100) + "-task-" + std::to_string(i % 100));
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	const auto index = xxlib::FuzzyIndex(views(names));
+	const auto buildMicros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+	// Typing "pj42t7" one key at a time, as the picker does.
+	start = std::chrono::steady_clock::now();
+	auto matches = index.filter("");
+	for (const auto* prefix : {"p", "pj", "pj4", "pj42", "pj42t", "pj42t7"}) {
+		matches = index.filter(prefix, matches);
+	}
+	const auto typingMicros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+	ASSERT_FALSE(matches.empty());
+	EXPECT_EQ(index.name(matches.front().index), "project-42-task-7");
+	RecordProperty("build_us", static_cast<int>(buildMicros));
+	RecordProperty("typing_us", static_cast<int>(typingMicros));
+	// Every keystroke is filtered within a frame at 60 Hz.
+	EXPECT_LT(typingMicros, 6 * 16000);
+}
@@ -0,0 +1,57 @@
+#include "detail/glob.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+TEST(Glob_HasMagic, DetectsWildcards) {
+	EXPECT_TRUE(xxlib::glob::has_magic("*.yaml"));
+	EXPECT_TRUE(xxlib::glob::has_magic("team?.yaml"));
+	EXPECT_TRUE(xxlib::glob::has_magic("team[0-9].yaml"));
+	EXPECT_FALSE(xxlib::glob::has_magic("teams/build.yaml"));
+}
+
+TEST(Glob_Match, Wildcards) {
+	EXPECT_TRUE(xxlib::glob::match("*.yaml", "build.yaml"));
+	EXPECT_FALSE(xxlib::glob::match("*.yaml", "build.yml"));
+	EXPECT_TRUE(xxlib::glob::match("b*d.yaml", "build.yaml"));
+	EXPECT_TRUE(xxlib::glob::match("build.?aml", "build.yaml"));
+	EXPECT_TRUE(xxlib::glob::match("*", "anything"));
+	EXPECT_TRUE(xxlib::glob::match("a*b*c", "aXXbYYc"));
+	EXPECT_FALSE(xxlib::glob::match("a*b*c", "aXXbYY"));
+}
+
+TEST(Glob_Match, CharacterClasses) {
+	EXPECT_TRUE(xxlib::glob::match("team[0-9].yaml", "team3.yaml"));
+	EXPECT_FALSE(xxlib::glob::match("team[0-9].yaml", "teamx.yaml"));
+	EXPECT_TRUE(xxlib::glob::match("team[!0-9].yaml", "teamx.yaml"));
+	EXPECT_TRUE(xxlib::glob::match("[ab].yaml", "b.yaml"));
+}
+
+TEST(Glob_Match, HiddenFiles) {
+	EXPECT_FALSE(xxlib::glob::match("*.yaml", ".hidden.yaml"));
+	EXPECT_TRUE(xxlib::glob::match(".*.yaml", ".hidden.yaml"));
+}
+
+TEST(Glob_Expand, RecursiveAndSorted) {
+	const auto root = std::filesystem::temp_directory_path() / "xx_glob_expand_test";
+	std::filesystem::remove_all(root);
+	std::filesystem::create_directories(root / "teams" / "nested");
+	std::filesystem::create_directories(root / ".git");
+
+	for (const auto& file : {"teams/b.yaml", "teams/a.yaml", "teams/notes.txt", "teams/nested/c.yaml", ".git/d.yaml", "root.yaml"}) {
+		std::ofstream(root / file) << "alias: {}\n";
+	}
+
+	const auto direct = xxlib::glob::expand(root, "teams/*.yaml");
+	ASSERT_EQ(direct.size(), 2u);
+	EXPECT_EQ(std::filesystem::path(direct[0]).filename(), "a.yaml");
+	EXPECT_EQ(std::filesystem::path(direct[1]).filename(), "b.yaml");
+
+	const auto recursive = xxlib::glob::expand(root, "**/*.yaml");
+	EXPECT_EQ(recursive.size(), 4u);
+
+	const auto none = xxlib::glob::expand(root, "missing/*.yaml");
+	EXPECT_TRUE(none.empty());
+
+	std::filesystem::remove_all(root);
+}
@@ -0,0 +1,31 @@
+#include "detail/hash.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+TEST(Hash_Sha256, KnownDigests) {
+	EXPECT_EQ(xxlib::hash::to_hex(xxlib::hash::sha256("")), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+	EXPECT_EQ(xxlib::hash::to_hex(xxlib::hash::sha256("abc")), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+	EXPECT_EQ(xxlib::hash::to_hex(xxlib::hash::sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")), "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+	EXPECT_EQ(xxlib::hash::to_hex(xxlib::hash::sha256(std::string(1000000, 'a'))), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+TEST(Hash_Sha256, UpdatesInPiecesMatchOneUpdate) {
+	std::string data;
+	for (int i = 0; i < 1000; ++i) {
+		data += static_cast<char>(i * 7);
+	}
+
+	// Piece sizes straddle the 64 byte block boundary in different ways.
+	for (const size_t piece : {1u, 3u, 63u, 64u, 65u, 200u}) {
+		xxlib::hash::Sha256 hasher;
+		for (size_t offset = 0; offset < data.size(); offset += piece) {
+			hasher.update(std::string_view(data).substr(offset, piece));
+		}
+		EXPECT_EQ(hasher.finish(), xxlib::hash::sha256(data)) << "piece size " << piece;
+	}
+}
+
+TEST(Hash_Fnv1a64, KnownValues) {
+	EXPECT_EQ(xxlib::hash::fnv1a64(""), xxlib::hash::FNV1A64_OFFSET);
+	EXPECT_EQ(xxlib::hash::to_hex(xxlib::hash::fnv1a64("a")), "af63dc4c8601ec8c");
+}
@@ -19,7 +19,7 @@ TEST(Helpers_SplitExtras, SplitExtras) {
 }
 
 TEST(Helpers_GetUnsetVars, GetUnsetVars) {
-	auto templateVars = std::unordered_map<std::string, std::string>{
+	auto templateVars = xxlib::StringMap{
 		{"var1", "value1"},
 		{"var2", ""},
 		{"var3", "value3"},
@@ -32,3 +32,9 @@ TEST(Helpers_GetUnsetVars, GetUnsetVars) {
 	EXPECT_NE(std::find(unsetVars.begin(), unsetVars.end(), "var2"), unsetVars.end());
 	EXPECT_NE(std::find(unsetVars.begin(), unsetVars.end(), "var4"), unsetVars.end());
 }
+
+TEST(Helpers_SplitArguments, SplitsOnWhitespaceAndKeepsQuotes) {
+	EXPECT_EQ(xxlib::helpers::split_arguments("  name=x  \"two words\" msg=\"a b\"  "), (std::vector<std::string>{"name=x", "two words", "msg=a b"}));
+	EXPECT_EQ(xxlib::helpers::split_arguments("empty=\"\" \"\""), (std::vector<std::string>{"empty=", ""}));
+	EXPECT_TRUE(xxlib::helpers::split_arguments("   ").empty());
+}
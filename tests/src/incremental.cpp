@@ -0,0 +1,135 @@
+#include "detail/incremental.hpp"
+#include "temp_dir_fixture.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+	struct IncrementalFixture : public TempDirFixture {
+		xxlib::incremental::Options options;
+		xxlib::incremental::StatCache stats;
+		Command command{
+			.name = "codegen",
+			.cmd = {"./generate.sh"},
+			.inputs = {"schema/*.json"},
+			.outputs = {"out/*.hpp"},
+		};
+
+		void SetUp() override {
+			TempDirFixture::SetUp();
+			options = xxlib::incremental::Options{.stateDirectory = (root / "state").string(), .base = root};
+
+			write("schema/a.json", "{}");
+			write("schema/b.json", "[]");
+			write("out/types.hpp", "#pragma once");
+		}
+
+		void write(const std::string& relative, const std::string& content) const {
+			write_file(relative, content);
+		}
+
+		void shift_mtime(const std::string& relative, std::chrono::seconds by) const {
+			const auto path = root / relative;
+			std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + by);
+		}
+
+		xxlib::incremental::Check check(const std::vector<std::string>& extras = {}) {
+			stats.clear();
+			return xxlib::incremental::check(command, extras, options, stats);
+		}
+
+		void record() {
+			const auto result = check();
+			ASSERT_TRUE(xxlib::incremental::store_state(result.statePath, result.state).has_value());
+		}
+	};
+} // namespace
+
+TEST_F(IncrementalFixture, UpToDateOnceRecorded) {
+	EXPECT_FALSE(check().upToDate);
+
+	record();
+	const auto result = check();
+	EXPECT_TRUE(result.upToDate) << result.reason;
+	EXPECT_EQ(result.state.inputs.size(), 2u);
+}
+
+TEST_F(IncrementalFixture, ChangedInputsRunAgain) {
+	record();
+	write("schema/a.json", "{\"type\": \"object\"}");
+	EXPECT_FALSE(check().upToDate);
+
+	record();
+	write("schema/c.json", "{}");
+	EXPECT_FALSE(check().upToDate);
+}
+
+TEST_F(IncrementalFixture, OutputsHaveToExistAndBeNewer) {
+	record();
+	shift_mtime("out/types.hpp", std::chrono::seconds(-3600));
+	EXPECT_FALSE(check().upToDate);
+
+	std::filesystem::remove(root / "out/types.hpp");
+	EXPECT_FALSE(check().upToDate);
+}
+
+TEST_F(IncrementalFixture, ArgumentsArePartOfTheState) {
+	record();
+	EXPECT_FALSE(check({"target=release"}).upToDate);
+}
+
+TEST_F(IncrementalFixture, HashedInputsIgnoreModificationTimes) {
+	options.hashContents = true;
+	record();
+	ASSERT_NE(check().state.inputs.at(0).hash, 0u);
+
+	// A fresh checkout touches every file without changing it.
+	shift_mtime("schema/a.json", std::chrono::seconds(3600));
+	EXPECT_TRUE(check().upToDate);
+
+	options.hashContents = false;
+	EXPECT_FALSE(check().upToDate);
+}
+
+TEST_F(IncrementalFixture, ManyInputsAreStampedInOrder) {
+	std::filesystem::create_directories(root / "many");
+	for (int i = 0; i < 300; ++i) {
+		write("many/" + std::to_string(1000 + i) + ".txt", std::to_string(i));
+	}
+
+	const auto files = xxlib::incremental::expand_all(root, {"many/*.txt"});
+	ASSERT_EQ(files.size(), 300u);
+
+	const auto stamps = xxlib::incremental::fingerprint(files, true, {}, stats);
+	ASSERT_EQ(stamps.size(), files.size());
+	for (size_t i = 0; i < files.size(); ++i) {
+		EXPECT_EQ(stamps[i].path, files[i]);
+		EXPECT_EQ(stamps[i].size, std::to_string(i).size());
+		EXPECT_NE(stamps[i].hash, 0u);
+	}
+
+	// Unchanged files keep the hash they had, without being read again.
+	auto previous = stamps;
+	previous[0].hash = 42;
+	EXPECT_EQ(xxlib::incremental::fingerprint(files, true, previous, stats)[0].hash, 42u);
+}
+
+TEST(Incremental_StatCache, RemembersUntilCleared) {
+	const auto path = (std::filesystem::temp_directory_path() / "xx_incremental_stat_cache.txt").string();
+	std::ofstream(path, std::ios::trunc) << "one";
+
+	xxlib::incremental::StatCache stats;
+	ASSERT_TRUE(stats.stat(path).has_value());
+	EXPECT_EQ(stats.stat(path)->size, 3u);
+
+	std::ofstream(path, std::ios::trunc) << "three";
+	EXPECT_EQ(stats.stat(path)->size, 3u);
+	stats.clear();
+	EXPECT_EQ(stats.stat(path)->size, 5u);
+
+	std::filesystem::remove(path);
+	stats.clear();
+	EXPECT_FALSE(stats.stat(path).has_value());
+}
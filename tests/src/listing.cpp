@@ -0,0 +1,101 @@
+#include "detail/listing.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+	std::vector<Command> sample_commands() {
+		return {
+			Command{.name = "build", .cmd = {"make", "make install"}, .templateVars = {{"target", "all"}}},
+			Command{.name = "open", .cmd = {"start ."}, .constraints = {{"os", "windows"}}, .userScope = true},
+			Command{.name = "script", .cmd = {"print(\"hi\")"}, .dependsOn = {"build", "open"}, .executionEngine = xxlib::executor::Engine::Lua},
+		};
+	}
+
+	std::string write_listing(xxlib::listing::Format format, const std::vector<Command>& commands, const std::vector<bool>& available) {
+		auto* file = std::tmpfile();
+		{
+			auto writer = xxlib::listing::Writer(file, format);
+			for (size_t i = 0; i < commands.size(); ++i) {
+				writer.add(commands[i], available[i]);
+			}
+		}
+
+		std::string content;
+		std::rewind(file);
+		char chunk[4096];
+		while (const auto read = std::fread(chunk, 1, sizeof(chunk), file)) {
+			content.append(chunk, read);
+		}
+		std::fclose(file);
+		return content;
+	}
+} // namespace
+
+TEST(Listing_Writer, Text) {
+	const auto text = write_listing(xxlib::listing::Format::Text, sample_commands(), {true, false, true});
+
+	EXPECT_EQ(text, "Commands available for the current environment:\n"
+	                "-- build: make make install\n"
+	                "-- script: print(\"hi\")\n"
+	                "Commands not available for the current environment: (due to constraints)\n"
+	                "-- [User] open: start . [Constraints: os=windows]\n");
+}
+
+TEST(Listing_Writer, Json) {
+	const auto json = write_listing(xxlib::listing::Format::Json, sample_commands(), {true, false, true});
+
+	EXPECT_EQ(json, "[\n"
+	                R"({"name":"build","scope":"project","render_engine":"none","execution_engine":"system","available":true,"constraints":[],"template_vars":["target"],"depends_on":[],"cmd":"make make install"},)"
+	                "\n"
+	                R"({"name":"open","scope":"user","render_engine":"none","execution_engine":"system","available":false,"constraints":[{"key":"os","value":"windows"}],"template_vars":[],"depends_on":[],"cmd":"start ."},)"
+	                "\n"
+	                R"json({"name":"script","scope":"project","render_engine":"none","execution_engine":"lua","available":true,"constraints":[],"template_vars":[],"depends_on":["build","open"],"cmd":"print(\"hi\")"})json"
+	                "\n]\n");
+}
+
+TEST(Listing_Writer, Empty) {
+	EXPECT_EQ(write_listing(xxlib::listing::Format::Json, {}, {}), "[]\n");
+	EXPECT_EQ(write_listing(xxlib::listing::Format::Ndjson, {}, {}), "");
+}
+
+TEST(Listing_Writer, NdjsonOneObjectPerLine) {
+	const auto ndjson = write_listing(xxlib::listing::Format::Ndjson, sample_commands(), {true, false, true});
+
+	std::vector<std::string> lines;
+	size_t start = 0;
+	for (auto end = ndjson.find('\n'); end != std::string::npos; end = ndjson.find('\n', start)) {
+		lines.push_back(ndjson.substr(start, end - start));
+		start = end + 1;
+	}
+
+	EXPECT_EQ(start, ndjson.size());
+	ASSERT_EQ(lines.size(), 3u);
+	EXPECT_TRUE(lines[1].starts_with(R"({"name":"open","scope":"user")")) << lines[1];
+	EXPECT_TRUE(lines[2].ends_with("}"));
+}
+
+TEST(Listing_Writer, FlushesLargeListings) {
+	std::vector<Command> commands;
+	std::vector<bool> available;
+	for (auto i = 0; i < 5000; ++i) {
+		commands.push_back(Command{.name = "alias" + std::to_string(i), .cmd = {"echo " + std::to_string(i)}});
+		available.push_back(i % 2 == 0);
+	}
+
+	const auto ndjson = write_listing(xxlib::listing::Format::Ndjson, commands, available);
+	EXPECT_EQ(std::count(ndjson.begin(), ndjson.end(), '\n'), 5000);
+	EXPECT_NE(ndjson.find(R"({"name":"alias4999",)"), std::string::npos);
+
+	const auto text = write_listing(xxlib::listing::Format::Text, commands, available);
+	EXPECT_LT(text.find("-- alias4998:"), text.find("not available"));
+	EXPECT_GT(text.find("-- alias1:"), text.find("not available"));
+}
+
+TEST(Listing_AppendJsonString, Escapes) {
+	std::string out;
+	xxlib::listing::append_json_string(out, "a\"b\\c\nd\te\x01 caf\xc3\xa9");
+	EXPECT_EQ(out, "\"a\\\"b\\\\c\\nd\\te\\u0001 caf\xc3\xa9\"");
+}
@@ -0,0 +1,198 @@
+#include "detail/loader.hpp"
+#include "temp_dir_fixture.hpp"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+namespace {
+	struct LoaderFixture : public TempDirFixture {
+		xxlib::loader::Options options() const {
+			return xxlib::loader::Options{
+				.useCache = false,
+				.cacheDirectory = (root / "cache").string(),
+			};
+		}
+	};
+} // namespace
+
+TEST_F(LoaderFixture, MergesSourcesInOrder) {
+	const auto project = write_file("project.yaml", "alias:\n  build:\n    cmd: make\n  test:\n    cmd: make test\n");
+	const auto user = write_file("user.yaml", "alias:\n  deploy:\n    cmd: ./deploy.sh\n");
+
+	const auto result = xxlib::loader::load_sources(
+		{
+			{.path = project, .userScope = false, .strict = true},
+			{.path = user, .userScope = true, .strict = false},
+		},
+		options());
+
+	ASSERT_TRUE(result.has_value()) << result.error();
+	ASSERT_EQ(result->size(), 3u);
+	EXPECT_EQ(result->at(0).name, "build");
+	EXPECT_FALSE(result->at(0).userScope);
+	EXPECT_EQ(result->at(1).name, "test");
+	EXPECT_FALSE(result->at(1).userScope);
+	EXPECT_EQ(result->at(2).name, "deploy");
+	EXPECT_TRUE(result->at(2).userScope);
+}
+
+TEST_F(LoaderFixture, InheritedSourceIsOverridden) {
+	const auto inner = write_file("inner.yaml", "alias:\n  build:\n    cmd: make inner\n");
+	const auto outer = write_file("outer.yaml", "alias:\n  build:\n    cmd: make outer\n  lint:\n    cmd: make lint\n");
+
+	const auto result = xxlib::loader::load_sources(
+		{
+			{.path = inner, .userScope = false, .strict = true},
+			{.path = outer, .userScope = false, .strict = true, .inherited = true},
+		},
+		options());
+
+	ASSERT_TRUE(result.has_value()) << result.error();
+	ASSERT_EQ(result->size(), 2u);
+	EXPECT_EQ(result->at(0).name, "build");
+	EXPECT_EQ(result->at(0).cmd[0], "make inner");
+	EXPECT_EQ(result->at(1).name, "lint");
+}
+
+TEST_F(LoaderFixture, MissingSourceIsEmpty) {
+	const auto user = write_file("user.yaml", "alias:\n  deploy:\n    cmd: ./deploy.sh\n");
+
+	const auto result = xxlib::loader::load_sources(
+		{
+			{.path = (root / "missing.yaml").string(), .strict = true},
+			{.path = user, .userScope = true},
+		},
+		options());
+
+	ASSERT_TRUE(result.has_value());
+	ASSERT_EQ(result->size(), 1u);
+	EXPECT_EQ(result->at(0).name, "deploy");
+}
+
+TEST_F(LoaderFixture, StrictSourceFailsLoad) {
+	const auto project = write_file("project.yaml", "not_alias: 1\n");
+
+	const auto result = xxlib::loader::load_sources({{.path = project, .strict = true}}, options());
+
+	ASSERT_FALSE(result.has_value());
+	EXPECT_NE(result.error().find(project), std::string::npos);
+}
+
+TEST_F(LoaderFixture, NonStrictSourceIsSkipped) {
+	const auto project = write_file("project.yaml", "alias:\n  build:\n    cmd: make\n");
+	const auto user = write_file("user.yaml", "not_alias: 1\n");
+
+	const auto result = xxlib::loader::load_sources(
+		{
+			{.path = project, .strict = true},
+			{.path = user, .userScope = true, .strict = false},
+		},
+		options());
+
+	ASSERT_TRUE(result.has_value());
+	ASSERT_EQ(result->size(), 1u);
+	EXPECT_EQ(result->at(0).name, "build");
+}
+
+TEST_F(LoaderFixture, CommandNameFiltersAliases) {
+	const auto project = write_file("project.yaml", "alias:\n  build:\n    cmd: make\n  test:\n    cmd: make test\n");
+
+	auto opts = options();
+	opts.commandName = "test";
+
+	const auto result = xxlib::loader::load_sources({{.path = project, .strict = true}}, opts);
+
+	ASSERT_TRUE(result.has_value());
+	ASSERT_EQ(result->size(), 1u);
+	EXPECT_EQ(result->at(0).name, "test");
+}
+
+TEST_F(LoaderFixture, StdinIsParsedInFullAndReadOnce) {
+	const auto piped = write_file("piped.yaml", "alias:\n  build:\n    cmd: make\n  test:\n    cmd: make test\n    depends_on: [build]\n");
+	ASSERT_NE(std::freopen(piped.c_str(), "rb", stdin), nullptr);
+
+	auto opts = options();
+	opts.commandName = "test";
+	const auto targeted = xxlib::loader::load_sources({{.path = "-", .strict = true}}, opts);
+	ASSERT_TRUE(targeted.has_value()) << targeted.error();
+	EXPECT_EQ(targeted->size(), 2u);
+
+	// Loading everything again sees the same content instead of an exhausted stream.
+	const auto full = xxlib::loader::load_sources({{.path = "-", .strict = true}}, options());
+	ASSERT_TRUE(full.has_value()) << full.error();
+	ASSERT_EQ(full->size(), 2u);
+	EXPECT_EQ(full->at(0).name, "build");
+}
+
+TEST_F(LoaderFixture, ResolvesIncludes) {
+	std::filesystem::create_directories(root / "teams");
+	write_file("teams/a.yaml", "alias:\n  a:\n    cmd: echo a\n");
+	write_file("teams/b.yaml", "include: ../shared.yaml\nalias:\n  b:\n    cmd: echo b\n");
+	write_file("shared.yaml", "alias:\n  shared:\n    cmd: echo shared\n");
+	const auto project = write_file("project.yaml", "include:\n  - teams/*.yaml\n  - shared.yaml\nalias:\n  root:\n    cmd: echo root\n");
+
+	const auto result = xxlib::loader::load_sources({{.path = project, .strict = true}}, options());
+
+	ASSERT_TRUE(result.has_value()) << result.error();
+	ASSERT_EQ(result->size(), 4u);
+	EXPECT_EQ(result->at(0).name, "root");
+	EXPECT_EQ(result->at(1).name, "a");
+	EXPECT_EQ(result->at(2).name, "b");
+	EXPECT_EQ(result->at(3).name, "shared");
+}
+
+TEST_F(LoaderFixture, IncludeOnlyRoot) {
+	write_file("a.yaml", "alias:\n  a:\n    cmd: echo a\n");
+	const auto project = write_file("project.yaml", "include: a.yaml\n");
+
+	const auto result = xxlib::loader::load_sources({{.path = project, .userScope = true, .strict = true}}, options());
+
+	ASSERT_TRUE(result.has_value()) << result.error();
+	ASSERT_EQ(result->size(), 1u);
+	EXPECT_EQ(result->at(0).name, "a");
+	EXPECT_TRUE(result->at(0).userScope);
+}
+
+TEST_F(LoaderFixture, DetectsIncludeCycles) {
+	write_file("a.yaml", "include: b.yaml\nalias:\n  a:\n    cmd: echo a\n");
+	write_file("b.yaml", "include: a.yaml\nalias:\n  b:\n    cmd: echo b\n");
+	const auto project = write_file("project.yaml", "include: a.yaml\n");
+
+	const auto result = xxlib::loader::load_sources({{.path = project, .strict = true}}, options());
+
+	ASSERT_FALSE(result.has_value());
+	EXPECT_NE(result.error().find("Include cycle detected"), std::string::npos) << result.error();
+}
+
+TEST_F(LoaderFixture, MissingIncludeFails) {
+	const auto project = write_file("project.yaml", "include: missing.yaml\nalias:\n  a:\n    cmd: echo a\n");
+
+	const auto result = xxlib::loader::load_sources({{.path = project, .strict = true}}, options());
+
+	ASSERT_FALSE(result.has_value());
+	EXPECT_NE(result.error().find("Included file not found"), std::string::npos) << result.error();
+}
+
+TEST_F(LoaderFixture, CachesIncludedFragments) {
+	write_file("a.yaml", "alias:\n  a:\n    cmd: echo a\n");
+	const auto project = write_file("project.yaml", "include: a.yaml\nalias:\n  root:\n    cmd: echo root\n");
+
+	auto opts = options();
+	opts.useCache = true;
+
+	const auto first = xxlib::loader::load_sources({{.path = project, .strict = true}}, opts);
+	ASSERT_TRUE(first.has_value()) << first.error();
+	ASSERT_EQ(first->size(), 2u);
+
+	size_t entries = 0;
+	for (const auto& entry : std::filesystem::directory_iterator(root / "cache")) {
+		entries += entry.path().extension() == ".xxc" ? 1 : 0;
+	}
+	EXPECT_EQ(entries, 2u);
+
+	const auto second = xxlib::loader::load_sources({{.path = project, .strict = true}}, opts);
+	ASSERT_TRUE(second.has_value());
+	ASSERT_EQ(second->size(), 2u);
+	EXPECT_EQ(second->at(1).name, "a");
+}
@@ -391,3 +391,26 @@ TEST(LuaVM_JsonIpairs, IpairsOnlyForArrays) {
 	EXPECT_EQ(pcallStatus, 0);
 	EXPECT_TRUE(xxlib::luavm::is_nil(luaState, -2));
 }
+
+TEST(LuaVM_Bytecode, DumpsAndLoadsBytecode) {
+	auto luaState = xxlib::luavm::create();
+
+	const auto bytecode = xxlib::luavm::dump(luaState, "return 6 * 7");
+	ASSERT_TRUE(bytecode.has_value()) << bytecode.error();
+
+	EXPECT_EQ(xxlib::luavm::loadbytecode(luaState, *bytecode), 0);
+	EXPECT_EQ(xxlib::luavm::pcall(luaState, 0, 1, 0), 0);
+	EXPECT_EQ(xxlib::luavm::tointeger(luaState), 42);
+}
+
+TEST(LuaVM_Bytecode, RejectsSourceAsBytecode) {
+	auto luaState = xxlib::luavm::create();
+
+	EXPECT_NE(xxlib::luavm::loadbytecode(luaState, "return 42"), 0);
+}
+
+TEST(LuaVM_Bytecode, DumpFailsOnInvalidLuaCode) {
+	auto luaState = xxlib::luavm::create();
+
+	EXPECT_FALSE(xxlib::luavm::dump(luaState, "return }").has_value());
+}
@@ -0,0 +1,222 @@
+#include "detail/parallel.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using xxlib::parallel::Status;
+
+namespace {
+	class ParallelFixture : public ::testing::Test {
+	  protected:
+		void SetUp() override {
+			out = std::tmpfile();
+			ASSERT_NE(out, nullptr);
+		}
+
+		void TearDown() override {
+			std::fclose(out);
+		}
+
+		std::string written() const {
+			std::string text;
+			std::rewind(out);
+			char chunk[256];
+			size_t count = 0;
+			while ((count = std::fread(chunk, 1, sizeof(chunk), out)) > 0) {
+				text.append(chunk, count);
+			}
+			return text;
+		}
+
+		static std::vector<xxlib::parallel::Job> jobs_named(const std::vector<std::string>& names) {
+			std::vector<xxlib::parallel::Job> jobs;
+			for (const auto& name : names) {
+				jobs.push_back({.command = Command{.name = name}});
+			}
+			return jobs;
+		}
+
+		FILE* out = nullptr;
+	};
+} // namespace
+
+TEST_F(ParallelFixture, PoolIsBounded) {
+	std::atomic<int> running = 0;
+	std::atomic<int> peak = 0;
+	const auto execute = [&](Command&, CommandContext&) -> std::expected<int32_t, std::string> {
+		const auto now = ++running;
+		auto seen = peak.load();
+		while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(30));
+		--running;
+		return 0;
+	};
+
+	const auto results = xxlib::parallel::run(jobs_named({"a", "b", "c", "d", "e", "f"}), {.jobs = 2}, out, execute);
+
+	EXPECT_EQ(peak, 2);
+	EXPECT_TRUE(std::all_of(results.begin(), results.end(), [](const auto& result) {
+		return result.status == Status::Succeeded;
+	}));
+	EXPECT_EQ(xxlib::parallel::combined_exit_code(results), 0);
+}
+
+TEST_F(ParallelFixture, GroupedOutputIsWrittenAtOnce) {
+	const auto execute = [](Command& command, CommandContext& context) -> std::expected<int32_t, std::string> {
+		for (auto i = 0; i < 3; ++i) {
+			context.output(command.name + std::to_string(i) + "\n");
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		context.output("no newline");
+		return 0;
+	};
+
+	const auto results = xxlib::parallel::run(jobs_named({"lint", "test", "docs"}), {.jobs = 3}, out, execute);
+
+	const auto text = written();
+	for (const auto* name : {"lint", "test", "docs"}) {
+		const auto block = "==> " + std::string(name) + " <==\n" + name + "0\n" + name + "1\n" + name + "2\nno newline\n";
+		EXPECT_NE(text.find(block), std::string::npos) << text;
+	}
+	EXPECT_EQ(text.size(), 3 * std::string("==> lint <==\nlint0\nlint1\nlint2\nno newline\n").size());
+}
+
+TEST_F(ParallelFixture, PrefixedOutputIsWrittenByLine) {
+	const auto execute = [](Command& command, CommandContext& context) -> std::expected<int32_t, std::string> {
+		if (command.name == "build") {
+			context.output("hel");
+			context.output("lo\nwor");
+			context.output("ld");
+		} else {
+			context.output("ok\n");
+		}
+		return 0;
+	};
+
+	const auto results = xxlib::parallel::run(jobs_named({"build", "ut"}), {.jobs = 1, .output = xxlib::parallel::Output::Prefixed}, out, execute);
+
+	EXPECT_EQ(written(), "build | hello\nbuild | world\nut    | ok\n");
+}
+
+TEST_F(ParallelFixture, FailFastSkipsJobsNotStarted) {
+	const auto execute = [](Command& command, CommandContext&) -> std::expected<int32_t, std::string> {
+		if (command.name == "bad") {
+			return 3;
+		}
+		return 0;
+	};
+
+	const auto results = xxlib::parallel::run(jobs_named({"ok", "bad", "later"}), {.jobs = 1}, out, execute);
+
+	ASSERT_EQ(results.size(), 3u);
+	EXPECT_EQ(results[0].status, Status::Succeeded);
+	EXPECT_EQ(results[1].status, Status::Failed);
+	EXPECT_EQ(results[1].exitCode, 3);
+	EXPECT_EQ(results[2].status, Status::Skipped);
+	EXPECT_EQ(xxlib::parallel::combined_exit_code(results), 3);
+}
+
+TEST_F(ParallelFixture, KeepGoingRunsEverything) {
+	const auto execute = [](Command& command, CommandContext&) -> std::expected<int32_t, std::string> {
+		if (command.name == "error") {
+			return std::unexpected("The following template variables are not set: x");
+		}
+		if (command.name == "throws") {
+			throw std::runtime_error("Unknown renderer");
+		}
+		return command.name == "bad" ? 2 : 0;
+	};
+
+	const auto results = xxlib::parallel::run(jobs_named({"error", "bad", "throws", "ok"}), {.jobs = 1, .keepGoing = true}, out, execute);
+
+	ASSERT_EQ(results.size(), 4u);
+	EXPECT_EQ(results[0].status, Status::Error);
+	EXPECT_EQ(results[0].error, "The following template variables are not set: x");
+	EXPECT_EQ(results[1].status, Status::Failed);
+	EXPECT_EQ(results[2].status, Status::Error);
+	EXPECT_EQ(results[2].error, "Unknown renderer");
+	EXPECT_EQ(results[3].status, Status::Succeeded);
+	EXPECT_EQ(xxlib::parallel::combined_exit_code(results), -1);
+}
+
+TEST_F(ParallelFixture, DependenciesRunFirst) {
+	std::mutex mutex;
+	std::vector<std::string> order;
+	const auto execute = [&](Command& command, CommandContext&) -> std::expected<int32_t, std::string> {
+		std::this_thread::sleep_for(std::chrono::milliseconds(command.name == "docs" ? 20 : 5));
+		std::lock_guard lock(mutex);
+		order.push_back(command.name);
+		return 0;
+	};
+
+	// build -> (test, docs) -> package, with lint independent.
+	auto jobs = jobs_named({"build", "test", "docs", "package", "lint"});
+	jobs[1].dependsOn = {0};
+	jobs[2].dependsOn = {0};
+	jobs[3].dependsOn = {1, 2};
+
+	const auto results = xxlib::parallel::run(std::move(jobs), {.jobs = 4}, out, execute);
+
+	ASSERT_EQ(order.size(), 5u);
+	const auto position = [&order](const std::string& name) {
+		return std::find(order.begin(), order.end(), name) - order.begin();
+	};
+	EXPECT_LT(position("build"), position("test"));
+	EXPECT_LT(position("build"), position("docs"));
+	EXPECT_LT(position("test"), position("package"));
+	EXPECT_LT(position("docs"), position("package"));
+	EXPECT_EQ(order.back(), "package");
+	EXPECT_EQ(xxlib::parallel::combined_exit_code(results), 0);
+}
+
+TEST_F(ParallelFixture, DependentsRunInParallel) {
+	std::atomic<int> running = 0;
+	std::atomic<int> peak = 0;
+	const auto execute = [&](Command& command, CommandContext&) -> std::expected<int32_t, std::string> {
+		const auto now = ++running;
+		auto seen = peak.load();
+		while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(command.name == "build" ? 10 : 100));
+		--running;
+		return 0;
+	};
+
+	// The dependents are submitted after the root jobs, when the pool is already draining.
+	auto jobs = jobs_named({"build", "test", "docs", "lint", "package"});
+	for (size_t i = 1; i < jobs.size(); ++i) {
+		jobs[i].dependsOn = {0};
+	}
+
+	const auto results = xxlib::parallel::run(std::move(jobs), {.jobs = 4}, out, execute);
+
+	EXPECT_GT(peak, 1);
+	EXPECT_EQ(xxlib::parallel::combined_exit_code(results), 0);
+}
+
+TEST_F(ParallelFixture, FailedDependencySkipsDependents) {
+	const auto execute = [](Command& command, CommandContext&) -> std::expected<int32_t, std::string> {
+		return command.name == "test" ? 1 : 0;
+	};
+
+	auto jobs = jobs_named({"build", "test", "package", "docs"});
+	jobs[1].dependsOn = {0};
+	jobs[2].dependsOn = {1};
+	jobs[3].dependsOn = {0};
+
+	const auto results = xxlib::parallel::run(std::move(jobs), {.jobs = 1, .keepGoing = true}, out, execute);
+
+	EXPECT_EQ(results[0].status, Status::Succeeded);
+	EXPECT_EQ(results[1].status, Status::Failed);
+	EXPECT_EQ(results[2].status, Status::Skipped);
+	EXPECT_EQ(results[3].status, Status::Succeeded);
+	EXPECT_EQ(xxlib::parallel::combined_exit_code(results), 1);
+}
@@ -1,9 +1,18 @@
 #include "detail/parser.hpp"
 #include <gtest/gtest.h>
+#include <spdlog/sinks/ringbuffer_sink.h>
+#include <spdlog/spdlog.h>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <optional>
 #include <string>
 #include <memory>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
 
 std::string create_test_file(const std::string& name, const std::string& content) {
 	auto tempFilePath = std::filesystem::temp_directory_path() / name;
@@ -57,6 +66,87 @@ TEST(Parser_ReadFile, FileTooLarge) {
 	EXPECT_EQ(result.error(), "File size exceeds 1 MB limit: " + tempFile.get());
 }
 
+TEST(Parser_ReadFile, ConfigurableLimit) {
+	auto tempFile = TempFilePtr("test_read_file_configurable_limit.txt", std::string(100, 'X'));
+
+	auto limited = xxlib::parser::read_file(tempFile.get(), 10);
+	ASSERT_FALSE(limited.has_value());
+	EXPECT_EQ(limited.error(), "File size exceeds 10 bytes limit: " + tempFile.get());
+
+	auto unlimited = xxlib::parser::read_file(tempFile.get(), 0);
+	ASSERT_TRUE(unlimited.has_value());
+	EXPECT_EQ(unlimited->size(), 100u);
+}
+
+TEST(Parser_MapFile, MatchesReadFile) {
+	const auto content = std::string("alias:\n  build:\n    - cmd: \"echo Building project\"\n");
+	auto tempFile = TempFilePtr("test_map_file_matches.yaml", content);
+
+	auto mapped = xxlib::parser::map_file(tempFile.get());
+	auto read = xxlib::parser::read_file(tempFile.get());
+
+	ASSERT_TRUE(mapped.has_value());
+	ASSERT_TRUE(read.has_value());
+	EXPECT_TRUE(mapped->is_mapped());
+	EXPECT_EQ(mapped->view(), read.value());
+	EXPECT_EQ(mapped->view(), content);
+
+	auto fromMapped = xxlib::parser::parse_buffer(mapped->view());
+	auto fromRead = xxlib::parser::parse_buffer(*read);
+	ASSERT_TRUE(fromMapped.has_value());
+	ASSERT_TRUE(fromRead.has_value());
+	ASSERT_EQ(fromMapped->size(), fromRead->size());
+	EXPECT_EQ(fromMapped->at(0).name, fromRead->at(0).name);
+	EXPECT_EQ(fromMapped->at(0).cmd, fromRead->at(0).cmd);
+}
+
+TEST(Parser_MapFile, LargeFileWithoutLimit) {
+	auto largeContent = std::string(2 * 1024 * 1024, 'X');
+	auto tempFile = TempFilePtr("test_map_file_large.txt", largeContent);
+
+	auto mapped = xxlib::parser::map_file(tempFile.get());
+	ASSERT_TRUE(mapped.has_value());
+	EXPECT_EQ(mapped->view().size(), largeContent.size());
+	EXPECT_EQ(mapped->view(), largeContent);
+}
+
+TEST(Parser_MapFile, EmptyFile) {
+	auto tempFile = TempFilePtr("test_map_file_empty.txt", "");
+
+	auto mapped = xxlib::parser::map_file(tempFile.get());
+	ASSERT_TRUE(mapped.has_value());
+	EXPECT_TRUE(mapped->view().empty());
+}
+
+TEST(Parser_MapFile, FileDoesNotExist) {
+	auto mapped = xxlib::parser::map_file("non_existent_file.txt");
+
+	ASSERT_FALSE(mapped.has_value());
+	EXPECT_EQ(mapped.error(), "Failed to open file: non_existent_file.txt");
+}
+
+#ifndef _WIN32
+TEST(Parser_MapFile, PipeFallback) {
+	const auto fifoPath = (std::filesystem::temp_directory_path() / "test_map_file_fifo").string();
+	std::filesystem::remove(fifoPath);
+	ASSERT_EQ(mkfifo(fifoPath.c_str(), 0600), 0);
+
+	const auto content = std::string("alias:\n  hello:\n    - cmd: \"echo hello\"\n");
+	std::thread writer([&]() {
+		std::ofstream fifo(fifoPath, std::ios::binary);
+		fifo << content;
+	});
+
+	auto mapped = xxlib::parser::map_file(fifoPath);
+	writer.join();
+	std::filesystem::remove(fifoPath);
+
+	ASSERT_TRUE(mapped.has_value());
+	EXPECT_FALSE(mapped->is_mapped());
+	EXPECT_EQ(mapped->view(), content);
+}
+#endif
+
 TEST(Parser_ParseBuffer, BasicYamlSingleCommand) {
 	const auto yaml = R"(
 alias:
@@ -211,6 +301,160 @@ alias:
 	EXPECT_EQ(hello.templateVars.at("target"), "World");
 }
 
+TEST(Parser_ParseBuffer, UnknownKeysAreReported) {
+	const std::string yaml = R"(
+alias:
+  build:
+    cmd: make
+    descripton: Builds the project
+)";
+
+	auto sink = std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(8);
+	auto previousLogger = spdlog::default_logger();
+	spdlog::set_default_logger(std::make_shared<spdlog::logger>("parser_test", sink));
+
+	auto result = xxlib::parser::parse_buffer(yaml);
+
+	spdlog::set_default_logger(previousLogger);
+
+	ASSERT_TRUE(result.has_value());
+	ASSERT_EQ(result->size(), 1u);
+	EXPECT_EQ(result->at(0).cmd.at(0), "make");
+
+	const auto messages = sink->last_raw();
+	ASSERT_EQ(messages.size(), 1u);
+	EXPECT_EQ(messages[0].level, spdlog::level::warn);
+	EXPECT_NE(std::string(messages[0].payload.begin(), messages[0].payload.end()).find("descripton"), std::string::npos);
+}
+
+TEST(Parser_ParseBuffer, KeysInAnyOrder) {
+	const std::string yaml = R"(
+alias:
+  build:
+    requires_confirmation: true
+    env:
+      CC: clang
+    cmd: [make, make install]
+)";
+
+	auto result = xxlib::parser::parse_buffer(yaml);
+	ASSERT_TRUE(result.has_value());
+	ASSERT_EQ(result->size(), 1u);
+	EXPECT_EQ(result->at(0).cmd.size(), 2u);
+	EXPECT_TRUE(result->at(0).requiresConfirmation);
+	EXPECT_EQ(result->at(0).envs.at("CC"), "clang");
+}
+
+TEST(Parser_ParseBuffer, FirstOfRepeatedKeysWins) {
+	const std::string yaml = R"(
+alias:
+  build:
+    cmd: make
+    depends_on: [lint]
+    cmd: make all
+    depends_on: [test]
+)";
+
+	for (const auto backend : {xxlib::parser::Backend::Events, xxlib::parser::Backend::Dom}) {
+		auto result = xxlib::parser::parse_document(yaml, backend);
+		ASSERT_TRUE(result.has_value()) << result.error();
+		ASSERT_EQ(result->commands.size(), 1u);
+		EXPECT_EQ(result->commands[0].cmd, (std::vector<std::string>{"make"}));
+		EXPECT_EQ(result->commands[0].dependsOn, (std::vector<std::string>{"lint"}));
+	}
+}
+
+TEST(Parser_ParseBuffer, ConstraintsAreCompiled) {
+	const std::string yaml = R"(
+alias:
+  build:
+    cmd: make
+    constraints:
+      - os: [linux, macos]
+      - not_arch: arm64
+)";
+
+	auto result = xxlib::parser::parse_buffer(yaml);
+	ASSERT_TRUE(result.has_value());
+	ASSERT_EQ(result->size(), 1u);
+
+	const auto& build = result->at(0);
+	ASSERT_EQ(build.constraints.size(), 2u);
+	EXPECT_EQ(build.constraints.at(0).second, "linux,macos");
+	EXPECT_EQ(build.constraintMask, xxlib::constraint::OS_LINUX | xxlib::constraint::OS_MACOS | xxlib::constraint::ARCH_X86_64 | xxlib::constraint::FAMILY_ALL);
+}
+
+TEST(Parser_ParseBuffer, DependsOn) {
+	const std::string yaml = R"(
+alias:
+  package:
+    cmd: cpack
+    depends_on: [build, test]
+  test:
+    cmd: ctest
+    depends_on: build
+  broken:
+    cmd: "true"
+    depends_on:
+      other: build
+)";
+
+	auto result = xxlib::parser::parse_buffer(yaml);
+	ASSERT_TRUE(result.has_value());
+	ASSERT_EQ(result->size(), 2u);
+	EXPECT_EQ(result->at(0).dependsOn, (std::vector<std::string>{"build", "test"}));
+	EXPECT_EQ(result->at(1).dependsOn, (std::vector<std::string>{"build"}));
+}
+
+TEST(Parser_ParseBuffer, InputsAndOutputs) {
+	const std::string yaml = R"(
+alias:
+  codegen:
+    cmd: ./generate.sh
+    inputs: [schema/**/*.json, generate.sh]
+    outputs: src/generated.hpp
+    cache: true
+    cache_env: [CC, CFLAGS]
+)";
+
+	auto result = xxlib::parser::parse_buffer(yaml);
+	ASSERT_TRUE(result.has_value());
+	ASSERT_EQ(result->size(), 1u);
+	EXPECT_EQ(result->at(0).inputs, (std::vector<std::string>{"schema/**/*.json", "generate.sh"}));
+	EXPECT_EQ(result->at(0).outputs, (std::vector<std::string>{"src/generated.hpp"}));
+	EXPECT_TRUE(result->at(0).cacheResults);
+	EXPECT_EQ(result->at(0).cacheEnv, (std::vector<std::string>{"CC", "CFLAGS"}));
+}
+
+TEST(Parser_ParseBuffer, UnknownConstraintsAreReported) {
+	const std::string yaml = R"(
+alias:
+  build:
+    cmd: make
+    constraints:
+      - shell: bash
+)";
+
+	auto sink = std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(8);
+	auto previousLogger = spdlog::default_logger();
+	spdlog::set_default_logger(std::make_shared<spdlog::logger>("parser_test", sink));
+
+	auto result = xxlib::parser::parse_buffer(yaml);
+
+	spdlog::set_default_logger(previousLogger);
+
+	ASSERT_TRUE(result.has_value());
+	ASSERT_EQ(result->size(), 1u);
+	EXPECT_EQ(result->at(0).constraintMask, xxlib::constraint::UNSATISFIABLE);
+
+	const auto messages = sink->last_raw();
+	ASSERT_EQ(messages.size(), 1u);
+	EXPECT_EQ(messages[0].level, spdlog::level::warn);
+	const auto payload = std::string(messages[0].payload.begin(), messages[0].payload.end());
+	EXPECT_NE(payload.find("shell"), std::string::npos);
+	EXPECT_NE(payload.find("build"), std::string::npos);
+}
+
 TEST(Parser_ParseBuffer, FlatListLayout) {
 	const std::string yaml = R"(
 aliases:
@@ -232,3 +476,216 @@ aliases:
 	EXPECT_EQ(hello.templateVars.at("greeting"), "Hello");
 	EXPECT_EQ(hello.templateVars.at("target"), "World");
 }
+
+TEST(Parser_ParseBufferFor, OnlyMaterializesRequestedAlias) {
+	const std::string yaml = R"(
+alias:
+  build:
+    - cmd: "echo Building on unix"
+      constraints:
+        - osfamily: unix
+    - cmd: "echo Building on windows"
+      constraints:
+        - osfamily: windows
+  test:
+    - cmd: "echo Running tests"
+  broken: [ {} ]
+)";
+
+	auto result = xxlib::parser::parse_buffer_for(yaml, "build");
+	ASSERT_TRUE(result.has_value());
+	ASSERT_EQ(result->size(), 2u);
+	EXPECT_EQ(result->at(0).name, "build");
+	EXPECT_EQ(result->at(0).cmd.at(0), "echo Building on unix");
+	EXPECT_EQ(result->at(1).name, "build");
+	EXPECT_EQ(result->at(1).cmd.at(0), "echo Building on windows");
+}
+
+TEST(Parser_ParseBufferFor, SkipsInvalidOtherAliases) {
+	const std::string yaml = R"(
+alias:
+  invalid: "not a table"
+  test:
+    cmd: "echo Running tests"
+)";
+
+	ASSERT_FALSE(xxlib::parser::parse_buffer(yaml).has_value());
+
+	auto result = xxlib::parser::parse_buffer_for(yaml, "test");
+	ASSERT_TRUE(result.has_value());
+	ASSERT_EQ(result->size(), 1u);
+	EXPECT_EQ(result->at(0).cmd.at(0), "echo Running tests");
+}
+
+TEST(Parser_ParseBufferFor, FlatListLayout) {
+	const std::string yaml = R"(
+aliases:
+  - name: hello
+    cmd: "echo hello"
+  - name: bye
+    cmd: "echo bye"
+)";
+
+	auto result = xxlib::parser::parse_buffer_for(yaml, "bye");
+	ASSERT_TRUE(result.has_value());
+	ASSERT_EQ(result->size(), 1u);
+	EXPECT_EQ(result->at(0).name, "bye");
+	EXPECT_EQ(result->at(0).cmd.at(0), "echo bye");
+}
+
+TEST(Parser_ParseBufferFor, NoMatches) {
+	const std::string yaml = R"(
+alias:
+  build:
+    cmd: "echo Building project"
+)";
+
+	auto result = xxlib::parser::parse_buffer_for(yaml, "deploy");
+	ASSERT_TRUE(result.has_value());
+	EXPECT_TRUE(result->empty());
+}
+
+TEST(Parser_ParseDocument, Includes) {
+	const std::string yaml = R"(
+include:
+  - teams/*.yaml
+  - shared.yaml
+alias:
+  build:
+    cmd: "make"
+)";
+
+	auto result = xxlib::parser::parse_document(yaml);
+	ASSERT_TRUE(result.has_value());
+	ASSERT_EQ(result->includes.size(), 2u);
+	EXPECT_EQ(result->includes.at(0), "teams/*.yaml");
+	EXPECT_EQ(result->includes.at(1), "shared.yaml");
+	ASSERT_EQ(result->commands.size(), 1u);
+}
+
+TEST(Parser_ParseDocument, IncludeOnly) {
+	auto result = xxlib::parser::parse_document("include: shared.yaml\n");
+	ASSERT_TRUE(result.has_value());
+	ASSERT_EQ(result->includes.size(), 1u);
+	EXPECT_TRUE(result->commands.empty());
+}
+
+TEST(Parser_ParseDocument, InvalidInclude) {
+	auto result = xxlib::parser::parse_document("include:\n  nested: true\nalias:\n  a:\n    cmd: echo\n");
+	ASSERT_FALSE(result.has_value());
+	EXPECT_EQ(result.error(), "'include' must be a string or an array of strings");
+}
+
+namespace {
+	void expect_backends_agree(const std::string& yaml, std::optional<std::string_view> commandName = std::nullopt) {
+		const auto dom = commandName ? xxlib::parser::parse_document_for(yaml, *commandName, xxlib::parser::Backend::Dom) : xxlib::parser::parse_document(yaml, xxlib::parser::Backend::Dom);
+		const auto events = commandName ? xxlib::parser::parse_document_for(yaml, *commandName, xxlib::parser::Backend::Events) : xxlib::parser::parse_document(yaml, xxlib::parser::Backend::Events);
+
+		ASSERT_EQ(dom.has_value(), events.has_value());
+		if (!dom) {
+			EXPECT_EQ(dom.error(), events.error());
+			return;
+		}
+		EXPECT_EQ(dom->includes, events->includes);
+		EXPECT_EQ(dom->commands, events->commands);
+	}
+} // namespace
+
+TEST(Parser_Backend, AliasLayoutMatchesDom) {
+	expect_backends_agree(R"(
+include: shared.yaml
+alias:
+  build:
+    cmd: make
+    env: &buildEnv
+      CC: clang
+      CFLAGS: -O2
+  test:
+    - cmd: [make test, make check]
+      env: *buildEnv
+      constraints:
+        - os: linux
+      requires_confirmation: true
+    - cmd: 'echo "{{ greeting }}"'
+      render_engine: inja
+      execution_engine: lua
+      template_vars:
+        greeting: Hello
+        empty:
+  broken:
+    cmd: {}
+)");
+}
+
+TEST(Parser_Backend, FlatLayoutMatchesDom) {
+	expect_backends_agree(R"(
+aliases:
+  - name: hello
+    cmd: "echo hello"
+    env:
+      LANG: C
+  - name: bye
+    cmd: ["echo bye", "exit 0"]
+)");
+}
+
+TEST(Parser_Backend, ErrorsMatchDom) {
+	expect_backends_agree("just a scalar");
+	expect_backends_agree("");
+	expect_backends_agree("other: 1\n");
+	expect_backends_agree("alias:\n  a: [1, 2]\n");
+	expect_backends_agree("alias:\n  a: plain\n");
+	expect_backends_agree("aliases:\n  - cmd: echo\n");
+	expect_backends_agree("include: [a, [b]]\nalias: {}\n");
+	expect_backends_agree("alias:\n  a:\n    cmd: [unclosed\n");
+}
+
+TEST(Parser_Backend, TargetedParseMatchesDom) {
+	const std::string yaml = R"(
+alias:
+  build:
+    cmd: make
+    env: &shared
+      CC: clang
+  test:
+    cmd: make test
+    env: *shared
+  lint:
+    cmd: make lint
+)";
+
+	expect_backends_agree(yaml, "test");
+	expect_backends_agree(yaml, "lint");
+
+	// The anchor lives in a skipped alias, so the event backend has to fall back to the DOM.
+	auto result = xxlib::parser::parse_document_for(yaml, "test", xxlib::parser::Backend::Events);
+	ASSERT_TRUE(result.has_value()) << result.error();
+	ASSERT_EQ(result->commands.size(), 1u);
+	EXPECT_EQ(result->commands[0].envs.at("CC"), "clang");
+}
+
+TEST(Parser_Backend, DISABLED_Benchmark) {
+	std::string yaml = "alias:\n";
+	for (auto i = 0; i < 2000; ++i) {
+		yaml += "  alias" + std::to_string(i) + ":\n";
+		yaml += "    cmd: [\"make target" + std::to_string(i) + "\", \"make install\"]\n";
+		yaml += "    env:\n      CC: clang\n      CXX: clang++\n";
+		yaml += "    constraints:\n      - os: linux\n";
+	}
+
+	const auto measure = [&](xxlib::parser::Backend backend) {
+		const auto start = std::chrono::steady_clock::now();
+		auto result = xxlib::parser::parse_document(yaml, backend);
+		const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+		EXPECT_TRUE(result.has_value());
+		EXPECT_EQ(result->commands.size(), 2000u);
+		return std::pair{elapsed.count(), std::move(*result)};
+	};
+
+	const auto [domMicros, dom] = measure(xxlib::parser::Backend::Dom);
+	const auto [eventsMicros, events] = measure(xxlib::parser::Backend::Events);
+
+	EXPECT_EQ(dom.commands, events.commands);
+	RecordProperty("dom_us", static_cast<int>(domMicros));
+	RecordProperty("events_us", static_cast<int>(eventsMicros));
+}
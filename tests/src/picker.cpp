@@ -0,0 +1,104 @@
+#include "detail/picker.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using xxlib::picker::Key;
+using xxlib::picker::KeyKind;
+
+namespace {
+	class PickerFixture : public ::testing::Test {
+	  protected:
+		std::vector<std::string_view> names{"build", "bump", "deploy", "test"};
+		xxlib::FuzzyIndex index{names};
+
+		static void type(xxlib::picker::Picker& picker, std::string_view text) {
+			for (const auto c : text) {
+				picker.handle(Key{.kind = KeyKind::Character, .character = c});
+			}
+		}
+	};
+} // namespace
+
+TEST(Picker_DecodeKeys, DecodesKeys) {
+	const auto keys = xxlib::picker::decode_keys("ab\x1b[A\x1bOB\x7f\x15\r\x10\x0e\x03");
+
+	EXPECT_EQ(keys, (std::vector<Key>{
+		Key{.kind = KeyKind::Character, .character = 'a'},
+		Key{.kind = KeyKind::Character, .character = 'b'},
+		Key{.kind = KeyKind::Up},
+		Key{.kind = KeyKind::Down},
+		Key{.kind = KeyKind::Backspace},
+		Key{.kind = KeyKind::ClearQuery},
+		Key{.kind = KeyKind::Accept},
+		Key{.kind = KeyKind::Up},
+		Key{.kind = KeyKind::Down},
+		Key{.kind = KeyKind::Cancel},
+	}));
+}
+
+TEST(Picker_DecodeKeys, DropsUnknownSequences) {
+	EXPECT_EQ(xxlib::picker::decode_keys("\x1b[1;5Cx\x1b[3~"), (std::vector<Key>{Key{.kind = KeyKind::Character, .character = 'x'}}));
+	EXPECT_EQ(xxlib::picker::decode_keys("\x1b"), (std::vector<Key>{Key{.kind = KeyKind::Cancel}}));
+}
+
+TEST_F(PickerFixture, TypingNarrowsAndBackspaceRestores) {
+	auto picker = xxlib::picker::Picker(index);
+	EXPECT_EQ(picker.matches().size(), 4u);
+
+	type(picker, "bu");
+	EXPECT_EQ(picker.query(), "bu");
+	EXPECT_EQ(picker.matches().size(), 2u);
+
+	type(picker, "m");
+	ASSERT_EQ(picker.matches().size(), 1u);
+	EXPECT_EQ(picker.selected(), 1u);
+
+	picker.handle(Key{.kind = KeyKind::Backspace});
+	EXPECT_EQ(picker.query(), "bu");
+	EXPECT_EQ(picker.matches().size(), 2u);
+
+	picker.handle(Key{.kind = KeyKind::ClearQuery});
+	EXPECT_EQ(picker.query(), "");
+	EXPECT_EQ(picker.matches().size(), 4u);
+
+	// Backspace on an empty query is a no-op.
+	picker.handle(Key{.kind = KeyKind::Backspace});
+	EXPECT_EQ(picker.matches().size(), 4u);
+}
+
+TEST_F(PickerFixture, CursorAndActions) {
+	auto picker = xxlib::picker::Picker(index);
+
+	picker.handle(Key{.kind = KeyKind::Up});
+	EXPECT_EQ(picker.selected(), 0u);
+	for (auto i = 0; i < 10; ++i) {
+		picker.handle(Key{.kind = KeyKind::Down});
+	}
+	EXPECT_EQ(picker.selected(), 3u);
+	EXPECT_EQ(picker.handle(Key{.kind = KeyKind::Accept}), xxlib::picker::Action::Accept);
+
+	type(picker, "zz");
+	EXPECT_EQ(picker.selected(), std::nullopt);
+	EXPECT_EQ(picker.handle(Key{.kind = KeyKind::Accept}), xxlib::picker::Action::Continue);
+	EXPECT_EQ(picker.handle(Key{.kind = KeyKind::Cancel}), xxlib::picker::Action::Cancel);
+}
+
+TEST_F(PickerFixture, Frame) {
+	auto picker = xxlib::picker::Picker(index);
+	type(picker, "b");
+	picker.handle(Key{.kind = KeyKind::Down});
+
+	EXPECT_EQ(picker.frame(10, 80), (std::vector<std::string>{"> b", "  2/4", "  bump", "\x1b[7m> build\x1b[0m"}));
+	// Scrolls to keep the cursor visible, and truncates to the width.
+	EXPECT_EQ(picker.frame(3, 4), (std::vector<std::string>{"> b", "  2/", "\x1b[7m> bu\x1b[0m"}));
+}
+
+TEST(Picker_ScreenDiff, RewritesOnlyChangedLines) {
+	auto screen = xxlib::picker::ScreenDiff();
+
+	EXPECT_EQ(screen.render({"> ", "  2/2", "a"}, 0, 2), "\x1b[1;1H> \x1b[K\x1b[2;1H  2/2\x1b[K\x1b[3;1Ha\x1b[K\x1b[1;3H");
+	EXPECT_EQ(screen.render({"> ", "  2/2", "a"}, 0, 2), "\x1b[1;3H");
+	EXPECT_EQ(screen.render({"> b", "  1/2"}, 0, 3), "\x1b[1;1H> b\x1b[K\x1b[2;1H  1/2\x1b[K\x1b[3;1H\x1b[K\x1b[1;4H");
+}
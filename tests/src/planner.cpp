@@ -97,7 +97,7 @@ TEST(Planner_PlanSingle, PlansSingleCommand) {
 	}};
 	auto result = xxlib::planner::plan_single(commands, "test-command");
 	EXPECT_TRUE(result.has_value());
-	EXPECT_EQ(result->name, "test-command");
+	EXPECT_EQ((*result)->name, "test-command");
 }
 
 TEST(Planner_PlanSingle, FailsOnNoMatchingCommand) {
@@ -119,3 +119,113 @@ TEST(Planner_PlanSingle, FailsOnMultipleMatchingCommands) {
 	EXPECT_FALSE(result.has_value());
 	EXPECT_EQ(result.error(), "Multiple matching commands found for name: test-command");
 }
+
+TEST(Planner_ParseInvocations, SeveralAliases) {
+	using xxlib::planner::Invocation;
+
+	auto result = xxlib::planner::parse_invocations({"lint", "build[mode=release,jobs=8]", "test", "filter=Parser*", "deploy[env=prod", "region=eu]", "greet[]"});
+	ASSERT_TRUE(result.has_value()) << result.error();
+	EXPECT_EQ(*result, (std::vector<Invocation>{
+		{.name = "lint"},
+		{.name = "build", .extras = {"mode=release", "jobs=8"}},
+		{.name = "test", .extras = {"filter=Parser*"}},
+		{.name = "deploy", .extras = {"env=prod", "region=eu"}},
+		{.name = "greet"},
+	}));
+}
+
+TEST(Planner_ParseInvocations, Errors) {
+	EXPECT_EQ(xxlib::planner::parse_invocations({"mode=release", "build"}).error(), "Expected a command name before 'mode=release'");
+	EXPECT_EQ(xxlib::planner::parse_invocations({"[x]"}).error(), "Expected a command name before '[x]'");
+	EXPECT_EQ(xxlib::planner::parse_invocations({"build[mode=release", "test"}).error(), "Missing ']' after the arguments of 'build'");
+}
+
+TEST(Planner_PlanAll, PlansEveryInvocationBeforeRunning) {
+	const auto registry = xxlib::CommandRegistry(std::vector<Command>{{.name = "lint"}, {.name = "build"}, {.name = "test"}});
+
+	auto planned = xxlib::planner::plan_all(registry, {{.name = "lint"}, {.name = "build"}, {.name = "test"}});
+	ASSERT_TRUE(planned.has_value()) << planned.error();
+	ASSERT_EQ(planned->size(), 3u);
+	EXPECT_EQ((*planned)[0]->name, "lint");
+	EXPECT_EQ((*planned)[1]->name, "build");
+	EXPECT_EQ((*planned)[2]->name, "test");
+
+	auto failed = xxlib::planner::plan_all(registry, {{.name = "lint"}, {.name = "tset"}});
+	ASSERT_FALSE(failed.has_value());
+	EXPECT_EQ(failed.error(), "No command is named 'tset'. When running several commands, name each one exactly and pass positional arguments after --; did you mean: test?");
+}
+
+TEST(Planner_PlanAll, OnlyASingleNameIsAbbreviated) {
+	const auto registry = xxlib::CommandRegistry(std::vector<Command>{{.name = "deploy"}, {.name = "production-reset"}});
+
+	auto single = xxlib::planner::plan_all(registry, {{.name = "prod"}});
+	ASSERT_TRUE(single.has_value()) << single.error();
+	EXPECT_EQ(single->front()->name, "production-reset");
+
+	// 'xx run deploy prod' used to pass prod to deploy; it must not run production-reset instead.
+	auto several = xxlib::planner::plan_all(registry, {{.name = "deploy"}, {.name = "prod"}});
+	ASSERT_FALSE(several.has_value());
+	EXPECT_EQ(several.error(), "No command is named 'prod'. When running several commands, name each one exactly and pass positional arguments after --; did you mean: production-reset?");
+}
+
+namespace {
+	std::vector<std::string> step_names(const std::vector<xxlib::planner::Step>& steps) {
+		std::vector<std::string> names;
+		for (const auto& step : steps) {
+			names.push_back(step.command->name);
+		}
+		return names;
+	}
+
+	xxlib::CommandRegistry pipeline_registry() {
+		return xxlib::CommandRegistry(std::vector<Command>{
+			{.name = "build"},
+			{.name = "test", .dependsOn = {"build"}},
+			{.name = "docs", .dependsOn = {"build"}},
+			{.name = "package", .dependsOn = {"test", "docs", "build"}},
+			{.name = "lint"},
+		});
+	}
+} // namespace
+
+TEST(Planner_PlanGraph, DiamondRunsEachAliasOnce) {
+	const auto registry = pipeline_registry();
+
+	auto steps = xxlib::planner::plan_graph(registry, {{.name = "package"}, {.name = "lint"}, {.name = "test"}});
+	ASSERT_TRUE(steps.has_value()) << steps.error();
+	EXPECT_EQ(step_names(*steps), (std::vector<std::string>{"build", "test", "docs", "package", "lint"}));
+	EXPECT_TRUE(steps->at(0).dependsOn.empty());
+	EXPECT_EQ(steps->at(1).dependsOn, (std::vector<size_t>{0}));
+	EXPECT_EQ(steps->at(2).dependsOn, (std::vector<size_t>{0}));
+	EXPECT_EQ(steps->at(3).dependsOn, (std::vector<size_t>{1, 2, 0}));
+	EXPECT_TRUE(steps->at(4).dependsOn.empty());
+}
+
+TEST(Planner_PlanGraph, ExtrasFromTheCommandLine) {
+	const auto registry = pipeline_registry();
+
+	auto steps = xxlib::planner::plan_graph(registry, {{.name = "test"}, {.name = "build", .extras = {"mode=release"}}});
+	ASSERT_TRUE(steps.has_value()) << steps.error();
+	ASSERT_EQ(step_names(*steps), (std::vector<std::string>{"build", "test"}));
+	EXPECT_EQ(steps->at(0).extras, (std::vector<std::string>{"mode=release"}));
+
+	steps = xxlib::planner::plan_graph(registry, {{.name = "test", .extras = {"filter=a"}}, {.name = "test", .extras = {"filter=b"}}});
+	ASSERT_TRUE(steps.has_value()) << steps.error();
+	ASSERT_EQ(step_names(*steps), (std::vector<std::string>{"build", "test", "test"}));
+	EXPECT_EQ(steps->at(2).extras, (std::vector<std::string>{"filter=b"}));
+	EXPECT_EQ(steps->at(2).dependsOn, (std::vector<size_t>{0}));
+}
+
+TEST(Planner_PlanGraph, Errors) {
+	const auto registry = xxlib::CommandRegistry(std::vector<Command>{
+		{.name = "a", .dependsOn = {"b"}},
+		{.name = "b", .dependsOn = {"c"}},
+		{.name = "c", .dependsOn = {"a"}},
+		{.name = "d", .dependsOn = {"missing"}},
+		{.name = "e", .dependsOn = {"e"}},
+	});
+
+	EXPECT_EQ(xxlib::planner::plan_graph(registry, {{.name = "b"}}).error(), "Dependency cycle: b -> c -> a -> b");
+	EXPECT_EQ(xxlib::planner::plan_graph(registry, {{.name = "e"}}).error(), "Dependency cycle: e -> e");
+	EXPECT_EQ(xxlib::planner::plan_graph(registry, {{.name = "d"}}).error(), "Alias 'd' depends on unknown alias 'missing'");
+}
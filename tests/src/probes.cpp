@@ -0,0 +1,148 @@
+#include "detail/command_registry.hpp"
+#include "detail/constraint.hpp"
+#include "detail/probes.hpp"
+#include "temp_dir_fixture.hpp"
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+	void set_env(const std::string& name, const std::string& value) {
+#if _WIN32
+		_putenv_s(name.c_str(), value.c_str());
+#else
+		setenv(name.c_str(), value.c_str(), 1);
+#endif
+	}
+
+	struct ProbesFixture : public TempDirFixture {
+		void SetUp() override {
+			TempDirFixture::SetUp();
+			xxlib::probes::clear();
+		}
+
+		void TearDown() override {
+			TempDirFixture::TearDown();
+			xxlib::probes::clear();
+		}
+
+		std::string touch(const std::string& name, bool executable = false) const {
+			const auto path = write_file(name, "#!/bin/sh\n");
+			if (executable) {
+				std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
+			}
+			return path;
+		}
+	};
+} // namespace
+
+TEST_F(ProbesFixture, EnvIsMemoized) {
+	set_env("XX_PROBES_TEST_VAR", "first");
+	EXPECT_EQ(xxlib::probes::env("XX_PROBES_TEST_VAR"), "first");
+
+	set_env("XX_PROBES_TEST_VAR", "second");
+	EXPECT_EQ(xxlib::probes::env("XX_PROBES_TEST_VAR"), "first");
+	EXPECT_EQ(xxlib::probes::resolved_count(), 1u);
+
+	xxlib::probes::clear();
+	EXPECT_EQ(xxlib::probes::env("XX_PROBES_TEST_VAR"), "second");
+	EXPECT_FALSE(xxlib::probes::env("XX_PROBES_TEST_UNSET_VAR").has_value());
+}
+
+TEST_F(ProbesFixture, Exists) {
+	const auto file = touch("package.json");
+
+	EXPECT_TRUE(xxlib::probes::exists(file));
+	EXPECT_TRUE(xxlib::probes::exists(root.string()));
+	EXPECT_FALSE(xxlib::probes::exists((root / "missing.json").string()));
+	EXPECT_TRUE(xxlib::probes::exists(file));
+	EXPECT_EQ(xxlib::probes::resolved_count(), 3u);
+}
+
+#ifndef _WIN32
+TEST_F(ProbesFixture, WhichSearchesPath) {
+	touch("xx-probe-tool", true);
+	touch("xx-probe-data");
+
+	const auto previousPath = xxlib::probes::env("PATH").value_or("");
+	set_env("PATH", "/nonexistent:" + root.string());
+	xxlib::probes::clear();
+
+	EXPECT_TRUE(xxlib::probes::which("xx-probe-tool"));
+	EXPECT_FALSE(xxlib::probes::which("xx-probe-data"));
+	EXPECT_FALSE(xxlib::probes::which("xx-probe-missing"));
+	EXPECT_TRUE(xxlib::probes::which((root / "xx-probe-tool").string()));
+
+	set_env("PATH", previousPath);
+}
+#endif
+
+TEST_F(ProbesFixture, DynamicConstraints) {
+	using xxlib::constraint::matches_dynamic;
+
+	set_env("XX_PROBES_TEST_CI", "true");
+	set_env("XX_PROBES_TEST_EMPTY", "");
+	const auto file = touch("Makefile");
+	const auto missing = (root / "missing").string();
+
+	EXPECT_TRUE(matches_dynamic({{"env", "XX_PROBES_TEST_CI"}}));
+	EXPECT_TRUE(matches_dynamic({{"env", "XX_PROBES_TEST_CI=true"}}));
+	EXPECT_FALSE(matches_dynamic({{"env", "XX_PROBES_TEST_CI=false"}}));
+	EXPECT_FALSE(matches_dynamic({{"env", "XX_PROBES_TEST_EMPTY"}}));
+	EXPECT_TRUE(matches_dynamic({{"not_env", "XX_PROBES_TEST_UNSET"}}));
+
+	EXPECT_TRUE(matches_dynamic({{"exists", file}}));
+	EXPECT_TRUE(matches_dynamic({{"exists", missing + "," + file}}));
+	EXPECT_FALSE(matches_dynamic({{"exists", missing}}));
+	EXPECT_FALSE(matches_dynamic({{"exists", file}, {"not_exists", file}}));
+
+	// Platform keys are left to the mask.
+	EXPECT_TRUE(matches_dynamic({{"os", "plan9"}, {"exists", file}}));
+}
+
+TEST_F(ProbesFixture, CompileMarksDynamicConstraints) {
+	std::vector<std::string> warnings;
+	const auto mask = xxlib::constraint::compile({{"os", "linux"}, {"which", "ninja"}, {"not_env", "CI"}}, warnings);
+
+	EXPECT_TRUE(warnings.empty());
+	EXPECT_EQ(mask & ~xxlib::constraint::DYNAMIC, xxlib::constraint::compile({{"os", "linux"}}));
+	EXPECT_NE(mask & xxlib::constraint::DYNAMIC, 0u);
+	EXPECT_EQ(xxlib::constraint::compile({{"exists", "package.json"}}) & ~xxlib::constraint::DYNAMIC, xxlib::constraint::ALL);
+}
+
+TEST_F(ProbesFixture, ProbeCountStaysBounded) {
+	constexpr auto ALIASES = 5000;
+	constexpr auto DISTINCT_PATHS = 10;
+	constexpr auto DISTINCT_BINARIES = 5;
+
+	std::vector<Command> commands;
+	commands.reserve(ALIASES);
+	for (auto i = 0; i < ALIASES; ++i) {
+		Command command{.name = "alias" + std::to_string(i), .cmd = {"true"}};
+		command.constraints = {
+			{"exists", (root / ("file" + std::to_string(i % DISTINCT_PATHS))).string()},
+			{"not_which", "xx-probe-binary" + std::to_string(i % DISTINCT_BINARIES)},
+			{"not_env", "XX_PROBES_TEST_UNSET"},
+		};
+		command.constraintMask = xxlib::constraint::compile(command.constraints);
+		commands.push_back(std::move(command));
+	}
+	touch("file0");
+
+	const auto registry = xxlib::CommandRegistry(std::move(commands));
+	// Nothing is probed until an alias is asked about.
+	EXPECT_EQ(xxlib::probes::resolved_count(), 0u);
+
+	size_t satisfied = 0;
+	for (size_t i = 0; i < registry.commands().size(); ++i) {
+		satisfied += registry.satisfied(i) ? 1 : 0;
+	}
+
+	EXPECT_EQ(satisfied, static_cast<size_t>(ALIASES / DISTINCT_PATHS));
+	// Aliases whose file is missing stop before the remaining probes, so this is an upper bound.
+	EXPECT_LE(xxlib::probes::resolved_count(), static_cast<size_t>(DISTINCT_PATHS + DISTINCT_BINARIES + 1));
+
+	RecordProperty("probes", static_cast<int>(xxlib::probes::resolved_count()));
+}
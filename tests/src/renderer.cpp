@@ -17,7 +17,7 @@ TEST(Renderer_StringToRenderEngine, Unknown) {
 
 TEST(Renderer_Render, InjaEngine) {
 	const auto templateStr = "echo \"{{ greeting }}, {{ target }}!\"";
-	const auto templateVars = std::unordered_map<std::string, std::string>{
+	const auto templateVars = xxlib::StringMap{
 		{"greeting", "Hello"},
 		{"target", "World"},
 	};
@@ -28,7 +28,7 @@ TEST(Renderer_Render, InjaEngine) {
 
 TEST(Renderer_Render, NoneEngine) {
 	const auto templateStr = "echo \"{{ greeting }}, {{ target }}!\"";
-	const auto templateVars = std::unordered_map<std::string, std::string>{
+	const auto templateVars = xxlib::StringMap{
 		{"greeting", "Hello"},
 		{"target", "World"},
 	};
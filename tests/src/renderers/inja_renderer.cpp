@@ -3,7 +3,7 @@
 
 TEST(InjaRenderer_Render, BasicRendering) {
 	const auto templateStr = "echo \"{{ greeting }}, {{ target }}!\"";
-	const auto templateVars = std::unordered_map<std::string, std::string>{
+	const auto templateVars = xxlib::StringMap{
 		{"greeting", "Hello"},
 		{"target", "World"},
 	};
@@ -14,7 +14,7 @@ TEST(InjaRenderer_Render, BasicRendering) {
 
 TEST(InjaRenderer_Render, MissingVariable) {
 	const auto templateStr = "echo \"{{ greeting }}, {{ target }}!\"";
-	const auto templateVars = std::unordered_map<std::string, std::string>{
+	const auto templateVars = xxlib::StringMap{
 		{"greeting", "Hello"},
 	};
 
@@ -33,7 +33,7 @@ TEST(InjaRenderer_Render, MultilineTemplate) {
 echo "Line 1: {{ line1 }}"
 echo "Line 2: {{ line2 }}"
     )";
-	const auto templateVars = std::unordered_map<std::string, std::string>{
+	const auto templateVars = xxlib::StringMap{
 		{"line1", "First"},
 		{"line2", "Second"},
 	};
@@ -49,7 +49,7 @@ echo "Line 2: Second"
 
 TEST(InjaRenderer_Render, NoVariables) {
 	const auto templateStr = "echo \"No variables\"";
-	const auto templateVars = std::unordered_map<std::string, std::string>{
+	const auto templateVars = xxlib::StringMap{
 		{"unused", "value"},
 	};
 
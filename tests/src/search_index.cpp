@@ -0,0 +1,137 @@
+#include "detail/search_index.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace {
+	std::vector<Command> sample_commands() {
+		return {
+			Command{.name = "build", .cmd = {"cmake --build build", "ninja -C build"}, .envs = {{"CC", "clang"}}},
+			Command{.name = "test", .cmd = {"ctest --output-on-failure"}, .templateVars = {{"filter", "Parser*"}}},
+			Command{.name = "deploy", .cmd = {"./deploy.sh {{ region }}"}, .templateVars = {{"region", "eu-west-1"}}, .envs = {{"AWS_PROFILE", "Prod"}}},
+			Command{.name = "Lint", .cmd = {"clang-tidy src/*.cpp"}},
+		};
+	}
+
+	std::vector<uint32_t> search(const xxlib::SearchIndex& index, std::string_view query, xxlib::SearchIndex::Options options = {}) {
+		auto result = index.search(query, options);
+		EXPECT_TRUE(result.has_value()) << result.error();
+		return result.value_or(std::vector<uint32_t>{});
+	}
+} // namespace
+
+TEST(SearchIndex_Search, Substring) {
+	const auto index = xxlib::SearchIndex(sample_commands());
+
+	EXPECT_EQ(search(index, "build"), (std::vector<uint32_t>{0}));
+	EXPECT_EQ(search(index, "clang"), (std::vector<uint32_t>{0, 3}));
+	EXPECT_EQ(search(index, "eu-west"), (std::vector<uint32_t>{2}));
+	EXPECT_EQ(search(index, "C"), (std::vector<uint32_t>{0}));
+	EXPECT_TRUE(search(index, "missing").empty());
+	EXPECT_EQ(search(index, ""), (std::vector<uint32_t>{0, 1, 2, 3}));
+}
+
+TEST(SearchIndex_Search, AllTermsMustMatch) {
+	const auto index = xxlib::SearchIndex(sample_commands());
+
+	EXPECT_EQ(search(index, "clang ninja"), (std::vector<uint32_t>{0}));
+	EXPECT_TRUE(search(index, "clang ctest").empty());
+	EXPECT_EQ(search(index, "\"--output-on failure\"").size(), 0u);
+	EXPECT_EQ(search(index, "\"ninja -C\""), (std::vector<uint32_t>{0}));
+}
+
+TEST(SearchIndex_Search, FieldPrefixes) {
+	const auto index = xxlib::SearchIndex(sample_commands());
+
+	EXPECT_EQ(search(index, "name:build"), (std::vector<uint32_t>{0}));
+	EXPECT_EQ(search(index, "cmd:clang"), (std::vector<uint32_t>{3}));
+	EXPECT_EQ(search(index, "env:clang"), (std::vector<uint32_t>{0}));
+	EXPECT_EQ(search(index, "var:region"), (std::vector<uint32_t>{2}));
+	EXPECT_EQ(search(index, "env:AWS_PROFILE=Prod"), (std::vector<uint32_t>{2}));
+	EXPECT_TRUE(search(index, "name:ninja").empty());
+}
+
+TEST(SearchIndex_Search, IgnoreCase) {
+	const auto index = xxlib::SearchIndex(sample_commands());
+
+	EXPECT_TRUE(search(index, "lint").empty());
+	EXPECT_EQ(search(index, "lint", {.ignoreCase = true}), (std::vector<uint32_t>{3}));
+	EXPECT_EQ(search(index, "name:LINT", {.ignoreCase = true}), (std::vector<uint32_t>{3}));
+	EXPECT_EQ(search(index, "prod", {.ignoreCase = true}), (std::vector<uint32_t>{2}));
+}
+
+TEST(SearchIndex_Search, Regex) {
+	const auto index = xxlib::SearchIndex(sample_commands());
+
+	EXPECT_EQ(search(index, "^(build|test)$", {.regex = true}), (std::vector<uint32_t>{0, 1}));
+	EXPECT_EQ(search(index, "^lint$", {.ignoreCase = true, .regex = true}), (std::vector<uint32_t>{3}));
+	EXPECT_EQ(search(index, "\\{\\{ *region *\\}\\}", {.regex = true}), (std::vector<uint32_t>{2}));
+
+	const auto invalid = index.search("(unclosed", {.regex = true});
+	ASSERT_FALSE(invalid.has_value());
+	EXPECT_NE(invalid.error().find("Invalid regular expression"), std::string::npos);
+}
+
+TEST(SearchIndex_Search, UnterminatedQuote) {
+	const auto index = xxlib::SearchIndex(sample_commands());
+
+	const auto result = index.search("\"ninja", {});
+	ASSERT_FALSE(result.has_value());
+	EXPECT_NE(result.error().find("Unterminated quote"), std::string::npos);
+}
+
+TEST(SearchIndex_Search, MatchesLinearScan) {
+	std::vector<Command> commands;
+	for (auto i = 0; i < 3000; ++i) {
+		commands.push_back(Command{
+			.name = "svc" + std::to_string(i % 97) + "-task" + std::to_string(i),
+			.cmd = {"run --shard " + std::to_string(i * 31 % 1000)},
+			.envs = {{"REGION", i % 3 == 0 ? "us-east" : "eu-west"}},
+		});
+	}
+	const auto index = xxlib::SearchIndex(commands);
+
+	for (const auto* query : {"svc12-", "shard 99", "task1", "us-east", "eu-west task2", "svc5 shard 1"}) {
+		std::vector<uint32_t> expected;
+		for (size_t i = 0; i < commands.size(); ++i) {
+			const auto haystack = commands[i].name + "\n" + commands[i].cmd[0] + "\nREGION=" + commands[i].envs.at("REGION");
+			std::string_view terms = query;
+			auto all = true;
+			while (!terms.empty()) {
+				const auto space = terms.find(' ');
+				all = all && haystack.find(terms.substr(0, space)) != std::string::npos;
+				terms = space == std::string_view::npos ? std::string_view{} : terms.substr(space + 1);
+			}
+			if (all) {
+				expected.push_back(static_cast<uint32_t>(i));
+			}
+		}
+		EXPECT_EQ(search(index, query), expected) << query;
+	}
+}
+
+TEST(SearchIndex_Search, DISABLED_Benchmark) {
+	std::vector<Command> commands;
+	for (auto i = 0; i < 5000; ++i) {
+		commands.push_back(Command{
+			.name = "project-" + std::to_string(i / 100) + "-task-" + std::to_string(i % 100),
+			.cmd = {"make -C project" + std::to_string(i / 100) + " task" + std::to_string(i % 100), "echo done"},
+			.templateVars = {{"mode", "debug"}},
+		});
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	const auto index = xxlib::SearchIndex(commands);
+	const auto buildMicros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	const auto found = search(index, "project42 task7");
+	const auto queryMicros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+	EXPECT_EQ(found.size(), 11u);
+	RecordProperty("build_us", static_cast<int>(buildMicros));
+	RecordProperty("query_us", static_cast<int>(queryMicros));
+	// A query answered from the postings, not by scanning 5000 commands.
+	EXPECT_LT(queryMicros, 10000);
+}
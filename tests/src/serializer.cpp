@@ -0,0 +1,95 @@
+#include "detail/serializer.hpp"
+#include <gtest/gtest.h>
+
+TEST(Serializer_Primitives, RoundTrip) {
+	xxlib::serializer::Writer writer;
+	writer.u8(7);
+	writer.u32(0xdeadbeef);
+	writer.u64(0x0123456789abcdefULL);
+	writer.i64(-42);
+	writer.str("hello");
+
+	auto reader = xxlib::serializer::Reader{.data = writer.buffer};
+	EXPECT_EQ(reader.u8(), 7);
+	EXPECT_EQ(reader.u32(), 0xdeadbeef);
+	EXPECT_EQ(reader.u64(), 0x0123456789abcdefULL);
+	EXPECT_EQ(reader.i64(), -42);
+	EXPECT_EQ(reader.str(), "hello");
+	EXPECT_TRUE(reader.ok);
+	EXPECT_EQ(reader.remaining(), 0u);
+}
+
+TEST(Serializer_Primitives, ReadPastEnd) {
+	xxlib::serializer::Writer writer;
+	writer.u8(1);
+
+	auto reader = xxlib::serializer::Reader{.data = writer.buffer};
+	EXPECT_EQ(reader.u32(), 0u);
+	EXPECT_FALSE(reader.ok);
+}
+
+TEST(Serializer_Commands, RoundTrip) {
+	const auto commands = std::vector<Command>{
+		{
+			.name = "build",
+			.cmd = {"cmake", "--build", "{{ dir }}"},
+			.templateVars = {{"dir", "build"}},
+			.envs = {{"CC", "clang"}},
+			.constraints = {{"osfamily", "unix"}},
+			.dependsOn = {"configure", "generate"},
+			.inputs = {"src/**/*.cpp", "CMakeLists.txt"},
+			.outputs = {"build/xx"},
+			.cacheEnv = {"CFLAGS"},
+			.renderEngine = xxlib::renderer::Engine::Inja,
+			.executionEngine = xxlib::executor::Engine::System,
+			.requiresConfirmation = true,
+			.cacheResults = true,
+		},
+		{
+			.name = "lua",
+			.cmd = {"return 0"},
+			.executionEngine = xxlib::executor::Engine::Lua,
+			.userScope = true,
+		},
+	};
+
+	xxlib::serializer::Writer writer;
+	xxlib::serializer::write_commands(writer, commands);
+
+	auto reader = xxlib::serializer::Reader{.data = writer.buffer};
+	auto result = xxlib::serializer::read_commands(reader);
+	ASSERT_TRUE(result.has_value()) << result.error();
+	ASSERT_EQ(result->size(), 2u);
+
+	const auto& build = result->at(0);
+	EXPECT_EQ(build.name, "build");
+	EXPECT_EQ(build.cmd, commands[0].cmd);
+	EXPECT_EQ(build.templateVars, commands[0].templateVars);
+	EXPECT_EQ(build.envs, commands[0].envs);
+	EXPECT_EQ(build.constraints, commands[0].constraints);
+	EXPECT_EQ(build.dependsOn, commands[0].dependsOn);
+	EXPECT_EQ(build.inputs, commands[0].inputs);
+	EXPECT_EQ(build.outputs, commands[0].outputs);
+	EXPECT_EQ(build.cacheEnv, commands[0].cacheEnv);
+	EXPECT_EQ(build.renderEngine, xxlib::renderer::Engine::Inja);
+	EXPECT_TRUE(build.requiresConfirmation);
+	EXPECT_TRUE(build.cacheResults);
+	EXPECT_FALSE(build.userScope);
+
+	const auto& lua = result->at(1);
+	EXPECT_EQ(lua.name, "lua");
+	EXPECT_EQ(lua.executionEngine, xxlib::executor::Engine::Lua);
+	EXPECT_TRUE(lua.userScope);
+}
+
+TEST(Serializer_Commands, TruncatedData) {
+	const auto commands = std::vector<Command>{{.name = "build", .cmd = {"make"}}};
+
+	xxlib::serializer::Writer writer;
+	xxlib::serializer::write_commands(writer, commands);
+	writer.buffer.resize(writer.buffer.size() - 3);
+
+	auto reader = xxlib::serializer::Reader{.data = writer.buffer};
+	auto result = xxlib::serializer::read_commands(reader);
+	EXPECT_FALSE(result.has_value());
+}
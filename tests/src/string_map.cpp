@@ -0,0 +1,58 @@
+#include "detail/string_map.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+TEST(StringMap_Emplace, KeepsKeysSorted) {
+	xxlib::StringMap map;
+	map.emplace("b", "2");
+	map.emplace("c", "3");
+	map.emplace("a", "1");
+
+	std::string keys;
+	for (const auto& [key, value] : map) {
+		keys += key;
+	}
+	EXPECT_EQ(keys, "abc");
+}
+
+TEST(StringMap_Emplace, DoesNotOverwrite) {
+	xxlib::StringMap map{{"key", "first"}};
+	const auto [it, inserted] = map.emplace("key", "second");
+
+	EXPECT_FALSE(inserted);
+	EXPECT_EQ(it->second, "first");
+	EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(StringMap_Find, FindsExistingKeys) {
+	const xxlib::StringMap map{{"greeting", "Hello"}, {"target", "World"}};
+
+	EXPECT_NE(map.find("greeting"), map.end());
+	EXPECT_EQ(map.find("missing"), map.end());
+	EXPECT_TRUE(map.contains("target"));
+	EXPECT_EQ(map.at("target"), "World");
+	EXPECT_THROW((void)map.at("missing"), std::out_of_range);
+}
+
+TEST(StringMap_Subscript, InsertsOrAssigns) {
+	xxlib::StringMap map{{"a", "1"}};
+	map["a"] = "one";
+	map["b"] = "two";
+
+	EXPECT_EQ(map.at("a"), "one");
+	EXPECT_EQ(map.at("b"), "two");
+	EXPECT_EQ(map.size(), 2u);
+}
+
+TEST(StringMap_Equality, IgnoresInsertionOrder) {
+	xxlib::StringMap left;
+	left.emplace("x", "1");
+	left.emplace("y", "2");
+
+	xxlib::StringMap right;
+	right.emplace("y", "2");
+	right.emplace("x", "1");
+
+	EXPECT_EQ(left, right);
+}
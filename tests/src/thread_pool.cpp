@@ -0,0 +1,83 @@
+#include "detail/thread_pool.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST(ThreadPool_Submit, ReturnsResults) {
+	xxlib::ThreadPool pool(4);
+	EXPECT_EQ(pool.size(), 4u);
+
+	std::vector<std::future<int>> futures;
+	for (auto i = 0; i < 32; ++i) {
+		futures.emplace_back(pool.submit([i]() {
+			return i * i;
+		}));
+	}
+
+	for (auto i = 0; i < 32; ++i) {
+		EXPECT_EQ(futures[i].get(), i * i);
+	}
+}
+
+TEST(ThreadPool_Destructor, DrainsPendingJobs) {
+	std::atomic<int> counter = 0;
+	{
+		xxlib::ThreadPool pool(2);
+		for (auto i = 0; i < 100; ++i) {
+			auto _ = pool.submit([&counter]() {
+				++counter;
+			});
+		}
+	}
+	EXPECT_EQ(counter.load(), 100);
+}
+
+TEST(WorkStealingPool_Submit, DrainsNestedJobs) {
+	std::atomic<int> counter = 0;
+	xxlib::WorkStealingPool* running = nullptr;
+	// Every job fans out into two more until the tree is 10 levels deep.
+	std::function<void(int)> spread = [&](int depth) {
+		++counter;
+		if (depth < 10) {
+			running->submit([&spread, depth]() {
+				spread(depth + 1);
+			});
+			running->submit([&spread, depth]() {
+				spread(depth + 1);
+			});
+		}
+	};
+	{
+		xxlib::WorkStealingPool pool(4);
+		EXPECT_EQ(pool.size(), 4u);
+		running = &pool;
+		pool.submit([&spread]() {
+			spread(1);
+		});
+	}
+	EXPECT_EQ(counter.load(), (1 << 10) - 1);
+}
+
+TEST(WorkStealingPool_Submit, IdleWorkersSteal) {
+	std::mutex mutex;
+	std::set<std::thread::id> threads;
+	{
+		xxlib::WorkStealingPool pool(4);
+		// All jobs land in the queue of the worker running the first one, so the other workers can only steal them.
+		pool.submit([&]() {
+			for (auto i = 0; i < 16; ++i) {
+				pool.submit([&]() {
+					std::this_thread::sleep_for(std::chrono::milliseconds(10));
+					std::lock_guard lock(mutex);
+					threads.insert(std::this_thread::get_id());
+				});
+			}
+		});
+	}
+	EXPECT_GT(threads.size(), 1u);
+}
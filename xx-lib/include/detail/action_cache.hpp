@@ -0,0 +1,97 @@
+#ifndef XX_ACTION_CACHE_HPP
+#define XX_ACTION_CACHE_HPP
+
+#include "detail/command.hpp"
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace xxlib::action_cache {
+	constexpr uint32_t MAGIC = 0x41585858; // "XXXA"
+	constexpr uint32_t FORMAT_VERSION = 1;
+	constexpr uint64_t DEFAULT_MAX_SIZE = 1ULL << 30;
+
+	struct OutputFile {
+		// Relative to the directory the alias ran in, with '/' separators.
+		std::string path{};
+		// Hex SHA-256 of the content, which names its blob in the store.
+		std::string digest{};
+		uint64_t size = 0;
+		uint32_t permissions = 0;
+
+		bool operator==(const OutputFile& other) const = default;
+	};
+
+	struct Entry {
+		int32_t exitCode = 0;
+		// Everything the alias printed, stdout and stderr interleaved.
+		std::string log{};
+		std::vector<OutputFile> outputs{};
+	};
+
+	// Entries are stored under their action key, blobs under the digest of their content.
+	enum class Kind { Action, Blob };
+
+	// Name of the namespace a kind is stored in, "ac" or "cas" as in Bazel's remote cache.
+	[[nodiscard]] std::string kind_to_string(Kind kind);
+
+	// Storage behind the action cache. Calls may come from several threads at once.
+	class Backend {
+	  public:
+		virtual ~Backend() = default;
+
+		// Nothing when the backend does not have key.
+		[[nodiscard]] virtual std::expected<std::optional<std::string>, std::string> get(Kind kind, const std::string& key) = 0;
+		[[nodiscard]] virtual std::expected<void, std::string> put(Kind kind, const std::string& key, std::string_view data) = 0;
+		[[nodiscard]] virtual bool contains(Kind kind, const std::string& key) = 0;
+		// False once the backend has given up, so callers can run without it instead of collecting errors.
+		[[nodiscard]] virtual bool available() const {
+			return true;
+		}
+	};
+
+	// The results of an alias, read right after it finished so it can be sent while the next one runs.
+	struct Upload {
+		std::string key{};
+		Entry entry{};
+		// Digest and content of every distinct output.
+		std::vector<std::pair<std::string, std::string>> blobs{};
+	};
+
+	[[nodiscard]] bool is_digest(std::string_view text);
+
+	// Hex SHA-256 over the alias as it would run (commands, variables, env, engines and extra arguments), the values of
+	// PATH and the inherited variables listed in cache_env, the platform, and the path and content of every input.
+	// Fails when an input cannot be read.
+	[[nodiscard]] std::expected<std::string, std::string> action_key(const Command& command, const std::vector<std::string>& extras, const std::filesystem::path& base);
+
+	[[nodiscard]] std::expected<Entry, std::string> lookup(Backend& backend, const std::string& key);
+	// Downloads the outputs of entry in parallel, and writes them below base, each replaced atomically, once all of
+	// them have arrived.
+	[[nodiscard]] std::expected<void, std::string> restore(Backend& backend, const std::filesystem::path& base, const Entry& entry);
+
+	// Reads the files matching outputPatterns into an upload of entry. Every pattern has to match a file.
+	[[nodiscard]] std::expected<Upload, std::string> prepare(const std::filesystem::path& base, const std::string& key, Entry entry, const std::vector<std::string>& outputPatterns);
+	// Sends the blobs the backend does not have yet in parallel, then the entry, so an entry never refers to a blob
+	// that is not there.
+	[[nodiscard]] std::expected<void, std::string> upload(Backend& backend, const Upload& upload);
+	// prepare followed by upload.
+	[[nodiscard]] std::expected<void, std::string> store(Backend& backend, const std::filesystem::path& base, const std::string& key, Entry entry, const std::vector<std::string>& outputPatterns);
+
+	struct Eviction {
+		uint64_t removed = 0;
+		// Bytes left below the directory afterwards.
+		uint64_t remaining = 0;
+	};
+
+	// Once the files below directory take more than maxSize, removes the least recently used ones until they take
+	// three quarters of it. Walks the whole directory, so callers should not run it for every write.
+	Eviction evict(const std::string& directory, uint64_t maxSize);
+} // namespace xxlib::action_cache
+
+#endif // XX_ACTION_CACHE_HPP
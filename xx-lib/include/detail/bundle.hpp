@@ -0,0 +1,29 @@
+#ifndef XX_BUNDLE_HPP
+#define XX_BUNDLE_HPP
+
+#include "detail/command.hpp"
+#include "detail/mapped_file.hpp"
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace xxlib::bundle {
+	constexpr uint32_t MAGIC = 0x42585858; // "XXXB"
+	constexpr uint32_t FORMAT_VERSION = 7;
+
+	struct Bundle {
+		xxlib::MappedFile file{};
+		std::vector<Command> commands{};
+		// Precompiled Lua chunk of each command, viewing into file; empty when the command has none.
+		std::vector<std::string_view> luaChunks{};
+	};
+
+	// Writes fully resolved commands, with Lua bytecode for Lua aliases that need no template rendering.
+	[[nodiscard]] std::expected<void, std::string> write(const std::string& path, const std::vector<Command>& commands);
+	// Maps a bundle written by the same xx version.
+	[[nodiscard]] std::expected<Bundle, std::string> load(const std::string& path);
+} // namespace xxlib::bundle
+
+#endif // XX_BUNDLE_HPP
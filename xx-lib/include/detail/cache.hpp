@@ -0,0 +1,37 @@
+#ifndef XX_CACHE_HPP
+#define XX_CACHE_HPP
+
+#include "detail/command.hpp"
+#include "detail/parser.hpp"
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace xxlib::cache {
+	constexpr uint32_t MAGIC = 0x43585858; // "XXXC"
+	constexpr uint32_t FORMAT_VERSION = 9;
+
+	struct SourceStamp {
+		std::string path{};
+		uint64_t size = 0;
+		int64_t mtime = 0;
+		uint64_t hash = 0;
+	};
+
+	[[nodiscard]] std::string default_directory();
+	[[nodiscard]] std::string entry_path(const std::string& cacheDirectory, const std::string& sourcePath);
+	// Replaces path through a temporary sibling and a rename, creating parent directories as needed.
+	[[nodiscard]] std::expected<void, std::string> write_atomic(const std::string& path, std::string_view data);
+
+	// Path, size and modification time only; the content hash is left at zero.
+	[[nodiscard]] std::expected<SourceStamp, std::string> stat_source(const std::string& sourcePath);
+	[[nodiscard]] std::expected<SourceStamp, std::string> make_stamp(const std::string& sourcePath, std::string_view content);
+	[[nodiscard]] std::expected<xxlib::parser::Document, std::string> load(const std::string& entryPath, const SourceStamp& stamp);
+	[[nodiscard]] std::expected<void, std::string> store(const std::string& entryPath, const SourceStamp& stamp, const xxlib::parser::Document& document);
+
+	[[nodiscard]] std::expected<xxlib::parser::Document, std::string> parse_cached(const std::string& sourcePath, std::string_view buffer, const std::string& cacheDirectory, xxlib::parser::Backend backend = xxlib::parser::Backend::Events);
+} // namespace xxlib::cache
+
+#endif // XX_CACHE_HPP
@@ -0,0 +1,36 @@
+#ifndef XX_DISK_BACKEND_HPP
+#define XX_DISK_BACKEND_HPP
+
+#include "detail/action_cache.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace xxlib::action_cache {
+	// Keeps entries and blobs as files below a directory. Reads count as uses, and once the directory grows past
+	// maxSize the least recently used files are evicted. The size is tracked in a small file next to them, so only
+	// crossing the limit walks the directory.
+	class DiskBackend : public Backend {
+	  public:
+		explicit DiskBackend(std::string directory, uint64_t maxSize = DEFAULT_MAX_SIZE);
+
+		[[nodiscard]] std::expected<std::optional<std::string>, std::string> get(Kind kind, const std::string& key) override;
+		[[nodiscard]] std::expected<void, std::string> put(Kind kind, const std::string& key, std::string_view data) override;
+		[[nodiscard]] bool contains(Kind kind, const std::string& key) override;
+
+	  private:
+		[[nodiscard]] std::filesystem::path path_of(Kind kind, const std::string& key) const;
+		[[nodiscard]] std::optional<uint64_t> read_size() const;
+		void account(uint64_t bytes, bool record);
+
+		std::string directory;
+		uint64_t maxSize;
+		std::mutex sizeMutex{};
+		// Bytes written since the size file was last updated.
+		uint64_t unrecorded = 0;
+	};
+} // namespace xxlib::action_cache
+
+#endif // XX_DISK_BACKEND_HPP
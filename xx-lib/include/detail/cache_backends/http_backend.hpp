@@ -0,0 +1,36 @@
+#ifndef XX_HTTP_BACKEND_HPP
+#define XX_HTTP_BACKEND_HPP
+
+#include "detail/action_cache.hpp"
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace xxlib::action_cache {
+	// Remote store with the layout of Bazel's HTTP cache: GET, HEAD and PUT of <url>/ac/<key> and <url>/cas/<digest>.
+	// Once the server cannot be reached it is not tried again, so an offline remote costs one connect timeout per
+	// process and every later call fails straight away.
+	class HttpBackend : public Backend {
+	  public:
+		static constexpr std::chrono::milliseconds DEFAULT_TIMEOUT{30000};
+		static constexpr std::chrono::milliseconds DEFAULT_CONNECT_TIMEOUT{1000};
+
+		explicit HttpBackend(std::string url, std::chrono::milliseconds timeout = DEFAULT_TIMEOUT, std::chrono::milliseconds connectTimeout = DEFAULT_CONNECT_TIMEOUT);
+
+		[[nodiscard]] std::expected<std::optional<std::string>, std::string> get(Kind kind, const std::string& key) override;
+		[[nodiscard]] std::expected<void, std::string> put(Kind kind, const std::string& key, std::string_view data) override;
+		[[nodiscard]] bool contains(Kind kind, const std::string& key) override;
+		[[nodiscard]] bool available() const override;
+
+	  private:
+		[[nodiscard]] std::string url_of(Kind kind, const std::string& key) const;
+		std::string unreachable(const std::string& reason);
+
+		std::string url;
+		std::chrono::milliseconds timeout;
+		std::chrono::milliseconds connectTimeout;
+		std::atomic<bool> unavailable = false;
+	};
+} // namespace xxlib::action_cache
+
+#endif // XX_HTTP_BACKEND_HPP
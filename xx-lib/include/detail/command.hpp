@@ -1,34 +1,67 @@
 #ifndef XX_COMMAND_HPP
 #define XX_COMMAND_HPP
 
+#include "detail/constraint.hpp"
 #include "detail/renderer.hpp"
 #include "detail/executor.hpp"
+#include "detail/string_map.hpp"
+#include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
+
+namespace xxlib::action_cache {
+	class Backend;
+} // namespace xxlib::action_cache
 
 struct Command {
 	std::string name{};
 	std::vector<std::string> cmd{};
-	std::unordered_map<std::string, std::string> templateVars{};
-	std::unordered_map<std::string, std::string> envs{};
+	xxlib::StringMap templateVars{};
+	xxlib::StringMap envs{};
 	std::vector<std::pair<std::string, std::string>> constraints{};
+	// Compiled form of constraints, filled in by the parser.
+	xxlib::constraint::Mask constraintMask = xxlib::constraint::NOT_COMPILED;
+	// Names of aliases that have to succeed before this one runs.
+	std::vector<std::string> dependsOn{};
+	// Glob patterns of the files the alias reads and writes; together they let an unchanged alias be skipped.
+	std::vector<std::string> inputs{};
+	std::vector<std::string> outputs{};
+	// Inherited environment variables, besides PATH, that change what a cached alias produces.
+	std::vector<std::string> cacheEnv{};
 
 	xxlib::renderer::Engine renderEngine = xxlib::renderer::Engine::None;
 	xxlib::executor::Engine executionEngine = xxlib::executor::Engine::System;
 
 	bool requiresConfirmation = false;
+	// The alias always produces the same outputs from the same inputs, so its results can be reused.
+	bool cacheResults = false;
 
 	bool userScope = false;
+
+	bool operator==(const Command& other) const = default;
 };
 
 struct CommandContext {
 	bool dryRun = false;
 	std::vector<std::string> extras{};
+	// Precompiled Lua chunk from a bundle; the executor falls back to the source when it cannot be loaded.
+	std::string_view luaBytecode{};
+	// When set, everything the command prints is handed here in chunks instead of going to the terminal.
+	std::function<void(std::string_view)> output{};
+	// Where the state of aliases with inputs or outputs is kept between runs; when empty they always run.
+	std::string stateDirectory{};
+	// Compares inputs by content instead of modification time, for checkouts that reset modification times.
+	bool hashInputs = false;
+	// Runs aliases even when they are up to date.
+	bool force = false;
+	// Content-addressed store of the results of aliases with cacheResults; when unset they always run.
+	std::shared_ptr<xxlib::action_cache::Backend> actionCache{};
 };
 
 namespace xxlib::command {
-	[[nodiscard]] std::string render(const std::string& templateStr, const std::unordered_map<std::string, std::string>& templateVars, xxlib::renderer::Engine renderEngine);
+	[[nodiscard]] std::string render(const std::string& templateStr, const xxlib::StringMap& templateVars, xxlib::renderer::Engine renderEngine);
 	[[nodiscard]] std::string join_cmd(const Command& command);
 	[[nodiscard]] std::string join_constraints(const Command& command);
 } // namespace xxlib::command
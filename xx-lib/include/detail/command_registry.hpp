@@ -0,0 +1,58 @@
+#ifndef XX_COMMAND_REGISTRY_HPP
+#define XX_COMMAND_REGISTRY_HPP
+
+#include "detail/command.hpp"
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace xxlib {
+	// Loaded commands indexed by name. The index is an open-addressing table built once, and the constraints of a
+	// command are evaluated the first time it is asked about, so lookups cost the same no matter how many aliases are
+	// loaded and only the candidates of a name ever run probes.
+	// Distinct names are also kept sorted by name for prefix queries and by length for typo suggestions.
+	class CommandRegistry {
+	  public:
+		CommandRegistry() = default;
+		explicit CommandRegistry(std::vector<Command> commands);
+
+		[[nodiscard]] const std::vector<Command>& commands() const;
+		// Indices into commands() of every command with this name, in load order.
+		[[nodiscard]] std::span<const uint32_t> candidates(std::string_view name) const;
+		// Whether the constraints of commands()[index] hold on the current platform. Evaluated on first use, so calls
+		// must not race.
+		[[nodiscard]] bool satisfied(size_t index) const;
+
+		// Distinct names starting with prefix, sorted.
+		[[nodiscard]] std::vector<std::string_view> names_with_prefix(std::string_view prefix) const;
+		// Up to limit distinct names within maxDistance edits of name, closest first.
+		[[nodiscard]] std::vector<std::string_view> suggestions(std::string_view name, size_t maxDistance = 2, size_t limit = 3) const;
+
+	  private:
+		struct Slot {
+			uint64_t hash = 0;
+			// First command with this name, used to compare names on lookup.
+			uint32_t first = 0;
+			// Position of the candidates in order.
+			uint32_t begin = 0;
+			// Zero marks an empty slot.
+			uint32_t count = 0;
+		};
+
+		enum class Satisfied : uint8_t { Unknown, No, Yes };
+
+		[[nodiscard]] size_t find_slot(std::string_view name, uint64_t hash) const;
+
+		std::vector<Command> commandList{};
+		std::vector<uint32_t> order{};
+		std::vector<Slot> slots{};
+		mutable std::vector<Satisfied> satisfiedStates{};
+		// First command of every distinct name, ordered by name.
+		std::vector<uint32_t> sortedNames{};
+		// The same, ordered by name length, so suggestions only compare names of a plausible length.
+		std::vector<uint32_t> namesByLength{};
+	};
+} // namespace xxlib
+
+#endif // XX_COMMAND_REGISTRY_HPP
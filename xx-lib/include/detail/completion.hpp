@@ -0,0 +1,45 @@
+#ifndef XX_COMPLETION_HPP
+#define XX_COMPLETION_HPP
+
+#include "detail/cache.hpp"
+#include "detail/command.hpp"
+#include "detail/constraint.hpp"
+#include "detail/parser.hpp"
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace xxlib::completion {
+	constexpr uint32_t MAGIC = 0x4e585858; // "XXXN"
+
+	enum class Shell { Bash, Zsh, Fish };
+	[[nodiscard]] Shell string_to_shell(const std::string& shell);
+
+	// What shell completion needs to know about an alias.
+	struct Entry {
+		std::string name{};
+		xxlib::constraint::Mask constraintMask = xxlib::constraint::NOT_COMPILED;
+		std::vector<std::string> templateVars{};
+	};
+
+	[[nodiscard]] std::vector<Entry> entries_of(const std::vector<Command>& commands);
+
+	// The name index is a small sidecar of a cache entry, so completion can answer without parsing YAML or
+	// decoding whole commands. It is validated by file size and modification time only.
+	[[nodiscard]] std::string index_path(const std::string& cacheEntryPath);
+	[[nodiscard]] std::expected<void, std::string> write_index(const std::string& cacheEntryPath, const xxlib::cache::SourceStamp& stamp, const xxlib::parser::Document& document);
+	// Entries of the given files and of everything they include. Files that do not exist are skipped; a missing
+	// or stale index fails the whole read so the caller can fall back to loading the configuration.
+	[[nodiscard]] std::expected<std::vector<Entry>, std::string> read_indexed(const std::vector<std::string>& paths, const std::string& cacheDirectory);
+
+	// words are the arguments typed after 'run', the last one being the word to complete: alias names for the
+	// first word, then "key=" for the template variables of the latest alias and, once typing has started, further
+	// alias names. Options are ignored.
+	[[nodiscard]] std::vector<std::string> complete(const std::vector<Entry>& entries, const std::vector<std::string>& words);
+
+	[[nodiscard]] std::string_view script(Shell shell);
+} // namespace xxlib::completion
+
+#endif // XX_COMPLETION_HPP
@@ -0,0 +1,51 @@
+#ifndef XX_CONSTRAINT_HPP
+#define XX_CONSTRAINT_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace xxlib::constraint {
+	// One bit per OS, architecture and OS family. A compiled constraint set keeps the allowed values of each
+	// dimension; the host sets exactly one bit per dimension, so a command matches when all host bits are allowed.
+	using Mask = uint32_t;
+
+	constexpr Mask OS_WINDOWS = 1u << 0;
+	constexpr Mask OS_MACOS = 1u << 1;
+	constexpr Mask OS_LINUX = 1u << 2;
+	constexpr Mask OS_ALL = OS_WINDOWS | OS_MACOS | OS_LINUX;
+
+	constexpr Mask ARCH_X86_64 = 1u << 3;
+	constexpr Mask ARCH_ARM64 = 1u << 4;
+	constexpr Mask ARCH_ALL = ARCH_X86_64 | ARCH_ARM64;
+
+	constexpr Mask FAMILY_WINDOWS = 1u << 5;
+	constexpr Mask FAMILY_UNIX = 1u << 6;
+	constexpr Mask FAMILY_ALL = FAMILY_WINDOWS | FAMILY_UNIX;
+
+	constexpr Mask ALL = OS_ALL | ARCH_ALL | FAMILY_ALL;
+	// Set when the constraints include env, exists or which probes, which are checked by matches_dynamic.
+	constexpr Mask DYNAMIC = 1u << 30;
+	// Never contains a host bit, for constraint sets with unknown keys.
+	constexpr Mask UNSATISFIABLE = 1u << 31;
+	// Default of Command::constraintMask for commands that were not built by the parser.
+	constexpr Mask NOT_COMPILED = 0;
+
+	// Values may list alternatives separated by commas ("linux,macos"), and a "not_" key prefix negates the
+	// constraint. Problems such as unknown keys or values are appended to warnings. The env, exists and which
+	// keys only set DYNAMIC, as their outcome depends on the environment the alias is run in.
+	[[nodiscard]] Mask compile(const std::vector<std::pair<std::string, std::string>>& constraints, std::vector<std::string>& warnings);
+	[[nodiscard]] Mask compile(const std::vector<std::pair<std::string, std::string>>& constraints);
+
+	// Computed once per process.
+	[[nodiscard]] Mask host_mask();
+	[[nodiscard]] inline bool matches(Mask mask) {
+		const auto host = host_mask();
+		return (mask & host) == host;
+	}
+	// Evaluates the env ("NAME" or "NAME=value"), exists and which constraints through the memoized probes.
+	[[nodiscard]] bool matches_dynamic(const std::vector<std::pair<std::string, std::string>>& constraints);
+} // namespace xxlib::constraint
+
+#endif // XX_CONSTRAINT_HPP
@@ -0,0 +1,26 @@
+#ifndef XX_DISCOVERY_HPP
+#define XX_DISCOVERY_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xxlib::discovery {
+	constexpr uint32_t MAGIC = 0x44585858; // "XXXD"
+	constexpr uint32_t FORMAT_VERSION = 1;
+	constexpr size_t MAX_CACHED_LOOKUPS = 64;
+
+	struct Lookup {
+		// Config files from the start directory upwards, closest first.
+		std::vector<std::string> configs{};
+		// Every directory that was inspected, with its mtime at the time of the walk.
+		std::vector<std::pair<std::string, int64_t>> directories{};
+	};
+
+	// Walks from startDirectory to the filesystem root looking for configFile; stops at the first match when firstOnly is set.
+	[[nodiscard]] Lookup find_configs(const std::string& startDirectory, const std::string& configFile, bool firstOnly);
+	// Same as find_configs, but reuses a previous walk from the same directory while none of the inspected directories changed.
+	[[nodiscard]] std::vector<std::string> find_configs_cached(const std::string& startDirectory, const std::string& configFile, bool firstOnly, const std::string& cacheDirectory);
+} // namespace xxlib::discovery
+
+#endif // XX_DISCOVERY_HPP
@@ -16,8 +16,11 @@ namespace xxlib::executor {
 	};
 
 	[[nodiscard]] Engine string_to_execution_engine(const std::string& executorStr);
+	[[nodiscard]] std::string execution_engine_to_string(Engine executionEngine);
 
 	[[nodiscard]] std::expected<int32_t, std::string> execute_command(Command& command, CommandContext& context);
+	// Results of cached aliases are sent to the action cache in the background; this waits until all of them are.
+	void wait_for_uploads();
 } // namespace xxlib::executor
 
 #endif // XX_EXECUTOR_HPP
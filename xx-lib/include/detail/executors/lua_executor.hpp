@@ -10,6 +10,8 @@ class CommandContext;
 
 namespace xxlib::lua_executor {
 	[[nodiscard]] std::expected<int32_t, std::string> execute_command(Command& command, CommandContext& context);
+	// Bytecode of a command whose script needs no template rendering, so it can be stored in a bundle.
+	[[nodiscard]] std::expected<std::string, std::string> compile(const Command& command);
 } // namespace xxlib::lua_executor
 
 #endif // XX_LUA_EXECUTOR_HPP
@@ -5,9 +5,29 @@
 #include <string>
 #include <cstdint>
 #include <expected>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace xxlib::platform_executor {
 	[[nodiscard]] std::expected<int32_t, std::string> execute_command(Command& command, CommandContext& context);
+
+#ifndef _WIN32
+	// A command line the shell would only split into words: leading NAME=value assignments, then argv.
+	struct DirectCommand {
+		std::vector<std::pair<std::string, std::string>> assignments{};
+		std::vector<std::string> argv{};
+	};
+
+	// Nothing when the line uses anything the shell interprets (quotes, variables, globs, redirections, ...).
+	[[nodiscard]] std::optional<DirectCommand> parse_plain(std::string_view commandLine);
+	// Path of the program argv[0] names, or nothing when the shell has to resolve it (builtins, a PATH assignment).
+	[[nodiscard]] std::optional<std::string> find_program(const DirectCommand& direct);
+	// Runs program with posix_spawn, without a shell. Output goes to the terminal unless output is set.
+	[[nodiscard]] std::expected<int32_t, std::string> spawn(const std::string& program, const DirectCommand& direct, const std::function<void(std::string_view)>& output = {});
+#endif
 } // namespace xxlib::platform_executor
 
 #endif // XX_PLATFORM_EXECUTOR_HPP
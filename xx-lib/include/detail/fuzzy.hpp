@@ -0,0 +1,46 @@
+#ifndef XX_FUZZY_HPP
+#define XX_FUZZY_HPP
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace xxlib {
+	// Case-insensitive subsequence matching over a fixed list of names, for the interactive picker.
+	// Names are lowercased into one contiguous buffer, and each carries a 64-bit mask of the characters it
+	// contains, so most non-matches are rejected with a single AND before the name itself is read.
+	class FuzzyIndex {
+	  public:
+		struct Match {
+			uint32_t index = 0;
+			int32_t score = 0;
+		};
+
+		FuzzyIndex() = default;
+		explicit FuzzyIndex(const std::vector<std::string_view>& names);
+
+		[[nodiscard]] size_t size() const;
+		[[nodiscard]] std::string_view name(uint32_t index) const;
+
+		// Every name containing the characters of query in order, best first. Ties keep shorter names, then
+		// the original order. An empty query matches everything in order.
+		[[nodiscard]] std::vector<Match> filter(std::string_view query) const;
+		// Same, but only looks at candidates; narrowing a query can only remove matches, so the picker passes
+		// the matches of the previous query here.
+		[[nodiscard]] std::vector<Match> filter(std::string_view query, std::span<const Match> candidates) const;
+
+		// Score of query against a single lowercase name, or a negative value if it does not match.
+		[[nodiscard]] static int32_t score(std::string_view lowerName, std::string_view lowerQuery);
+
+	  private:
+		std::string buffer{};
+		std::vector<std::string_view> originals{};
+		// offsets[i] to offsets[i + 1] is the lowercase name i in buffer.
+		std::vector<uint32_t> offsets{};
+		std::vector<uint64_t> masks{};
+	};
+} // namespace xxlib
+
+#endif // XX_FUZZY_HPP
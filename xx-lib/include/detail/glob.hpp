@@ -0,0 +1,18 @@
+#ifndef XX_GLOB_HPP
+#define XX_GLOB_HPP
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace xxlib::glob {
+	[[nodiscard]] bool has_magic(std::string_view pattern);
+	// Matches a single path segment against `*`, `?` and `[...]`. Wildcards never match a leading dot.
+	[[nodiscard]] bool match(std::string_view pattern, std::string_view name);
+	// Expands a '/'-separated pattern relative to base into a sorted list of regular files.
+	// A `**` segment matches zero or more directories and does not descend into hidden ones.
+	[[nodiscard]] std::vector<std::string> expand(const std::filesystem::path& base, const std::string& pattern);
+} // namespace xxlib::glob
+
+#endif // XX_GLOB_HPP
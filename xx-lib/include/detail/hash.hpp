@@ -0,0 +1,39 @@
+#ifndef XX_HASH_HPP
+#define XX_HASH_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace xxlib::hash {
+	constexpr uint64_t FNV1A64_OFFSET = 0xcbf29ce484222325ULL;
+	constexpr uint64_t FNV1A64_PRIME = 0x100000001b3ULL;
+
+	[[nodiscard]] uint64_t fnv1a64(std::string_view data, uint64_t seed = FNV1A64_OFFSET);
+	[[nodiscard]] std::string to_hex(uint64_t value);
+
+	using Sha256Digest = std::array<uint8_t, 32>;
+
+	// Incremental SHA-256 (FIPS 180-4), for keys that have to stay stable across machines and releases.
+	class Sha256 {
+	  public:
+		void update(std::string_view data);
+		// Pads the message and returns its digest; the hasher cannot be updated afterwards.
+		[[nodiscard]] Sha256Digest finish();
+
+	  private:
+		void transform(const uint8_t* block);
+
+		std::array<uint32_t, 8> state{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+		std::array<uint8_t, 64> buffer{};
+		size_t buffered = 0;
+		uint64_t length = 0;
+	};
+
+	[[nodiscard]] Sha256Digest sha256(std::string_view data);
+	[[nodiscard]] std::string to_hex(const Sha256Digest& digest);
+} // namespace xxlib::hash
+
+#endif // XX_HASH_HPP
@@ -1,6 +1,7 @@
 #ifndef XX_HELPERS_HPP
 #define XX_HELPERS_HPP
 
+#include "detail/string_map.hpp"
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -12,8 +13,12 @@ namespace xxlib::helpers {
 	};
 
 	[[nodiscard]] bool ask_for_confirmation(const std::string& text);
+	// Reads one line from stdin after printing text; empty when stdin is closed.
+	[[nodiscard]] std::string ask_for_line(const std::string& text);
+	// Splits a line typed by the user into arguments on whitespace, keeping double-quoted parts together.
+	[[nodiscard]] std::vector<std::string> split_arguments(const std::string& line);
 	[[nodiscard]] ExtrasResult split_extras(const std::vector<std::string>& extras);
-	[[nodiscard]] std::vector<std::string> get_uset_vars(const std::unordered_map<std::string, std::string>& templateVars);
+	[[nodiscard]] std::vector<std::string> get_uset_vars(const xxlib::StringMap& templateVars);
 } // namespace xxlib::helpers
 
 #endif // XX_HELPERS_HPP
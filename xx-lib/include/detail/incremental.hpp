@@ -0,0 +1,82 @@
+#ifndef XX_INCREMENTAL_HPP
+#define XX_INCREMENTAL_HPP
+
+#include "detail/command.hpp"
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace xxlib::incremental {
+	constexpr uint32_t MAGIC = 0x53585858; // "XXXS"
+	constexpr uint32_t FORMAT_VERSION = 1;
+
+	struct FileStamp {
+		std::string path{};
+		uint64_t size = 0;
+		int64_t mtime = 0;
+		// Content hash, or zero when it has not been computed.
+		uint64_t hash = 0;
+
+		bool operator==(const FileStamp& other) const = default;
+	};
+
+	// Memoizes the size and modification time of paths. Safe to share between threads; clear it once files may
+	// have changed.
+	class StatCache {
+	  public:
+		// Nothing when path is not a regular file.
+		[[nodiscard]] std::optional<FileStamp> stat(const std::string& path);
+		void clear();
+
+	  private:
+		std::mutex mutex{};
+		std::unordered_map<std::string, std::optional<FileStamp>> entries{};
+		// Bumped by clear, so a lookup that started before it does not store what it saw.
+		uint64_t generation = 0;
+	};
+
+	// What an alias ran with last time it succeeded.
+	struct State {
+		uint64_t key = 0;
+		std::vector<FileStamp> inputs{};
+	};
+
+	struct Options {
+		std::string stateDirectory{};
+		// Directory the patterns of inputs and outputs are relative to.
+		std::filesystem::path base{};
+		bool hashContents = false;
+	};
+
+	struct Check {
+		bool upToDate = false;
+		// Why the alias has to run, for the debug log.
+		std::string reason{};
+		std::string statePath{};
+		// To be recorded once the alias has succeeded.
+		State state{};
+	};
+
+	// Identifies what an alias runs: its commands, variables, environment, engines and extra arguments.
+	[[nodiscard]] uint64_t command_key(const Command& command, const std::vector<std::string>& extras);
+	// Sorted, de-duplicated regular files matching any of the patterns.
+	[[nodiscard]] std::vector<std::string> expand_all(const std::filesystem::path& base, const std::vector<std::string>& patterns);
+	// Stamps of files, in order. Hashes are taken from previous for files whose size and modification time are
+	// unchanged, and computed for the rest only when hashContents is set. Large lists are stamped in parallel.
+	[[nodiscard]] std::vector<FileStamp> fingerprint(const std::vector<std::string>& files, bool hashContents, const std::vector<FileStamp>& previous, StatCache& stats);
+
+	[[nodiscard]] std::string state_path(const std::string& stateDirectory, const std::filesystem::path& base, const std::string& name);
+	[[nodiscard]] std::expected<State, std::string> load_state(const std::string& path);
+	[[nodiscard]] std::expected<void, std::string> store_state(const std::string& path, const State& state);
+
+	// Up to date when the alias and its inputs are unchanged since the recorded state, and every output pattern
+	// matches a file at least as new as the newest input. Modification times are not compared with hashContents.
+	[[nodiscard]] Check check(const Command& command, const std::vector<std::string>& extras, const Options& options, StatCache& stats);
+} // namespace xxlib::incremental
+
+#endif // XX_INCREMENTAL_HPP
@@ -0,0 +1,44 @@
+#ifndef XX_LISTING_HPP
+#define XX_LISTING_HPP
+
+#include "detail/command.hpp"
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace xxlib::listing {
+	enum class Format { Text, Json, Ndjson };
+	[[nodiscard]] Format string_to_format(const std::string& format);
+
+	// Appends value as a quoted JSON string.
+	void append_json_string(std::string& out, std::string_view value);
+
+	// Streams the commands of 'xx list' to out through a single buffer that is flushed whenever it fills up.
+	// JSON is written as one array, NDJSON as one object per line. Text groups unavailable commands after the
+	// available ones, so only those are held back until finish().
+	class Writer {
+	  public:
+		Writer(std::FILE* out, Format format);
+		~Writer();
+
+		Writer(const Writer&) = delete;
+		Writer& operator=(const Writer&) = delete;
+
+		void add(const Command& command, bool available);
+		void finish();
+
+	  private:
+		void add_text(const Command& command, bool available);
+		void add_json(const Command& command, bool available);
+		void flush_if_full();
+
+		std::FILE* out = nullptr;
+		Format format = Format::Text;
+		std::string buffer{};
+		std::string unavailable{};
+		size_t count = 0;
+		bool finished = false;
+	};
+} // namespace xxlib::listing
+
+#endif // XX_LISTING_HPP
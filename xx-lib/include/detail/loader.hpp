@@ -0,0 +1,39 @@
+#ifndef XX_LOADER_HPP
+#define XX_LOADER_HPP
+
+#include "detail/command.hpp"
+#include "detail/parser.hpp"
+#include <cstddef>
+#include <expected>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace xxlib::loader {
+	struct Source {
+		std::string path{};
+		bool userScope = false;
+		// A strict source fails the whole load when it cannot be parsed, otherwise it is skipped.
+		bool strict = false;
+		// An inherited source only contributes aliases whose names no earlier source defines.
+		bool inherited = false;
+	};
+
+	struct Options {
+		bool useCache = true;
+		std::string cacheDirectory{};
+		size_t maxFileSize = 0;
+		xxlib::parser::Backend backend = xxlib::parser::Backend::Events;
+		// Only this alias has to be materialized; other commands may be omitted from the result.
+		std::optional<std::string> commandName{};
+	};
+
+	// Resolves the raw 'include' entries of the file at path to the keys of the files they name, expanding globs.
+	[[nodiscard]] std::expected<std::vector<std::string>, std::string> resolve_includes(const std::string& path, const std::vector<std::string>& includes);
+	// A source that cannot be read is treated as empty.
+	[[nodiscard]] std::expected<std::vector<Command>, std::string> load_source(const Source& source, const Options& options);
+	// Loads all sources concurrently and concatenates the results in the order the sources were given.
+	[[nodiscard]] std::expected<std::vector<Command>, std::string> load_sources(const std::vector<Source>& sources, const Options& options);
+} // namespace xxlib::loader
+
+#endif // XX_LOADER_HPP
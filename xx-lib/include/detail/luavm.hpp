@@ -1,8 +1,12 @@
 #ifndef XX_LUAVM_HPP
 #define XX_LUAVM_HPP
 
+#include <cstdint>
+#include <expected>
+#include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 
 struct lua_State;
 
@@ -21,8 +25,14 @@ namespace xxlib::luavm {
 	void add_json_library(LuaStatePtr& luaState);
 	void add_cpr_library(LuaStatePtr& luaState);
 	void add_fs_library(LuaStatePtr& luaState);
+	// Replaces print so its lines go to output, which has to outlive the state.
+	void redirect_print(LuaStatePtr& luaState, const std::function<void(std::string_view)>& output);
 
 	int32_t loadstring(LuaStatePtr& luaState, const std::string& code);
+	// Loads a chunk produced by dump; like loadstring, a failure leaves the error message on the stack.
+	int32_t loadbytecode(LuaStatePtr& luaState, std::string_view bytecode);
+	// Compiles code to bytecode, which only loads on the same Lua version and architecture.
+	[[nodiscard]] std::expected<std::string, std::string> dump(LuaStatePtr& luaState, const std::string& code);
 	int32_t pcall(LuaStatePtr& luaState, int32_t nargs, int32_t nresults, int32_t errfunc);
 
 	[[nodiscard]] const char* tostring(LuaStatePtr& luaState, int32_t index = -1);
@@ -40,6 +50,7 @@ namespace xxlib::luavm {
 	void set_table(LuaStatePtr& luaState, int32_t index);
 	void set_global(LuaStatePtr& luaState, const std::string& name);
 	void seti(LuaStatePtr& luaState, int32_t index, int64_t n);
+	void pop(LuaStatePtr& luaState, int32_t n = 1);
 } // namespace xxlib::luavm
 
 #endif // XX_LUAVM_HPP
@@ -0,0 +1,38 @@
+#ifndef XX_MAPPED_FILE_HPP
+#define XX_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <expected>
+#include <string>
+#include <string_view>
+
+namespace xxlib {
+	// Read-only view over a file's contents. Regular files are memory-mapped,
+	// anything else (pipes, character devices, "-" for stdin) is read into an owned buffer.
+	class MappedFile {
+	  public:
+		[[nodiscard]] static std::expected<MappedFile, std::string> open(const std::string& path, size_t maxSize = 0);
+
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		[[nodiscard]] std::string_view view() const;
+		[[nodiscard]] bool is_mapped() const;
+
+	  private:
+		void release();
+
+		const char* data = nullptr;
+		size_t size = 0;
+		bool mapped = false;
+		std::string owned{};
+	};
+} // namespace xxlib
+
+#endif // XX_MAPPED_FILE_HPP
@@ -0,0 +1,55 @@
+#ifndef XX_PARALLEL_HPP
+#define XX_PARALLEL_HPP
+
+#include "detail/command.hpp"
+#include "detail/executor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <expected>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace xxlib::parallel {
+	// Grouped writes the whole output of a job at once when it finishes; Prefixed writes every complete line as it
+	// arrives, prefixed with the name of the job.
+	enum class Output { Grouped, Prefixed };
+
+	[[nodiscard]] Output string_to_output(const std::string& outputStr);
+
+	struct Options {
+		// A jobs count of 0 uses the hardware concurrency.
+		size_t jobs = 0;
+		bool keepGoing = false;
+		Output output = Output::Grouped;
+	};
+
+	struct Job {
+		Command command{};
+		CommandContext context{};
+		// Indices of the jobs that have to succeed before this one starts.
+		std::vector<size_t> dependsOn{};
+	};
+
+	enum class Status { Succeeded, Failed, Error, Skipped };
+
+	struct Result {
+		Status status = Status::Skipped;
+		int32_t exitCode = 0;
+		std::string error{};
+	};
+
+	using Execute = std::function<std::expected<int32_t, std::string>(Command&, CommandContext&)>;
+
+	// Runs the jobs on a work-stealing pool of options.jobs threads and writes their output to out. A job starts as
+	// soon as everything it depends on has succeeded, and is skipped if any of that fails. Unless keepGoing is set,
+	// every job that has not started by the time one fails is skipped; running ones are left to finish. Results are
+	// in the order of jobs.
+	[[nodiscard]] std::vector<Result> run(std::vector<Job> jobs, const Options& options, FILE* out, const Execute& execute = xxlib::executor::execute_command);
+
+	// Exit code of the first job in order that did not succeed, -1 for one that could not be executed, 0 otherwise.
+	[[nodiscard]] int32_t combined_exit_code(const std::vector<Result>& results);
+} // namespace xxlib::parallel
+
+#endif // XX_PARALLEL_HPP
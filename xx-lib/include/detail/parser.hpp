@@ -2,12 +2,40 @@
 #define XXLIB_PARSER_HPP
 
 #include "detail/command.hpp"
+#include "detail/mapped_file.hpp"
+#include <cstddef>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <expected>
 
 namespace xxlib::parser {
-	[[nodiscard]] std::expected<std::string, std::string> read_file(const std::string& path);
-	[[nodiscard]] std::expected<std::vector<Command>, std::string> parse_buffer(const std::string& buffer);
+	constexpr size_t DEFAULT_MAX_FILE_SIZE = 1024 * 1024;
+
+	enum class Backend {
+		// Builds commands from parser events without materializing a yaml-cpp document.
+		Events,
+		// Loads the whole document through YAML::Load first.
+		Dom,
+	};
+
+	struct Document {
+		std::vector<Command> commands{};
+		// Raw 'include' entries (paths or glob patterns), relative to the including file.
+		std::vector<std::string> includes{};
+	};
+
+	[[nodiscard]] Backend string_to_backend(const std::string& backendStr);
+
+	// Maps the file without copying; a maxSize of 0 disables the size limit.
+	[[nodiscard]] std::expected<xxlib::MappedFile, std::string> map_file(const std::string& path, size_t maxSize = 0);
+	[[nodiscard]] std::expected<std::string, std::string> read_file(const std::string& path, size_t maxSize = DEFAULT_MAX_FILE_SIZE);
+	[[nodiscard]] std::expected<std::vector<Command>, std::string> parse_buffer(std::string_view buffer, Backend backend = Backend::Events);
+	// Only materializes commands named commandName; every other alias is skipped by name.
+	[[nodiscard]] std::expected<std::vector<Command>, std::string> parse_buffer_for(std::string_view buffer, std::string_view commandName, Backend backend = Backend::Events);
+
+	[[nodiscard]] std::expected<Document, std::string> parse_document(std::string_view buffer, Backend backend = Backend::Events);
+	[[nodiscard]] std::expected<Document, std::string> parse_document_for(std::string_view buffer, std::string_view commandName, Backend backend = Backend::Events);
 } // namespace xxlib::parser
 
 #endif // XXLIB_PARSER_HPP
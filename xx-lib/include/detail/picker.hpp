@@ -0,0 +1,66 @@
+#ifndef XX_PICKER_HPP
+#define XX_PICKER_HPP
+
+#include "detail/fuzzy.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace xxlib::picker {
+	enum class KeyKind { Character, Backspace, ClearQuery, Up, Down, Accept, Cancel };
+
+	struct Key {
+		KeyKind kind = KeyKind::Character;
+		char character = 0;
+
+		bool operator==(const Key& other) const = default;
+	};
+
+	// Decodes raw terminal input; unknown escape sequences are dropped.
+	[[nodiscard]] std::vector<Key> decode_keys(std::string_view input);
+
+	enum class Action { Continue, Accept, Cancel };
+
+	// Query, matches and cursor of the picker, independent of the terminal. The matches of every prefix of the
+	// query are kept, so typing only re-scores the survivors of the previous keystroke and deleting is free.
+	class Picker {
+	  public:
+		explicit Picker(const xxlib::FuzzyIndex& index);
+
+		Action handle(const Key& key);
+
+		[[nodiscard]] std::string_view query() const;
+		[[nodiscard]] std::span<const xxlib::FuzzyIndex::Match> matches() const;
+		[[nodiscard]] std::optional<uint32_t> selected() const;
+
+		// The prompt line, a counter and as many matches as fit, the selected one highlighted.
+		[[nodiscard]] std::vector<std::string> frame(size_t height, size_t width) const;
+
+	  private:
+		const xxlib::FuzzyIndex& index;
+		std::string currentQuery{};
+		std::vector<std::vector<xxlib::FuzzyIndex::Match>> levels{};
+		size_t cursor = 0;
+	};
+
+	// Produces the escape sequences that turn the previously rendered frame into the next one, rewriting only
+	// the lines that changed.
+	class ScreenDiff {
+	  public:
+		[[nodiscard]] std::string render(const std::vector<std::string>& frame, size_t cursorRow, size_t cursorColumn);
+
+	  private:
+		std::vector<std::string> previous{};
+	};
+
+	// Runs the picker on the controlling terminal, using the alternate screen. Returns the index of the chosen
+	// name, or nothing when the picker was cancelled.
+	[[nodiscard]] std::expected<std::optional<uint32_t>, std::string> run(const xxlib::FuzzyIndex& index);
+} // namespace xxlib::picker
+
+#endif // XX_PICKER_HPP
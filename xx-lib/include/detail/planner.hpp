@@ -2,13 +2,45 @@
 #define XX_PLANNER_HPP
 
 #include "detail/command.hpp"
+#include "detail/command_registry.hpp"
 #include <vector>
 #include <string>
 #include <expected>
 
 namespace xxlib::planner {
+	// One alias named on the command line of 'run', with the extras that go to it alone.
+	struct Invocation {
+		std::string name{};
+		std::vector<std::string> extras{};
+
+		bool operator==(const Invocation& other) const = default;
+	};
+
+	// One alias to run as part of a graph, with the steps that have to succeed before it.
+	struct Step {
+		const Command* command = nullptr;
+		std::vector<std::string> extras{};
+		// Indices of earlier steps.
+		std::vector<size_t> dependsOn{};
+	};
+
 	[[nodiscard]] bool matches_constraints(const Command& command);
-	[[nodiscard]] std::expected<Command, std::string> plan_single(const std::vector<Command>& commands, const std::string& commandName);
+	// The planned command is handed out by pointer into commands; copy it before mutating.
+	[[nodiscard]] std::expected<const Command*, std::string> plan_single(const std::vector<Command>& commands, const std::string& commandName);
+	// Same as above, but only looks at the candidates the registry indexed under commandName. A name no alias has
+	// resolves to the only alias it is a prefix of; failures list ambiguous or similar names.
+	[[nodiscard]] std::expected<const Command*, std::string> plan_single(const xxlib::CommandRegistry& registry, const std::string& commandName);
+
+	// Splits the words given to 'run' into invocations. Extras are attached to an alias as 'name[k=v,x=y]', or as
+	// words containing '=' that follow it.
+	[[nodiscard]] std::expected<std::vector<Invocation>, std::string> parse_invocations(const std::vector<std::string>& words);
+	// Plans every invocation before any of them runs, so a typo in the last name fails before the first alias starts.
+	// Prefixes are only resolved for a single invocation; with several, every name has to match an alias exactly.
+	[[nodiscard]] std::expected<std::vector<const Command*>, std::string> plan_all(const xxlib::CommandRegistry& registry, const std::vector<Invocation>& invocations);
+	// Plans the invocations together with everything they depend on through depends_on, dependencies first. An alias
+	// reached more than once runs once, with the extras it was named with on the command line; only naming it again
+	// with different extras adds another step. Fails on unknown dependencies and cycles.
+	[[nodiscard]] std::expected<std::vector<Step>, std::string> plan_graph(const xxlib::CommandRegistry& registry, const std::vector<Invocation>& invocations);
 } // namespace xxlib::planner
 
 #endif // XX_PLANNER_HPP
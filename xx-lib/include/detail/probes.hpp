@@ -0,0 +1,24 @@
+#ifndef XX_PROBES_HPP
+#define XX_PROBES_HPP
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace xxlib::probes {
+	// Environment, filesystem and PATH lookups behind the dynamic constraints. Each distinct name, path or binary is
+	// resolved at most once per process and PATH is split once, so checking many aliases costs one probe per distinct argument.
+	[[nodiscard]] std::optional<std::string> env(std::string_view name);
+	// Paths are relative to the current directory.
+	[[nodiscard]] bool exists(std::string_view path);
+	// Whether an executable with this name is found on PATH, or at the given location if it contains a separator.
+	[[nodiscard]] bool which(std::string_view binary);
+
+	// Number of lookups that missed the memo table, for diagnostics and tests.
+	[[nodiscard]] size_t resolved_count();
+	// Forgets every memoized result and the split PATH.
+	void clear();
+} // namespace xxlib::probes
+
+#endif // XX_PROBES_HPP
@@ -1,8 +1,8 @@
 #ifndef XX_RENDERER_HPP
 #define XX_RENDERER_HPP
 
+#include "detail/string_map.hpp"
 #include <string>
-#include <unordered_map>
 
 namespace xxlib::renderer {
 	enum class Engine {
@@ -11,8 +11,9 @@ namespace xxlib::renderer {
 	};
 
 	[[nodiscard]] xxlib::renderer::Engine string_to_render_engine(const std::string& rendererStr);
+	[[nodiscard]] std::string render_engine_to_string(Engine renderEngine);
 
-	[[nodiscard]] std::string render(const std::string& templateStr, const std::unordered_map<std::string, std::string>& templateVars, Engine renderEngine);
+	[[nodiscard]] std::string render(const std::string& templateStr, const xxlib::StringMap& templateVars, Engine renderEngine);
 } // namespace xxlib::renderer
 
 #endif // XX_RENDERER_HPP
@@ -1,11 +1,11 @@
 #ifndef XX_INJA_RENDERER_HPP
 #define XX_INJA_RENDERER_HPP
 
+#include "detail/string_map.hpp"
 #include <string>
-#include <unordered_map>
 
 namespace xxlib::inja_renderer {
-	[[nodiscard]] std::string render(const std::string& templateStr, const std::unordered_map<std::string, std::string>& templateVars);
+	[[nodiscard]] std::string render(const std::string& templateStr, const xxlib::StringMap& templateVars);
 } // namespace xxlib::inja_renderer
 
 #endif // XX_INJA_RENDERER_HPP
@@ -0,0 +1,56 @@
+#ifndef XX_SEARCH_INDEX_HPP
+#define XX_SEARCH_INDEX_HPP
+
+#include "detail/command.hpp"
+#include <array>
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace xxlib {
+	// Full-text search over the name, cmd, env and template_vars of loaded commands. The searchable text of
+	// every field is assembled once and indexed by trigrams, so a query only verifies the commands whose
+	// fields contain all trigrams of each term.
+	//
+	// A query is a list of whitespace-separated terms that must all match, each as a substring of any field.
+	// A term may be restricted to one field with a name:, cmd:, env: or var: prefix, and double quotes keep
+	// spaces inside a term. In regex mode the whole query is one ECMAScript pattern matched against every field.
+	class SearchIndex {
+	  public:
+		enum Field : uint8_t { Name, Cmd, Env, TemplateVars, FIELD_COUNT };
+
+		struct Options {
+			bool ignoreCase = false;
+			bool regex = false;
+		};
+
+		SearchIndex() = default;
+		explicit SearchIndex(const std::vector<Command>& commands);
+
+		// Indices of the matching commands in ascending order.
+		[[nodiscard]] std::expected<std::vector<uint32_t>, std::string> search(std::string_view query, const Options& options) const;
+
+	  private:
+		struct Term {
+			std::string text{};
+			// FIELD_COUNT for any field.
+			uint8_t field = FIELD_COUNT;
+		};
+
+		[[nodiscard]] static std::expected<std::vector<Term>, std::string> parse_query(std::string_view query);
+		[[nodiscard]] std::vector<uint32_t> candidates(const Term& term) const;
+		// Expects a lowercase term when ignoreCase is set.
+		[[nodiscard]] bool term_matches(uint32_t document, const Term& term, bool ignoreCase) const;
+
+		// Values of a multi-value field are separated by newlines.
+		std::vector<std::array<std::string, FIELD_COUNT>> texts{};
+		std::vector<std::array<std::string, FIELD_COUNT>> lowerTexts{};
+		// Keyed by field and lowercase trigram, sorted document indices.
+		std::unordered_map<uint32_t, std::vector<uint32_t>> postings{};
+	};
+} // namespace xxlib
+
+#endif // XX_SEARCH_INDEX_HPP
@@ -0,0 +1,45 @@
+#ifndef XX_SERIALIZER_HPP
+#define XX_SERIALIZER_HPP
+
+#include "detail/command.hpp"
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace xxlib::serializer {
+	// Little-endian, length-prefixed binary encoding shared by the on-disk caches.
+	struct Writer {
+		std::string buffer{};
+
+		void u8(uint8_t value);
+		void u32(uint32_t value);
+		void u64(uint64_t value);
+		void i64(int64_t value);
+		void str(std::string_view value);
+	};
+
+	// Reads never throw: running past the end clears `ok` and yields zero values.
+	struct Reader {
+		std::string_view data{};
+		size_t offset = 0;
+		bool ok = true;
+
+		[[nodiscard]] uint8_t u8();
+		[[nodiscard]] uint32_t u32();
+		[[nodiscard]] uint64_t u64();
+		[[nodiscard]] int64_t i64();
+		[[nodiscard]] std::string str();
+		[[nodiscard]] std::string_view str_view();
+		[[nodiscard]] size_t remaining() const;
+	};
+
+	void write_command(Writer& writer, const Command& command);
+	[[nodiscard]] bool read_command(Reader& reader, Command& command);
+
+	void write_commands(Writer& writer, const std::vector<Command>& commands);
+	[[nodiscard]] std::expected<std::vector<Command>, std::string> read_commands(Reader& reader);
+} // namespace xxlib::serializer
+
+#endif // XX_SERIALIZER_HPP
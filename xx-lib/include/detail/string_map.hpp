@@ -0,0 +1,61 @@
+#ifndef XX_STRING_MAP_HPP
+#define XX_STRING_MAP_HPP
+
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace xxlib {
+	// String map kept as a vector sorted by key. Commands carry a handful of template vars and env entries,
+	// for which one contiguous allocation is cheaper than a node per entry plus a bucket array.
+	class StringMap {
+	  public:
+		using value_type = std::pair<std::string, std::string>;
+		using iterator = std::vector<value_type>::iterator;
+		using const_iterator = std::vector<value_type>::const_iterator;
+
+		StringMap() = default;
+		StringMap(std::initializer_list<value_type> entries);
+
+		[[nodiscard]] iterator begin() {
+			return entries.begin();
+		}
+		[[nodiscard]] iterator end() {
+			return entries.end();
+		}
+		[[nodiscard]] const_iterator begin() const {
+			return entries.begin();
+		}
+		[[nodiscard]] const_iterator end() const {
+			return entries.end();
+		}
+
+		[[nodiscard]] size_t size() const {
+			return entries.size();
+		}
+		[[nodiscard]] bool empty() const {
+			return entries.empty();
+		}
+		void reserve(size_t capacity) {
+			entries.reserve(capacity);
+		}
+
+		[[nodiscard]] iterator find(std::string_view key);
+		[[nodiscard]] const_iterator find(std::string_view key) const;
+		[[nodiscard]] bool contains(std::string_view key) const;
+		// Throws std::out_of_range when the key is missing.
+		[[nodiscard]] const std::string& at(std::string_view key) const;
+		std::string& operator[](std::string_view key);
+		// Like std::unordered_map::emplace, an existing value is left untouched.
+		std::pair<iterator, bool> emplace(std::string key, std::string value);
+
+		bool operator==(const StringMap& other) const = default;
+
+	  private:
+		std::vector<value_type> entries{};
+	};
+} // namespace xxlib
+
+#endif // XX_STRING_MAP_HPP
@@ -0,0 +1,94 @@
+#ifndef XX_THREAD_POOL_HPP
+#define XX_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace xxlib {
+	// Fixed-size pool with a single FIFO queue. Pending jobs are drained before the destructor returns.
+	class ThreadPool {
+	  public:
+		// A threadCount of 0 uses the hardware concurrency.
+		explicit ThreadPool(size_t threadCount = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		template <typename F> auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+			using Result = std::invoke_result_t<std::decay_t<F>>;
+
+			auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+			auto future = packaged->get_future();
+			enqueue([packaged]() {
+				(*packaged)();
+			});
+			return future;
+		}
+
+		[[nodiscard]] size_t size() const;
+
+	  private:
+		void enqueue(std::function<void()> job);
+		void worker_loop();
+
+		std::vector<std::thread> workers{};
+		std::deque<std::function<void()>> jobs{};
+		std::mutex mutex{};
+		std::condition_variable condition{};
+		bool stopping = false;
+	};
+
+	// Calls body(begin, end) for consecutive ranges of [0, count) of at least minChunk indices. The ranges run on a
+	// ThreadPool when there are several of them, and all are done when this returns.
+	void parallel_ranges(size_t count, size_t minChunk, const std::function<void(size_t, size_t)>& body);
+
+	// Pool with a queue per worker. Jobs submitted from a job go to the queue of the worker running it, which runs the
+	// newest of them first; jobs from outside the pool run in submission order. A worker whose queue is empty steals
+	// from the other end of another worker's queue. Pending jobs, and
+	// any they submit, are drained before the destructor returns.
+	class WorkStealingPool {
+	  public:
+		// A threadCount of 0 uses the hardware concurrency.
+		explicit WorkStealingPool(size_t threadCount = 0);
+		~WorkStealingPool();
+
+		WorkStealingPool(const WorkStealingPool&) = delete;
+		WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+		void submit(std::function<void()> job);
+
+		[[nodiscard]] size_t size() const;
+
+	  private:
+		struct Queue {
+			std::mutex mutex{};
+			std::deque<std::function<void()>> jobs{};
+		};
+
+		bool try_take(size_t self, std::function<void()>& job);
+		void worker_loop(size_t self);
+
+		std::vector<std::unique_ptr<Queue>> queues{};
+		std::vector<std::thread> workers{};
+		std::atomic<size_t> nextQueue = 0;
+		// Jobs submitted but not yet taken, and jobs taken but not finished. Guarded by mutex so sleeping workers cannot
+		// miss a wake-up; a running job may still submit more, so workers only stop once both are zero.
+		size_t queued = 0;
+		size_t running = 0;
+		std::mutex mutex{};
+		std::condition_variable condition{};
+		bool stopping = false;
+	};
+} // namespace xxlib
+
+#endif // XX_THREAD_POOL_HPP
@@ -0,0 +1,34 @@
+#ifndef XX_YAML_EVENTS_HPP
+#define XX_YAML_EVENTS_HPP
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace xxlib::yaml_events {
+	// Plain value tree built straight from parser events, without yaml-cpp's shared node graph.
+	struct Node {
+		enum class Kind : uint8_t {
+			Null,
+			Scalar,
+			Sequence,
+			Map,
+		};
+
+		Kind kind = Kind::Null;
+		std::string scalar{};
+		std::vector<Node> items{};
+		std::vector<std::pair<Node, Node>> entries{};
+	};
+
+	// Builds the first document of the stream. With onlyAlias set, entries of the root 'alias' map with any other
+	// name are skipped without being built. Returns nullopt when an alias refers to an anchor inside a skipped entry.
+	// Throws YAML::Exception on malformed input.
+	[[nodiscard]] std::optional<Node> load(std::istream& stream, std::optional<std::string_view> onlyAlias = std::nullopt);
+} // namespace xxlib::yaml_events
+
+#endif // XX_YAML_EVENTS_HPP
@@ -9,11 +9,29 @@ namespace xxlib {
 } // namespace xxlib
 
 #include "detail/parser.hpp"
+#include "detail/yaml_events.hpp"
+#include "detail/cache.hpp"
+#include "detail/bundle.hpp"
+#include "detail/completion.hpp"
+#include "detail/listing.hpp"
+#include "detail/loader.hpp"
+#include "detail/discovery.hpp"
+#include "detail/constraint.hpp"
+#include "detail/probes.hpp"
 #include "detail/planner.hpp"
 #include "detail/executor.hpp"
+#include "detail/parallel.hpp"
+#include "detail/incremental.hpp"
+#include "detail/action_cache.hpp"
+#include "detail/cache_backends/disk_backend.hpp"
+#include "detail/cache_backends/http_backend.hpp"
 #include "detail/luavm.hpp"
 #include "detail/platform.hpp"
 #include "detail/command.hpp"
+#include "detail/command_registry.hpp"
+#include "detail/search_index.hpp"
+#include "detail/fuzzy.hpp"
+#include "detail/picker.hpp"
 #include "detail/helpers.hpp"
 #include "detail/updates.hpp"
 
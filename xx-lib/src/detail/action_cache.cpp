@@ -0,0 +1,290 @@
+#include "detail/action_cache.hpp"
+#include "detail/cache.hpp"
+#include "detail/glob.hpp"
+#include "detail/hash.hpp"
+#include "detail/incremental.hpp"
+#include "detail/mapped_file.hpp"
+#include "detail/platform.hpp"
+#include "detail/serializer.hpp"
+#include "detail/thread_pool.hpp"
+#include "xxlib.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <system_error>
+
+namespace xxlib::action_cache {
+	namespace {
+		// Inputs hashed by one thread; hashing is the expensive part of a key.
+		constexpr size_t MIN_CHUNK = 8;
+	} // namespace
+
+	std::string kind_to_string(Kind kind) {
+		return kind == Kind::Action ? "ac" : "cas";
+	}
+
+	bool is_digest(std::string_view text) {
+		return text.size() == 64 && std::all_of(text.begin(), text.end(), [](char c) {
+			return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+		});
+	}
+
+	std::expected<std::string, std::string> action_key(const Command& command, const std::vector<std::string>& extras, const std::filesystem::path& base) {
+		const auto files = xxlib::incremental::expand_all(base, command.inputs);
+
+		std::vector<xxlib::hash::Sha256Digest> digests(files.size());
+		std::atomic<bool> unreadable = false;
+		xxlib::parallel_ranges(files.size(), MIN_CHUNK, [&](size_t begin, size_t end) {
+			for (auto i = begin; i < end; ++i) {
+				const auto file = xxlib::MappedFile::open(files[i]);
+				if (!file) {
+					unreadable = true;
+					return;
+				}
+				digests[i] = xxlib::hash::sha256(file->view());
+			}
+		});
+		if (unreadable) {
+			return std::unexpected("An input could not be read");
+		}
+
+		xxlib::serializer::Writer writer;
+		writer.str(xxlib::version());
+		writer.str(xxlib::platform::os_to_string(xxlib::platform::get_current_os()));
+		writer.str(xxlib::platform::architecture_to_string(xxlib::platform::get_current_architecture()));
+		xxlib::serializer::write_command(writer, command);
+		writer.u32(static_cast<uint32_t>(extras.size()));
+		for (const auto& extra : extras) {
+			writer.str(extra);
+		}
+
+		// Most inherited variables (HOME, PWD, session and terminal ones) differ between machines without changing
+		// any output, so only PATH and the ones the alias lists count.
+		auto variables = command.cacheEnv;
+		variables.emplace_back("PATH");
+		std::sort(variables.begin(), variables.end());
+		variables.erase(std::unique(variables.begin(), variables.end()), variables.end());
+		writer.u32(static_cast<uint32_t>(variables.size()));
+		for (const auto& variable : variables) {
+			const auto* value = std::getenv(variable.c_str());
+			writer.str(variable);
+			writer.u8(value ? 1 : 0);
+			writer.str(value ? value : "");
+		}
+
+		writer.u32(static_cast<uint32_t>(files.size()));
+		for (size_t i = 0; i < files.size(); ++i) {
+			writer.str(std::filesystem::path(files[i]).lexically_relative(base).generic_string());
+			writer.str(std::string_view(reinterpret_cast<const char*>(digests[i].data()), digests[i].size()));
+		}
+
+		return xxlib::hash::to_hex(xxlib::hash::sha256(writer.buffer));
+	}
+
+	std::expected<Entry, std::string> lookup(Backend& backend, const std::string& key) {
+		const auto data = backend.get(Kind::Action, key);
+		if (!data) {
+			return std::unexpected(data.error());
+		}
+		if (!*data) {
+			return std::unexpected("No cached result");
+		}
+
+		auto reader = xxlib::serializer::Reader{.data = **data};
+		if (reader.u32() != MAGIC || reader.u32() != FORMAT_VERSION) {
+			return std::unexpected("Cached result has an incompatible format");
+		}
+
+		Entry entry;
+		entry.exitCode = static_cast<int32_t>(reader.u32());
+		entry.log = reader.str();
+
+		const auto outputCount = reader.u32();
+		if (!reader.ok || outputCount > reader.remaining() / 4) {
+			return std::unexpected("Cached result is corrupted");
+		}
+		entry.outputs.reserve(outputCount);
+		for (uint32_t i = 0; i < outputCount && reader.ok; ++i) {
+			auto& output = entry.outputs.emplace_back();
+			output.path = reader.str();
+			output.digest = reader.str();
+			output.size = reader.u64();
+			output.permissions = reader.u32();
+		}
+		if (!reader.ok) {
+			return std::unexpected("Cached result is truncated");
+		}
+
+		// Entries may come from a shared server, so nothing in them may point outside the working directory.
+		for (const auto& output : entry.outputs) {
+			const auto path = std::filesystem::path(output.path);
+			const auto escapes = path.is_absolute() || std::any_of(path.begin(), path.end(), [](const std::filesystem::path& part) {
+				return part == "..";
+			});
+			if (!is_digest(output.digest) || output.path.empty() || escapes) {
+				return std::unexpected("Cached result has an invalid output '" + output.path + "'");
+			}
+		}
+		return entry;
+	}
+
+	std::expected<void, std::string> restore(Backend& backend, const std::filesystem::path& base, const Entry& entry) {
+		std::vector<std::string> contents(entry.outputs.size());
+		std::vector<std::string> errors(entry.outputs.size());
+		xxlib::parallel_ranges(entry.outputs.size(), 1, [&](size_t begin, size_t end) {
+			for (auto i = begin; i < end; ++i) {
+				const auto& output = entry.outputs[i];
+				auto blob = backend.get(Kind::Blob, output.digest);
+				if (!blob) {
+					errors[i] = blob.error();
+				} else if (!*blob || (*blob)->size() != output.size) {
+					errors[i] = "Output '" + output.path + "' is missing from the cache";
+				} else {
+					contents[i] = std::move(**blob);
+				}
+			}
+		});
+		for (const auto& error : errors) {
+			if (!error.empty()) {
+				return std::unexpected(error);
+			}
+		}
+
+		for (size_t i = 0; i < entry.outputs.size(); ++i) {
+			const auto& output = entry.outputs[i];
+			const auto target = base / std::filesystem::path(output.path);
+			if (auto written = xxlib::cache::write_atomic(target.string(), contents[i]); !written) {
+				return std::unexpected("Failed to restore '" + output.path + "': " + written.error());
+			}
+
+			std::error_code ec;
+			std::filesystem::permissions(target, static_cast<std::filesystem::perms>(output.permissions), ec);
+		}
+		return {};
+	}
+
+	std::expected<Upload, std::string> prepare(const std::filesystem::path& base, const std::string& key, Entry entry, const std::vector<std::string>& outputPatterns) {
+		for (const auto& pattern : outputPatterns) {
+			if (xxlib::glob::expand(base, pattern).empty()) {
+				return std::unexpected("No file matches output '" + pattern + "'");
+			}
+		}
+
+		auto result = Upload{.key = key};
+		entry.outputs.clear();
+		for (const auto& file : xxlib::incremental::expand_all(base, outputPatterns)) {
+			const auto content = xxlib::MappedFile::open(file);
+			if (!content) {
+				return std::unexpected("Failed to read output '" + file + "': " + content.error());
+			}
+
+			std::error_code ec;
+			auto output = OutputFile{
+				.path = std::filesystem::path(file).lexically_relative(base).generic_string(),
+				.digest = xxlib::hash::to_hex(xxlib::hash::sha256(content->view())),
+				.size = content->view().size(),
+				.permissions = static_cast<uint32_t>(std::filesystem::status(file, ec).permissions()),
+			};
+
+			const auto known = std::any_of(result.blobs.begin(), result.blobs.end(), [&output](const auto& blob) {
+				return blob.first == output.digest;
+			});
+			if (!known) {
+				result.blobs.emplace_back(output.digest, std::string(content->view()));
+			}
+			entry.outputs.push_back(std::move(output));
+		}
+
+		result.entry = std::move(entry);
+		return result;
+	}
+
+	std::expected<void, std::string> upload(Backend& backend, const Upload& upload) {
+		std::vector<std::string> errors(upload.blobs.size());
+		xxlib::parallel_ranges(upload.blobs.size(), 1, [&](size_t begin, size_t end) {
+			for (auto i = begin; i < end; ++i) {
+				// Blobs are named by their content, so one the backend has already holds the same bytes.
+				const auto& [digest, content] = upload.blobs[i];
+				if (backend.contains(Kind::Blob, digest)) {
+					continue;
+				}
+				if (const auto sent = backend.put(Kind::Blob, digest, content); !sent) {
+					errors[i] = sent.error();
+				}
+			}
+		});
+		for (const auto& error : errors) {
+			if (!error.empty()) {
+				return std::unexpected(error);
+			}
+		}
+
+		const auto& entry = upload.entry;
+		xxlib::serializer::Writer writer;
+		writer.u32(MAGIC);
+		writer.u32(FORMAT_VERSION);
+		writer.u32(static_cast<uint32_t>(entry.exitCode));
+		writer.str(entry.log);
+		writer.u32(static_cast<uint32_t>(entry.outputs.size()));
+		for (const auto& output : entry.outputs) {
+			writer.str(output.path);
+			writer.str(output.digest);
+			writer.u64(output.size);
+			writer.u32(output.permissions);
+		}
+		return backend.put(Kind::Action, upload.key, writer.buffer);
+	}
+
+	std::expected<void, std::string> store(Backend& backend, const std::filesystem::path& base, const std::string& key, Entry entry, const std::vector<std::string>& outputPatterns) {
+		const auto prepared = prepare(base, key, std::move(entry), outputPatterns);
+		if (!prepared) {
+			return std::unexpected(prepared.error());
+		}
+		return upload(backend, *prepared);
+	}
+
+	Eviction evict(const std::string& directory, uint64_t maxSize) {
+		struct CachedFile {
+			std::filesystem::path path{};
+			uint64_t size = 0;
+			std::filesystem::file_time_type mtime{};
+		};
+
+		std::vector<CachedFile> files;
+		uint64_t total = 0;
+		std::error_code ec;
+		for (auto it = std::filesystem::recursive_directory_iterator(directory, ec); !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+			if (!it->is_regular_file(ec)) {
+				continue;
+			}
+
+			auto file = CachedFile{.path = it->path(), .size = it->file_size(ec), .mtime = it->last_write_time(ec)};
+			total += file.size;
+			// Temporary files belong to writers that are still busy.
+			if (file.path.extension() != ".tmp") {
+				files.push_back(std::move(file));
+			}
+		}
+
+		if (total <= maxSize) {
+			return Eviction{.remaining = total};
+		}
+
+		std::sort(files.begin(), files.end(), [](const CachedFile& left, const CachedFile& right) {
+			return left.mtime < right.mtime;
+		});
+
+		const auto target = maxSize / 4 * 3;
+		uint64_t removed = 0;
+		for (const auto& file : files) {
+			if (total - removed <= target) {
+				break;
+			}
+			if (std::filesystem::remove(file.path, ec)) {
+				removed += file.size;
+			}
+		}
+		return Eviction{.removed = removed, .remaining = total - removed};
+	}
+} // namespace xxlib::action_cache
@@ -0,0 +1,76 @@
+#include "detail/bundle.hpp"
+#include "detail/cache.hpp"
+#include "detail/executors/lua_executor.hpp"
+#include "detail/serializer.hpp"
+#include "xxlib.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace xxlib::bundle {
+	std::expected<void, std::string> write(const std::string& path, const std::vector<Command>& commands) {
+		xxlib::serializer::Writer writer;
+		writer.u32(MAGIC);
+		writer.u32(FORMAT_VERSION);
+		writer.str(xxlib::version());
+		xxlib::serializer::write_commands(writer, commands);
+
+		writer.u32(static_cast<uint32_t>(commands.size()));
+		for (const auto& command : commands) {
+			if (command.executionEngine != xxlib::executor::Engine::Lua || command.renderEngine != xxlib::renderer::Engine::None) {
+				writer.str("");
+				continue;
+			}
+
+			auto bytecode = xxlib::lua_executor::compile(command);
+			if (!bytecode) {
+				// The alias still runs from source and reports the error at that point.
+				spdlog::warn("Failed to precompile Lua alias '{}': {}", command.name, bytecode.error());
+				writer.str("");
+				continue;
+			}
+			writer.str(*bytecode);
+		}
+
+		return xxlib::cache::write_atomic(path, writer.buffer);
+	}
+
+	std::expected<Bundle, std::string> load(const std::string& path) {
+		auto file = xxlib::MappedFile::open(path);
+		if (!file) {
+			return std::unexpected(file.error());
+		}
+
+		Bundle bundle{.file = std::move(*file)};
+
+		auto reader = xxlib::serializer::Reader{.data = bundle.file.view()};
+		if (reader.u32() != MAGIC || reader.u32() != FORMAT_VERSION) {
+			return std::unexpected("Not a bundle or an unsupported bundle format: " + path);
+		}
+
+		if (const auto version = reader.str_view(); version != xxlib::version()) {
+			return std::unexpected("Bundle was compiled by xx " + std::string(version) + ", recompile it with xx " + xxlib::version());
+		}
+
+		auto commands = xxlib::serializer::read_commands(reader);
+		if (!commands) {
+			return std::unexpected(commands.error());
+		}
+		bundle.commands = std::move(*commands);
+
+		const auto chunkCount = reader.u32();
+		if (!reader.ok || chunkCount != bundle.commands.size()) {
+			return std::unexpected("Bundle Lua section is corrupted");
+		}
+
+		bundle.luaChunks.reserve(chunkCount);
+		for (uint32_t i = 0; i < chunkCount; ++i) {
+			bundle.luaChunks.emplace_back(reader.str_view());
+		}
+
+		if (!reader.ok) {
+			return std::unexpected("Bundle Lua section is truncated");
+		}
+
+		return bundle;
+	}
+} // namespace xxlib::bundle
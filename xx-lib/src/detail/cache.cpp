@@ -0,0 +1,206 @@
+#include "detail/cache.hpp"
+#include "detail/completion.hpp"
+#include "detail/hash.hpp"
+#include "detail/mapped_file.hpp"
+#include "detail/parser.hpp"
+#include "detail/serializer.hpp"
+#include "xxlib.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <spdlog/spdlog.h>
+
+namespace xxlib::cache {
+	std::string default_directory() {
+#ifdef _WIN32
+		if (const auto* localAppData = std::getenv("LOCALAPPDATA")) {
+			return (std::filesystem::path(localAppData) / "xx" / "cache").string();
+		}
+#else
+		if (const auto* xdgCacheHome = std::getenv("XDG_CACHE_HOME"); xdgCacheHome && *xdgCacheHome) {
+			return (std::filesystem::path(xdgCacheHome) / "xx").string();
+		}
+		if (const auto* home = std::getenv("HOME")) {
+			return (std::filesystem::path(home) / ".cache" / "xx").string();
+		}
+#endif
+		return (std::filesystem::temp_directory_path() / "xx-cache").string();
+	}
+
+	std::string entry_path(const std::string& cacheDirectory, const std::string& sourcePath) {
+		std::error_code ec;
+		auto absolutePath = std::filesystem::absolute(sourcePath, ec);
+		if (ec) {
+			absolutePath = sourcePath;
+		}
+
+		const auto key = xxlib::hash::to_hex(xxlib::hash::fnv1a64(absolutePath.lexically_normal().string()));
+		return (std::filesystem::path(cacheDirectory) / (key + ".xxc")).string();
+	}
+
+	std::expected<void, std::string> write_atomic(const std::string& path, std::string_view data) {
+		std::error_code ec;
+		const auto directory = std::filesystem::path(path).parent_path();
+		if (!directory.empty()) {
+			std::filesystem::create_directories(directory, ec);
+			if (ec) {
+				return std::unexpected("Failed to create cache directory: " + ec.message());
+			}
+		}
+
+		// Write to a unique sibling first so concurrent readers never observe a partial file.
+		const auto tempPath = path + "." + xxlib::hash::to_hex(std::random_device{}()) + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open()) {
+				return std::unexpected("Failed to open cache file for writing: " + tempPath);
+			}
+			file.write(data.data(), static_cast<std::streamsize>(data.size()));
+			if (!file) {
+				file.close();
+				std::filesystem::remove(tempPath, ec);
+				return std::unexpected("Failed to write cache file: " + tempPath);
+			}
+		}
+
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec) {
+			std::filesystem::remove(tempPath, ec);
+			return std::unexpected("Failed to move cache file into place: " + path);
+		}
+
+		return {};
+	}
+
+	std::expected<SourceStamp, std::string> stat_source(const std::string& sourcePath) {
+		std::error_code ec;
+
+		const auto absolutePath = std::filesystem::absolute(sourcePath, ec);
+		if (ec) {
+			return std::unexpected("Failed to resolve path: " + ec.message());
+		}
+
+		const auto size = std::filesystem::file_size(absolutePath, ec);
+		if (ec) {
+			return std::unexpected("Failed to stat file: " + ec.message());
+		}
+
+		const auto mtime = std::filesystem::last_write_time(absolutePath, ec);
+		if (ec) {
+			return std::unexpected("Failed to stat file: " + ec.message());
+		}
+
+		return SourceStamp{
+			.path = absolutePath.lexically_normal().string(),
+			.size = static_cast<uint64_t>(size),
+			.mtime = static_cast<int64_t>(mtime.time_since_epoch().count()),
+		};
+	}
+
+	std::expected<SourceStamp, std::string> make_stamp(const std::string& sourcePath, std::string_view content) {
+		auto stamp = stat_source(sourcePath);
+		if (stamp) {
+			stamp->hash = xxlib::hash::fnv1a64(content);
+		}
+		return stamp;
+	}
+
+	std::expected<xxlib::parser::Document, std::string> load(const std::string& entryPath, const SourceStamp& stamp) {
+		const auto file = xxlib::MappedFile::open(entryPath);
+		if (!file) {
+			return std::unexpected("No cache entry");
+		}
+
+		auto reader = xxlib::serializer::Reader{.data = file->view()};
+
+		if (reader.u32() != MAGIC || reader.u32() != FORMAT_VERSION || reader.str_view() != xxlib::version()) {
+			return std::unexpected("Cache entry has an incompatible format");
+		}
+
+		const auto path = reader.str_view();
+		const auto sourceSize = reader.u64();
+		const auto sourceMtime = reader.i64();
+		const auto sourceHash = reader.u64();
+
+		if (!reader.ok) {
+			return std::unexpected("Cache entry header is truncated");
+		}
+
+		if (path != stamp.path || sourceSize != stamp.size || sourceMtime != stamp.mtime || sourceHash != stamp.hash) {
+			return std::unexpected("Cache entry is stale");
+		}
+
+		xxlib::parser::Document document;
+
+		const auto includeCount = reader.u32();
+		if (!reader.ok || includeCount > reader.remaining() / 4) {
+			return std::unexpected("Cache entry include list is corrupted");
+		}
+		document.includes.reserve(includeCount);
+		for (uint32_t i = 0; i < includeCount; ++i) {
+			document.includes.emplace_back(reader.str());
+		}
+
+		auto commands = xxlib::serializer::read_commands(reader);
+		if (!commands) {
+			return std::unexpected(commands.error());
+		}
+		document.commands = std::move(*commands);
+
+		return document;
+	}
+
+	std::expected<void, std::string> store(const std::string& entryPath, const SourceStamp& stamp, const xxlib::parser::Document& document) {
+		xxlib::serializer::Writer writer;
+		writer.u32(MAGIC);
+		writer.u32(FORMAT_VERSION);
+		writer.str(xxlib::version());
+		writer.str(stamp.path);
+		writer.u64(stamp.size);
+		writer.i64(stamp.mtime);
+		writer.u64(stamp.hash);
+		writer.u32(static_cast<uint32_t>(document.includes.size()));
+		for (const auto& include : document.includes) {
+			writer.str(include);
+		}
+		xxlib::serializer::write_commands(writer, document.commands);
+
+		if (auto written = write_atomic(entryPath, writer.buffer); !written) {
+			return written;
+		}
+
+		// The name index only backs shell completion, which falls back to a full load without it.
+		if (const auto indexed = xxlib::completion::write_index(entryPath, stamp, document); !indexed) {
+			spdlog::debug("Failed to store completion index: {}", indexed.error());
+		}
+		return {};
+	}
+
+	std::expected<xxlib::parser::Document, std::string> parse_cached(const std::string& sourcePath, std::string_view buffer, const std::string& cacheDirectory, xxlib::parser::Backend backend) {
+		const auto stamp = make_stamp(sourcePath, buffer);
+		if (!stamp) {
+			spdlog::debug("Cannot cache {}: {}", sourcePath, stamp.error());
+			return xxlib::parser::parse_document(buffer, backend);
+		}
+
+		const auto entryPath = entry_path(cacheDirectory, sourcePath);
+
+		auto cached = load(entryPath, *stamp);
+		if (cached) {
+			spdlog::debug("Loaded {} commands from cache entry: {}", cached->commands.size(), entryPath);
+			return cached;
+		}
+		spdlog::debug("Cache miss for {}: {}", sourcePath, cached.error());
+
+		auto parseResult = xxlib::parser::parse_document(buffer, backend);
+		if (parseResult) {
+			if (const auto stored = store(entryPath, *stamp, *parseResult); !stored) {
+				spdlog::debug("Failed to store cache entry: {}", stored.error());
+			}
+		}
+
+		return parseResult;
+	}
+} // namespace xxlib::cache
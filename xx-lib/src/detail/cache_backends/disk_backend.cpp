@@ -0,0 +1,101 @@
+#include "detail/cache_backends/disk_backend.hpp"
+#include "detail/cache.hpp"
+#include "detail/mapped_file.hpp"
+
+#include <charconv>
+#include <string>
+#include <system_error>
+#include <spdlog/spdlog.h>
+
+namespace xxlib::action_cache {
+	namespace {
+		constexpr std::string_view SIZE_FILE = "size";
+
+		// Eviction goes by modification time, so a use moves a file to the back of the queue.
+		void touch(const std::filesystem::path& path) {
+			std::error_code ec;
+			std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+		}
+	} // namespace
+
+	DiskBackend::DiskBackend(std::string directory, uint64_t maxSize) : directory(std::move(directory)), maxSize(maxSize) {
+	}
+
+	std::expected<std::optional<std::string>, std::string> DiskBackend::get(Kind kind, const std::string& key) {
+		const auto path = path_of(kind, key);
+		const auto file = xxlib::MappedFile::open(path.string());
+		if (!file) {
+			return std::nullopt;
+		}
+
+		touch(path);
+		return std::string(file->view());
+	}
+
+	std::expected<void, std::string> DiskBackend::put(Kind kind, const std::string& key, std::string_view data) {
+		if (auto written = xxlib::cache::write_atomic(path_of(kind, key).string(), data); !written) {
+			return written;
+		}
+
+		// An entry is written after its blobs, so it is the one point per stored result to record the size.
+		account(data.size(), kind == Kind::Action);
+		return {};
+	}
+
+	bool DiskBackend::contains(Kind kind, const std::string& key) {
+		const auto path = path_of(kind, key);
+		std::error_code ec;
+		if (!std::filesystem::exists(path, ec)) {
+			return false;
+		}
+
+		touch(path);
+		return true;
+	}
+
+	std::filesystem::path DiskBackend::path_of(Kind kind, const std::string& key) const {
+		return std::filesystem::path(directory) / kind_to_string(kind) / key.substr(0, 2) / key;
+	}
+
+	std::optional<uint64_t> DiskBackend::read_size() const {
+		const auto file = xxlib::MappedFile::open((std::filesystem::path(directory) / SIZE_FILE).string());
+		if (!file) {
+			return std::nullopt;
+		}
+
+		uint64_t size = 0;
+		const auto text = file->view();
+		if (std::from_chars(text.data(), text.data() + text.size(), size).ec != std::errc{}) {
+			return std::nullopt;
+		}
+		return size;
+	}
+
+	void DiskBackend::account(uint64_t bytes, bool record) {
+		std::lock_guard lock(sizeMutex);
+		unrecorded += bytes;
+		if (!record) {
+			return;
+		}
+
+		// Other processes update the file as well, so it is read again rather than kept; the estimate only has to be
+		// close enough to decide when to walk the directory.
+		auto size = read_size();
+		if (size) {
+			*size += unrecorded;
+		}
+		unrecorded = 0;
+
+		if (!size || *size > maxSize) {
+			const auto evicted = evict(directory, maxSize);
+			if (evicted.removed > 0) {
+				spdlog::debug("Evicted {} bytes from the action cache", evicted.removed);
+			}
+			size = evicted.remaining;
+		}
+
+		if (auto written = xxlib::cache::write_atomic((std::filesystem::path(directory) / SIZE_FILE).string(), std::to_string(*size)); !written) {
+			spdlog::debug("Failed to record the size of the action cache: {}", written.error());
+		}
+	}
+} // namespace xxlib::action_cache
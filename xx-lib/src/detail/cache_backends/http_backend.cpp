@@ -0,0 +1,78 @@
+#include "detail/cache_backends/http_backend.hpp"
+
+#include <cpr/cpr.h>
+#include <spdlog/spdlog.h>
+
+namespace xxlib::action_cache {
+	namespace {
+		const std::string UNAVAILABLE = "The remote cache is unavailable";
+	} // namespace
+
+	HttpBackend::HttpBackend(std::string url, std::chrono::milliseconds timeout, std::chrono::milliseconds connectTimeout) : url(std::move(url)), timeout(timeout), connectTimeout(connectTimeout) {
+		while (this->url.ends_with('/')) {
+			this->url.pop_back();
+		}
+	}
+
+	std::expected<std::optional<std::string>, std::string> HttpBackend::get(Kind kind, const std::string& key) {
+		if (unavailable) {
+			return std::unexpected(UNAVAILABLE);
+		}
+
+		auto response = cpr::Get(cpr::Url{url_of(kind, key)}, cpr::Timeout{timeout}, cpr::ConnectTimeout{connectTimeout});
+		if (response.error) {
+			return std::unexpected(unreachable(response.error.message));
+		}
+		if (response.status_code == 404) {
+			return std::nullopt;
+		}
+		if (response.status_code != 200) {
+			return std::unexpected("Remote cache answered HTTP " + std::to_string(response.status_code));
+		}
+		return std::move(response.text);
+	}
+
+	std::expected<void, std::string> HttpBackend::put(Kind kind, const std::string& key, std::string_view data) {
+		if (unavailable) {
+			return std::unexpected(UNAVAILABLE);
+		}
+
+		const auto response = cpr::Put(cpr::Url{url_of(kind, key)}, cpr::Body{std::string(data)}, cpr::Header{{"Content-Type", "application/octet-stream"}}, cpr::Timeout{timeout}, cpr::ConnectTimeout{connectTimeout});
+		if (response.error) {
+			return std::unexpected(unreachable(response.error.message));
+		}
+		if (response.status_code < 200 || response.status_code >= 300) {
+			return std::unexpected("Remote cache refused '" + key + "' with HTTP " + std::to_string(response.status_code));
+		}
+		return {};
+	}
+
+	bool HttpBackend::contains(Kind kind, const std::string& key) {
+		if (unavailable) {
+			return false;
+		}
+
+		const auto response = cpr::Head(cpr::Url{url_of(kind, key)}, cpr::Timeout{timeout}, cpr::ConnectTimeout{connectTimeout});
+		if (response.error) {
+			unreachable(response.error.message);
+			return false;
+		}
+		return response.status_code == 200;
+	}
+
+	bool HttpBackend::available() const {
+		return !unavailable;
+	}
+
+	std::string HttpBackend::url_of(Kind kind, const std::string& key) const {
+		return url + "/" + kind_to_string(kind) + "/" + key;
+	}
+
+	std::string HttpBackend::unreachable(const std::string& reason) {
+		auto message = "Failed to reach the remote cache: " + reason;
+		if (!unavailable.exchange(true)) {
+			spdlog::warn("{}; running without it from now on", message);
+		}
+		return message;
+	}
+} // namespace xxlib::action_cache
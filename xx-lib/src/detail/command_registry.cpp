@@ -0,0 +1,209 @@
+#include "detail/command_registry.hpp"
+#include "detail/hash.hpp"
+#include "detail/planner.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace xxlib {
+	namespace {
+		size_t edit_distance(std::string_view a, std::string_view b) {
+			std::vector<size_t> row(b.size() + 1);
+			for (size_t j = 0; j <= b.size(); ++j) {
+				row[j] = j;
+			}
+
+			for (size_t i = 1; i <= a.size(); ++i) {
+				auto diagonal = row[0];
+				row[0] = i;
+				for (size_t j = 1; j <= b.size(); ++j) {
+					const auto above = row[j];
+					row[j] = std::min({above + 1, row[j - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+					diagonal = above;
+				}
+			}
+
+			return row[b.size()];
+		}
+
+		// Bit-parallel Levenshtein distance (Myers/Hyyrö) for patterns of up to 64 characters: one pass over the
+		// text with a handful of word operations per character.
+		class PatternDistance {
+		  public:
+			explicit PatternDistance(std::string_view pattern) : pattern(pattern) {
+				if (pattern.size() > 64) {
+					return;
+				}
+				for (size_t i = 0; i < pattern.size(); ++i) {
+					masks[static_cast<unsigned char>(pattern[i])] |= uint64_t{1} << i;
+				}
+			}
+
+			[[nodiscard]] size_t operator()(std::string_view text) const {
+				if (pattern.empty() || pattern.size() > 64) {
+					return edit_distance(pattern, text);
+				}
+
+				const auto last = uint64_t{1} << (pattern.size() - 1);
+				uint64_t positive = ~uint64_t{0};
+				uint64_t negative = 0;
+				auto distance = pattern.size();
+
+				for (const auto c : text) {
+					const auto equal = masks[static_cast<unsigned char>(c)];
+					const auto x = equal | negative;
+					const auto diagonal = (((equal & positive) + positive) ^ positive) | equal | negative;
+					auto horizontalPositive = negative | ~(diagonal | positive);
+					const auto horizontalNegative = positive & diagonal;
+
+					if (horizontalPositive & last) {
+						++distance;
+					} else if (horizontalNegative & last) {
+						--distance;
+					}
+
+					horizontalPositive = (horizontalPositive << 1) | 1;
+					positive = (horizontalNegative << 1) | ~(x | horizontalPositive);
+					negative = horizontalPositive & x;
+				}
+
+				return distance;
+			}
+
+		  private:
+			std::string_view pattern;
+			std::array<uint64_t, 256> masks{};
+		};
+	} // namespace
+
+	CommandRegistry::CommandRegistry(std::vector<Command> commands) : commandList(std::move(commands)) {
+		// At most half of the slots are used, which keeps probe sequences short.
+		slots.resize(std::bit_ceil(std::max<size_t>(8, commandList.size() * 2)));
+
+		std::vector<uint32_t> slotOfCommand(commandList.size());
+		for (size_t i = 0; i < commandList.size(); ++i) {
+			const auto& name = commandList[i].name;
+			const auto hash = xxlib::hash::fnv1a64(name);
+			const auto slotIndex = find_slot(name, hash);
+
+			auto& slot = slots[slotIndex];
+			if (slot.count == 0) {
+				slot.hash = hash;
+				slot.first = static_cast<uint32_t>(i);
+			}
+			++slot.count;
+			slotOfCommand[i] = static_cast<uint32_t>(slotIndex);
+		}
+
+		// Candidates of each name are laid out contiguously in order, names in order of first appearance.
+		uint32_t offset = 0;
+		for (size_t i = 0; i < commandList.size(); ++i) {
+			auto& slot = slots[slotOfCommand[i]];
+			if (slot.first == i) {
+				slot.begin = offset;
+				offset += slot.count;
+			}
+		}
+
+		order.resize(commandList.size());
+		std::vector<uint32_t> filled(slots.size(), 0);
+		for (size_t i = 0; i < commandList.size(); ++i) {
+			const auto slotIndex = slotOfCommand[i];
+			order[slots[slotIndex].begin + filled[slotIndex]++] = static_cast<uint32_t>(i);
+		}
+
+		satisfiedStates.resize(commandList.size(), Satisfied::Unknown);
+
+		for (const auto& slot : slots) {
+			if (slot.count != 0) {
+				sortedNames.push_back(slot.first);
+			}
+		}
+		std::sort(sortedNames.begin(), sortedNames.end(), [this](uint32_t a, uint32_t b) {
+			return commandList[a].name < commandList[b].name;
+		});
+
+		namesByLength = sortedNames;
+		std::sort(namesByLength.begin(), namesByLength.end(), [this](uint32_t a, uint32_t b) {
+			const auto& left = commandList[a].name;
+			const auto& right = commandList[b].name;
+			return left.size() != right.size() ? left.size() < right.size() : left < right;
+		});
+	}
+
+	const std::vector<Command>& CommandRegistry::commands() const {
+		return commandList;
+	}
+
+	std::span<const uint32_t> CommandRegistry::candidates(std::string_view name) const {
+		if (slots.empty()) {
+			return {};
+		}
+
+		const auto& slot = slots[find_slot(name, xxlib::hash::fnv1a64(name))];
+		return std::span<const uint32_t>(order).subspan(slot.begin, slot.count);
+	}
+
+	bool CommandRegistry::satisfied(size_t index) const {
+		auto& state = satisfiedStates[index];
+		if (state == Satisfied::Unknown) {
+			state = xxlib::planner::matches_constraints(commandList[index]) ? Satisfied::Yes : Satisfied::No;
+		}
+		return state == Satisfied::Yes;
+	}
+
+	std::vector<std::string_view> CommandRegistry::names_with_prefix(std::string_view prefix) const {
+		const auto first = std::lower_bound(sortedNames.begin(), sortedNames.end(), prefix, [this](uint32_t index, std::string_view value) {
+			return std::string_view(commandList[index].name) < value;
+		});
+
+		std::vector<std::string_view> names;
+		for (auto it = first; it != sortedNames.end() && commandList[*it].name.starts_with(prefix); ++it) {
+			names.emplace_back(commandList[*it].name);
+		}
+		return names;
+	}
+
+	std::vector<std::string_view> CommandRegistry::suggestions(std::string_view name, size_t maxDistance, size_t limit) const {
+		// The distance is at least the difference in length, so only that band of names is compared.
+		const auto shortest = name.size() > maxDistance ? name.size() - maxDistance : 0;
+		const auto first = std::lower_bound(namesByLength.begin(), namesByLength.end(), shortest, [this](uint32_t index, size_t length) {
+			return commandList[index].name.size() < length;
+		});
+
+		const auto distanceTo = PatternDistance(name);
+		std::vector<std::pair<size_t, std::string_view>> found;
+		for (auto it = first; it != namesByLength.end() && commandList[*it].name.size() <= name.size() + maxDistance; ++it) {
+			const std::string_view candidate = commandList[*it].name;
+			if (const auto distance = distanceTo(candidate); distance <= maxDistance) {
+				found.emplace_back(distance, candidate);
+			}
+		}
+
+		const auto kept = std::min(limit, found.size());
+		std::partial_sort(found.begin(), found.begin() + kept, found.end());
+
+		std::vector<std::string_view> names;
+		names.reserve(kept);
+		for (size_t i = 0; i < kept; ++i) {
+			names.push_back(found[i].second);
+		}
+		return names;
+	}
+
+	size_t CommandRegistry::find_slot(std::string_view name, uint64_t hash) const {
+		const auto mask = slots.size() - 1;
+		auto index = static_cast<size_t>(hash) & mask;
+
+		// Linear probing; the table is never full, so this stops at an empty slot at the latest.
+		while (slots[index].count != 0) {
+			const auto& slot = slots[index];
+			if (slot.hash == hash && commandList[slot.first].name == name) {
+				return index;
+			}
+			index = (index + 1) & mask;
+		}
+		return index;
+	}
+} // namespace xxlib
@@ -0,0 +1,319 @@
+#include "detail/completion.hpp"
+#include "detail/loader.hpp"
+#include "detail/mapped_file.hpp"
+#include "detail/serializer.hpp"
+#include "xxlib.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <unordered_set>
+
+namespace xxlib::completion {
+	namespace {
+		constexpr std::string_view SUBCOMMANDS = "run pick list compile version check-updates user-config-path completion";
+
+		constexpr std::string_view BASH_SCRIPT = R"(# bash completion for xx, load with: source <(xx completion bash)
+_xx_complete() {
+	local i run=0
+	for ((i = 1; i < COMP_CWORD; i++)); do
+		if [[ "${COMP_WORDS[i]}" == run ]]; then
+			run=$i
+			break
+		fi
+	done
+
+	if ((run == 0)); then
+		COMPREPLY=($(compgen -W "@SUBCOMMANDS@" -- "${COMP_WORDS[COMP_CWORD]}"))
+		return
+	fi
+
+	local IFS=$'\n'
+	COMPREPLY=($(xx "${COMP_WORDS[@]:1:run-1}" __complete "${COMP_WORDS[@]:run+1:COMP_CWORD-run}" 2>/dev/null))
+	if [[ "${COMPREPLY[0]}" == *= ]]; then
+		compopt -o nospace
+	fi
+}
+complete -F _xx_complete xx
+)";
+
+		constexpr std::string_view ZSH_SCRIPT = R"(#compdef xx
+# zsh completion for xx, load with: source <(xx completion zsh)
+_xx() {
+	local -a results
+	local run=${words[(i)run]}
+
+	if (( run >= CURRENT )); then
+		results=(@SUBCOMMANDS@)
+		compadd -a results
+		return
+	fi
+
+	results=("${(@f)$(xx "${(@)words[2,run-1]}" __complete "${(@)words[run+1,CURRENT]}" 2>/dev/null)}")
+	if [[ ${results[1]} == *= ]]; then
+		compadd -S '' -a results
+	else
+		compadd -a results
+	fi
+}
+compdef _xx xx
+)";
+
+		constexpr std::string_view FISH_SCRIPT = R"(# fish completion for xx, load with: xx completion fish | source
+function __xx_complete
+	set -l tokens (commandline -opc)
+	set -l run (contains -i -- run $tokens)
+
+	if test -z "$run"
+		string split ' ' -- '@SUBCOMMANDS@'
+		return
+	end
+
+	set -l globals
+	if test $run -gt 2
+		set globals $tokens[2..(math $run - 1)]
+	end
+	set -l arguments
+	if test $run -lt (count $tokens)
+		set arguments $tokens[(math $run + 1)..-1]
+	end
+
+	xx $globals __complete $arguments (commandline -ct) 2>/dev/null
+end
+complete -c xx -f -a '(__xx_complete)'
+)";
+
+		bool read_index(const std::string& path, const std::string& cacheDirectory, std::unordered_set<std::string>& visited, std::vector<Entry>& entries, std::string& error) {
+			const auto stamp = xxlib::cache::stat_source(path);
+			if (!stamp) {
+				return true;
+			}
+			if (!visited.insert(stamp->path).second) {
+				return true;
+			}
+
+			const auto indexPath = index_path(xxlib::cache::entry_path(cacheDirectory, path));
+			const auto file = xxlib::MappedFile::open(indexPath);
+			if (!file) {
+				error = "No completion index for " + path;
+				return false;
+			}
+
+			auto reader = xxlib::serializer::Reader{.data = file->view()};
+			if (reader.u32() != MAGIC || reader.u32() != xxlib::cache::FORMAT_VERSION || reader.str_view() != xxlib::version()) {
+				error = "Completion index has an incompatible format: " + indexPath;
+				return false;
+			}
+
+			const auto indexedPath = reader.str_view();
+			const auto size = reader.u64();
+			const auto mtime = reader.i64();
+			if (!reader.ok || indexedPath != stamp->path || size != stamp->size || mtime != stamp->mtime) {
+				error = "Completion index is stale: " + indexPath;
+				return false;
+			}
+
+			const auto includeCount = reader.u32();
+			if (includeCount > reader.remaining() / 4) {
+				error = "Completion index is corrupted: " + indexPath;
+				return false;
+			}
+			std::vector<std::string> includes;
+			includes.reserve(includeCount);
+			for (uint32_t i = 0; i < includeCount; ++i) {
+				includes.emplace_back(reader.str());
+			}
+
+			const auto entryCount = reader.u32();
+			if (entryCount > reader.remaining() / 12) {
+				error = "Completion index is corrupted: " + indexPath;
+				return false;
+			}
+			for (uint32_t i = 0; i < entryCount && reader.ok; ++i) {
+				auto& entry = entries.emplace_back();
+				entry.name = reader.str();
+				entry.constraintMask = reader.u32();
+
+				const auto varCount = reader.u32();
+				if (varCount > reader.remaining() / 4) {
+					reader.ok = false;
+					break;
+				}
+				entry.templateVars.reserve(varCount);
+				for (uint32_t j = 0; j < varCount; ++j) {
+					entry.templateVars.emplace_back(reader.str());
+				}
+			}
+			if (!reader.ok) {
+				error = "Completion index is corrupted: " + indexPath;
+				return false;
+			}
+
+			if (includes.empty()) {
+				return true;
+			}
+
+			const auto children = xxlib::loader::resolve_includes(path, includes);
+			if (!children) {
+				error = children.error();
+				return false;
+			}
+			for (const auto& child : *children) {
+				if (!read_index(child, cacheDirectory, visited, entries, error)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		std::string with_subcommands(std::string_view script) {
+			constexpr std::string_view PLACEHOLDER = "@SUBCOMMANDS@";
+
+			auto text = std::string(script);
+			if (const auto position = text.find(PLACEHOLDER); position != std::string::npos) {
+				text.replace(position, PLACEHOLDER.size(), SUBCOMMANDS);
+			}
+			return text;
+		}
+	} // namespace
+
+	Shell string_to_shell(const std::string& shell) {
+		if (shell == "zsh") {
+			return Shell::Zsh;
+		} else if (shell == "fish") {
+			return Shell::Fish;
+		} else {
+			return Shell::Bash;
+		}
+	}
+
+	std::vector<Entry> entries_of(const std::vector<Command>& commands) {
+		std::vector<Entry> entries;
+		entries.reserve(commands.size());
+		for (const auto& command : commands) {
+			auto& entry = entries.emplace_back(Entry{.name = command.name, .constraintMask = command.constraintMask});
+			entry.templateVars.reserve(command.templateVars.size());
+			for (const auto& [key, value] : command.templateVars) {
+				entry.templateVars.push_back(key);
+			}
+		}
+		return entries;
+	}
+
+	std::string index_path(const std::string& cacheEntryPath) {
+		return std::filesystem::path(cacheEntryPath).replace_extension(".xxn").string();
+	}
+
+	std::expected<void, std::string> write_index(const std::string& cacheEntryPath, const xxlib::cache::SourceStamp& stamp, const xxlib::parser::Document& document) {
+		xxlib::serializer::Writer writer;
+		writer.u32(MAGIC);
+		writer.u32(xxlib::cache::FORMAT_VERSION);
+		writer.str(xxlib::version());
+		writer.str(stamp.path);
+		writer.u64(stamp.size);
+		writer.i64(stamp.mtime);
+
+		writer.u32(static_cast<uint32_t>(document.includes.size()));
+		for (const auto& include : document.includes) {
+			writer.str(include);
+		}
+
+		writer.u32(static_cast<uint32_t>(document.commands.size()));
+		for (const auto& command : document.commands) {
+			writer.str(command.name);
+			writer.u32(command.constraintMask);
+			writer.u32(static_cast<uint32_t>(command.templateVars.size()));
+			for (const auto& [key, value] : command.templateVars) {
+				writer.str(key);
+			}
+		}
+
+		return xxlib::cache::write_atomic(index_path(cacheEntryPath), writer.buffer);
+	}
+
+	std::expected<std::vector<Entry>, std::string> read_indexed(const std::vector<std::string>& paths, const std::string& cacheDirectory) {
+		std::vector<Entry> entries;
+		std::unordered_set<std::string> visited;
+		std::string error;
+
+		for (const auto& path : paths) {
+			if (path == "-") {
+				return std::unexpected("Configuration read from stdin has no completion index");
+			}
+			if (!read_index(path, cacheDirectory, visited, entries, error)) {
+				return std::unexpected(error);
+			}
+		}
+
+		return entries;
+	}
+
+	std::vector<std::string> complete(const std::vector<Entry>& entries, const std::vector<std::string>& words) {
+		std::vector<std::string_view> arguments;
+		for (size_t i = 0; i < words.size(); ++i) {
+			if (i + 1 == words.size() || !words[i].starts_with('-')) {
+				arguments.emplace_back(words[i]);
+			}
+		}
+
+		const auto current = arguments.empty() ? std::string_view{} : arguments.back();
+
+		// The alias whose arguments are being typed is the last word before the current one that is not 'k=v'.
+		auto alias = arguments.size();
+		for (size_t i = arguments.size() - (arguments.empty() ? 0 : 1); i-- > 0;) {
+			if (arguments[i].find('=') == std::string_view::npos || arguments[i].find('[') != std::string_view::npos) {
+				alias = i;
+				break;
+			}
+		}
+
+		std::vector<std::string> results;
+		// After an alias, another alias name is only offered once its first character is typed.
+		if (alias == arguments.size() || !current.empty()) {
+			// Aliases unavailable on this platform are left out; dynamic constraints are not probed.
+			for (const auto& entry : entries) {
+				const auto available = entry.constraintMask == xxlib::constraint::NOT_COMPILED || xxlib::constraint::matches(entry.constraintMask);
+				if (available && entry.name.starts_with(current)) {
+					results.push_back(entry.name);
+				}
+			}
+		}
+
+		if (alias != arguments.size()) {
+			const auto aliasName = arguments[alias].substr(0, arguments[alias].find('['));
+			for (const auto& entry : entries) {
+				if (entry.name != aliasName) {
+					continue;
+				}
+
+				for (const auto& key : entry.templateVars) {
+					auto candidate = key + "=";
+					const auto given = std::any_of(arguments.begin() + static_cast<std::ptrdiff_t>(alias) + 1, arguments.end() - 1, [&candidate](std::string_view argument) {
+						return argument.starts_with(candidate);
+					});
+					if (!given && candidate.starts_with(current)) {
+						results.push_back(std::move(candidate));
+					}
+				}
+			}
+		}
+
+		std::sort(results.begin(), results.end());
+		results.erase(std::unique(results.begin(), results.end()), results.end());
+		return results;
+	}
+
+	std::string_view script(Shell shell) {
+		static const auto bash = with_subcommands(BASH_SCRIPT);
+		static const auto zsh = with_subcommands(ZSH_SCRIPT);
+		static const auto fish = with_subcommands(FISH_SCRIPT);
+
+		switch (shell) {
+		case Shell::Zsh:
+			return zsh;
+		case Shell::Fish:
+			return fish;
+		default:
+			return bash;
+		}
+	}
+} // namespace xxlib::completion
@@ -0,0 +1,226 @@
+#include "detail/constraint.hpp"
+#include "detail/platform.hpp"
+#include "detail/probes.hpp"
+
+#include <array>
+#include <string_view>
+
+namespace xxlib::constraint {
+	namespace {
+		struct Value {
+			std::string_view name;
+			Mask bit;
+		};
+
+		struct Dimension {
+			std::string_view key;
+			Mask all;
+			std::array<Value, 3> values;
+		};
+
+		// Value names match the platform::*_to_string spellings.
+		constexpr std::array DIMENSIONS{
+			Dimension{"os", OS_ALL, {Value{"windows", OS_WINDOWS}, Value{"macos", OS_MACOS}, Value{"linux", OS_LINUX}}},
+			Dimension{"arch", ARCH_ALL, {Value{"x86_64", ARCH_X86_64}, Value{"arm64", ARCH_ARM64}}},
+			Dimension{"osfamily", FAMILY_ALL, {Value{"windows", FAMILY_WINDOWS}, Value{"unix", FAMILY_UNIX}}},
+		};
+
+		constexpr std::string_view NEGATION_PREFIX = "not_";
+
+		constexpr std::array<std::string_view, 3> DYNAMIC_KEYS{"env", "exists", "which"};
+
+		bool is_dynamic(std::string_view key) {
+			for (const auto& dynamicKey : DYNAMIC_KEYS) {
+				if (dynamicKey == key) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		std::string_view trim(std::string_view item) {
+			while (!item.empty() && item.front() == ' ') {
+				item.remove_prefix(1);
+			}
+			while (!item.empty() && item.back() == ' ') {
+				item.remove_suffix(1);
+			}
+			return item;
+		}
+
+		// Calls visit with every comma-separated alternative of value until it returns true.
+		template <typename Visit>
+		bool any_value(std::string_view value, Visit&& visit) {
+			size_t start = 0;
+			while (start <= value.size()) {
+				auto end = value.find(',', start);
+				if (end == std::string_view::npos) {
+					end = value.size();
+				}
+
+				if (visit(trim(value.substr(start, end - start)))) {
+					return true;
+				}
+
+				start = end + 1;
+			}
+			return false;
+		}
+
+		bool probe(std::string_view key, std::string_view argument) {
+			if (key == "env") {
+				const auto separator = argument.find('=');
+				const auto value = xxlib::probes::env(argument.substr(0, separator));
+				if (separator == std::string_view::npos) {
+					return value && !value->empty();
+				}
+				return value && *value == argument.substr(separator + 1);
+			}
+			if (key == "exists") {
+				return xxlib::probes::exists(argument);
+			}
+			return xxlib::probes::which(argument);
+		}
+
+		const Dimension* find_dimension(std::string_view key) {
+			for (const auto& dimension : DIMENSIONS) {
+				if (dimension.key == key) {
+					return &dimension;
+				}
+			}
+			return nullptr;
+		}
+
+		Mask value_bits(const Dimension& dimension, std::string_view value, std::vector<std::string>& warnings) {
+			Mask bits = 0;
+
+			any_value(value, [&](std::string_view item) {
+				auto known = false;
+				for (const auto& candidate : dimension.values) {
+					if (!candidate.name.empty() && candidate.name == item) {
+						bits |= candidate.bit;
+						known = true;
+					}
+				}
+				if (!known) {
+					warnings.emplace_back("Unknown " + std::string(dimension.key) + " '" + std::string(item) + "' never matches");
+				}
+				return false;
+			});
+
+			return bits;
+		}
+	} // namespace
+
+	Mask compile(const std::vector<std::pair<std::string, std::string>>& constraints, std::vector<std::string>& warnings) {
+		auto mask = ALL;
+
+		for (const auto& [rawKey, value] : constraints) {
+			std::string_view key = rawKey;
+
+			const auto negated = key.starts_with(NEGATION_PREFIX);
+			if (negated) {
+				key.remove_prefix(NEGATION_PREFIX.size());
+			}
+
+			if (is_dynamic(key)) {
+				if (value.empty()) {
+					warnings.emplace_back("Constraint '" + rawKey + "' needs a value");
+				}
+				mask |= DYNAMIC;
+				continue;
+			}
+
+			const auto* dimension = find_dimension(key);
+			if (!dimension) {
+				warnings.emplace_back("Unknown constraint '" + rawKey + "' makes the alias unavailable everywhere");
+				return UNSATISFIABLE;
+			}
+
+			auto allowed = value_bits(*dimension, value, warnings);
+			if (negated) {
+				allowed = dimension->all & ~allowed;
+			}
+
+			// Several constraints on the same dimension must all hold.
+			mask &= ~dimension->all | allowed;
+		}
+
+		return mask;
+	}
+
+	Mask compile(const std::vector<std::pair<std::string, std::string>>& constraints) {
+		std::vector<std::string> warnings;
+		return compile(constraints, warnings);
+	}
+
+	bool matches_dynamic(const std::vector<std::pair<std::string, std::string>>& constraints) {
+		for (const auto& [rawKey, value] : constraints) {
+			std::string_view key = rawKey;
+
+			const auto negated = key.starts_with(NEGATION_PREFIX);
+			if (negated) {
+				key.remove_prefix(NEGATION_PREFIX.size());
+			}
+
+			if (!is_dynamic(key)) {
+				continue;
+			}
+
+			const auto found = any_value(value, [key](std::string_view argument) {
+				return !argument.empty() && probe(key, argument);
+			});
+			if (found == negated) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	Mask host_mask() {
+		static const Mask mask = [] {
+			Mask bits = 0;
+
+			switch (xxlib::platform::get_current_os()) {
+			case xxlib::platform::OS::Windows:
+				bits |= OS_WINDOWS;
+				break;
+			case xxlib::platform::OS::MacOS:
+				bits |= OS_MACOS;
+				break;
+			case xxlib::platform::OS::Linux:
+				bits |= OS_LINUX;
+				break;
+			default:
+				break;
+			}
+
+			switch (xxlib::platform::get_current_architecture()) {
+			case xxlib::platform::Architecture::x86_64:
+				bits |= ARCH_X86_64;
+				break;
+			case xxlib::platform::Architecture::arm64:
+				bits |= ARCH_ARM64;
+				break;
+			default:
+				break;
+			}
+
+			switch (xxlib::platform::get_current_os_family()) {
+			case xxlib::platform::OSFamily::Windows:
+				bits |= FAMILY_WINDOWS;
+				break;
+			case xxlib::platform::OSFamily::Unix:
+				bits |= FAMILY_UNIX;
+				break;
+			default:
+				break;
+			}
+
+			return bits;
+		}();
+
+		return mask;
+	}
+} // namespace xxlib::constraint
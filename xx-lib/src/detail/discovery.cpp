@@ -0,0 +1,226 @@
+#include "detail/discovery.hpp"
+#include "detail/cache.hpp"
+#include "detail/mapped_file.hpp"
+#include "detail/serializer.hpp"
+
+#include <filesystem>
+#include <system_error>
+#include <spdlog/spdlog.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace xxlib::discovery {
+	namespace {
+		struct CachedLookup {
+			std::string startDirectory{};
+			std::string configFile{};
+			bool firstOnly = false;
+			Lookup lookup{};
+		};
+
+#ifdef _WIN32
+		int64_t directory_mtime(const std::filesystem::path& directory) {
+			std::error_code ec;
+			const auto mtime = std::filesystem::last_write_time(directory, ec);
+			return ec ? -1 : static_cast<int64_t>(mtime.time_since_epoch().count());
+		}
+#else
+		int64_t stat_mtime(const struct stat& st) {
+#ifdef __APPLE__
+			return static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+			return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+		}
+
+		int64_t directory_mtime(const std::filesystem::path& directory) {
+			struct stat st{};
+			return ::stat(directory.c_str(), &st) == 0 ? stat_mtime(st) : -1;
+		}
+#endif
+
+		std::string lookups_path(const std::string& cacheDirectory) {
+			return (std::filesystem::path(cacheDirectory) / "discovery.xxd").string();
+		}
+
+		std::vector<CachedLookup> read_lookups(const std::string& path) {
+			std::vector<CachedLookup> lookups;
+
+			const auto file = xxlib::MappedFile::open(path);
+			if (!file) {
+				return lookups;
+			}
+
+			auto reader = xxlib::serializer::Reader{.data = file->view()};
+			if (reader.u32() != MAGIC || reader.u32() != FORMAT_VERSION) {
+				return lookups;
+			}
+
+			const auto count = reader.u32();
+			for (uint32_t i = 0; i < count && reader.ok; ++i) {
+				CachedLookup cached;
+				cached.startDirectory = reader.str();
+				cached.configFile = reader.str();
+				cached.firstOnly = reader.u8() != 0;
+
+				const auto configCount = reader.u32();
+				for (uint32_t j = 0; j < configCount && reader.ok; ++j) {
+					cached.lookup.configs.emplace_back(reader.str());
+				}
+
+				const auto directoryCount = reader.u32();
+				for (uint32_t j = 0; j < directoryCount && reader.ok; ++j) {
+					auto directory = reader.str();
+					cached.lookup.directories.emplace_back(std::move(directory), reader.i64());
+				}
+
+				if (reader.ok) {
+					lookups.emplace_back(std::move(cached));
+				}
+			}
+
+			return lookups;
+		}
+
+		void write_lookups(const std::string& path, const std::vector<CachedLookup>& lookups) {
+			xxlib::serializer::Writer writer;
+			writer.u32(MAGIC);
+			writer.u32(FORMAT_VERSION);
+			writer.u32(static_cast<uint32_t>(lookups.size()));
+
+			for (const auto& cached : lookups) {
+				writer.str(cached.startDirectory);
+				writer.str(cached.configFile);
+				writer.u8(cached.firstOnly ? 1 : 0);
+
+				writer.u32(static_cast<uint32_t>(cached.lookup.configs.size()));
+				for (const auto& config : cached.lookup.configs) {
+					writer.str(config);
+				}
+
+				writer.u32(static_cast<uint32_t>(cached.lookup.directories.size()));
+				for (const auto& [directory, mtime] : cached.lookup.directories) {
+					writer.str(directory);
+					writer.i64(mtime);
+				}
+			}
+
+			if (const auto written = xxlib::cache::write_atomic(path, writer.buffer); !written) {
+				spdlog::debug("Failed to store discovery cache: {}", written.error());
+			}
+		}
+
+		bool is_fresh(const Lookup& lookup) {
+			for (const auto& [directory, mtime] : lookup.directories) {
+				if (directory_mtime(directory) != mtime) {
+					return false;
+				}
+			}
+			return true;
+		}
+	} // namespace
+
+	Lookup find_configs(const std::string& startDirectory, const std::string& configFile, bool firstOnly) {
+		Lookup lookup;
+
+		std::error_code ec;
+		auto currentPath = std::filesystem::absolute(startDirectory, ec).lexically_normal();
+		if (ec) {
+			spdlog::debug("Failed to resolve start directory {}: {}", startDirectory, ec.message());
+			return lookup;
+		}
+		if (!currentPath.has_filename() && currentPath != currentPath.root_path()) {
+			currentPath = currentPath.parent_path();
+		}
+
+#ifdef _WIN32
+		while (true) {
+			lookup.directories.emplace_back(currentPath.string(), directory_mtime(currentPath));
+
+			const auto configPath = currentPath / configFile;
+			if (std::filesystem::is_regular_file(configPath, ec)) {
+				lookup.configs.emplace_back(configPath.string());
+				if (firstOnly) {
+					break;
+				}
+			}
+
+			if (!currentPath.has_parent_path() || currentPath == currentPath.parent_path()) {
+				break;
+			}
+			currentPath = currentPath.parent_path();
+		}
+#else
+		// Each level costs one fstatat and one openat relative to the previous directory descriptor.
+		auto directoryFd = ::open(currentPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (directoryFd == -1) {
+			spdlog::debug("Failed to open directory {}", currentPath.string());
+			return lookup;
+		}
+
+		while (true) {
+			struct stat directoryStat{};
+			lookup.directories.emplace_back(currentPath.string(), fstat(directoryFd, &directoryStat) == 0 ? stat_mtime(directoryStat) : -1);
+
+			struct stat configStat{};
+			if (fstatat(directoryFd, configFile.c_str(), &configStat, 0) == 0 && S_ISREG(configStat.st_mode)) {
+				lookup.configs.emplace_back((currentPath / configFile).string());
+				if (firstOnly) {
+					break;
+				}
+			}
+
+			if (!currentPath.has_parent_path() || currentPath == currentPath.parent_path()) {
+				break;
+			}
+
+			const auto parentFd = openat(directoryFd, "..", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+			::close(directoryFd);
+			directoryFd = parentFd;
+			if (directoryFd == -1) {
+				spdlog::debug("Failed to open parent directory of {}", currentPath.string());
+				return lookup;
+			}
+
+			currentPath = currentPath.parent_path();
+		}
+
+		::close(directoryFd);
+#endif
+
+		return lookup;
+	}
+
+	std::vector<std::string> find_configs_cached(const std::string& startDirectory, const std::string& configFile, bool firstOnly, const std::string& cacheDirectory) {
+		const auto path = lookups_path(cacheDirectory);
+		auto lookups = read_lookups(path);
+
+		for (auto it = lookups.begin(); it != lookups.end(); ++it) {
+			if (it->startDirectory == startDirectory && it->configFile == configFile && it->firstOnly == firstOnly) {
+				if (is_fresh(it->lookup)) {
+					spdlog::debug("Reusing cached configuration lookup for {}", startDirectory);
+					return it->lookup.configs;
+				}
+
+				lookups.erase(it);
+				break;
+			}
+		}
+
+		auto lookup = find_configs(startDirectory, configFile, firstOnly);
+		auto configs = lookup.configs;
+
+		// Most recent lookups are kept at the front and the oldest ones fall off the end.
+		lookups.insert(lookups.begin(), CachedLookup{.startDirectory = startDirectory, .configFile = configFile, .firstOnly = firstOnly, .lookup = std::move(lookup)});
+		if (lookups.size() > MAX_CACHED_LOOKUPS) {
+			lookups.resize(MAX_CACHED_LOOKUPS);
+		}
+		write_lookups(path, lookups);
+
+		return configs;
+	}
+} // namespace xxlib::discovery
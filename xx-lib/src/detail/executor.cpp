@@ -2,11 +2,116 @@
 #include "detail/executors/platform_executor.hpp"
 #include "detail/executors/lua_executor.hpp"
 #include "detail/executors/dotnet_run_executor.hpp"
+#include "detail/action_cache.hpp"
 #include "detail/command.hpp"
+#include "detail/incremental.hpp"
+#include "detail/thread_pool.hpp"
 
+#include <cstdio>
+#include <filesystem>
+#include <future>
+#include <mutex>
 #include <stdexcept>
+#include <spdlog/spdlog.h>
 
 namespace xxlib::executor {
+	namespace {
+		// Shared by every alias of a run, so inputs they have in common are looked at once.
+		xxlib::incremental::StatCache stats;
+
+		// Uploads of aliases that finished, sent while the next ones run.
+		std::mutex uploadsMutex;
+		std::vector<std::future<void>> uploads;
+
+		xxlib::ThreadPool& upload_pool() {
+			static xxlib::ThreadPool pool(2);
+			return pool;
+		}
+
+		std::expected<int32_t, std::string> dispatch(Command& command, CommandContext& context) {
+			if (command.executionEngine == Engine::System) {
+				return xxlib::platform_executor::execute_command(command, context);
+			} else if (command.executionEngine == Engine::Lua) {
+				return xxlib::lua_executor::execute_command(command, context);
+			} else if (command.executionEngine == Engine::DotnetRun) {
+				return xxlib::dotnet_run_executor::execute_command(command, context);
+			} else {
+				return std::unexpected("Unknown execution engine");
+			}
+		}
+
+		void print(std::string_view text, const std::function<void(std::string_view)>& output) {
+			if (output) {
+				output(text);
+				return;
+			}
+			std::fwrite(text.data(), 1, text.size(), stdout);
+			std::fflush(stdout);
+		}
+
+		// Replays an identical earlier run from the action cache, or runs the alias and stores what it did.
+		std::expected<int32_t, std::string> run_cached(Command& command, CommandContext& context) {
+			if (!command.cacheResults || !context.actionCache || !context.actionCache->available() || context.dryRun || command.requiresConfirmation) {
+				return dispatch(command, context);
+			}
+
+			const auto base = std::filesystem::current_path();
+			const auto key = xxlib::action_cache::action_key(command, context.extras, base);
+			if (!key) {
+				spdlog::debug("Not caching '{}': {}", command.name, key.error());
+				return dispatch(command, context);
+			}
+
+			if (!context.force) {
+				if (const auto entry = xxlib::action_cache::lookup(*context.actionCache, *key)) {
+					if (const auto restored = xxlib::action_cache::restore(*context.actionCache, base, *entry)) {
+						spdlog::info("'{}' restored from the action cache", command.name);
+						print(entry->log, context.output);
+						return entry->exitCode;
+					} else {
+						spdlog::debug("Failed to restore '{}': {}", command.name, restored.error());
+					}
+				} else {
+					spdlog::debug("Action cache miss for '{}': {}", command.name, entry.error());
+				}
+			}
+
+			// The output still reaches its destination as it arrives, it is only recorded on the way.
+			auto entry = xxlib::action_cache::Entry{};
+			const auto destination = std::move(context.output);
+			context.output = [&entry, &destination](std::string_view chunk) {
+				entry.log.append(chunk);
+				print(chunk, destination);
+			};
+			const auto result = dispatch(command, context);
+			context.output = destination;
+
+			// Failures are not stored, so a flaky one is not replayed. Nor is anything once the lookup found the backend
+			// gone.
+			if (!result || *result != 0 || !context.actionCache->available()) {
+				return result;
+			}
+
+			// Outputs are read now, before a later alias can change them; only sending them waits.
+			entry.exitCode = *result;
+			auto prepared = xxlib::action_cache::prepare(base, *key, std::move(entry), command.outputs);
+			if (!prepared) {
+				spdlog::warn("Failed to cache the result of '{}': {}", command.name, prepared.error());
+				return result;
+			}
+
+			auto uploaded = upload_pool().submit([backend = context.actionCache, upload = std::move(*prepared), name = command.name]() {
+				// A backend that gave up has already said so once.
+				if (const auto sent = xxlib::action_cache::upload(*backend, upload); !sent && backend->available()) {
+					spdlog::warn("Failed to cache the result of '{}': {}", name, sent.error());
+				}
+			});
+			std::lock_guard lock(uploadsMutex);
+			uploads.push_back(std::move(uploaded));
+			return result;
+		}
+	} // namespace
+
 	Engine string_to_execution_engine(const std::string& executorStr) {
 		if (executorStr == "system") {
 			return Engine::System;
@@ -19,15 +124,60 @@ namespace xxlib::executor {
 		}
 	}
 
+	std::string execution_engine_to_string(Engine executionEngine) {
+		switch (executionEngine) {
+		case Engine::Lua:
+			return "lua";
+		case Engine::DotnetRun:
+			return "dotnet_run";
+		default:
+			return "system";
+		}
+	}
+
+	void wait_for_uploads() {
+		std::vector<std::future<void>> pending;
+		{
+			std::lock_guard lock(uploadsMutex);
+			pending.swap(uploads);
+		}
+		for (auto& upload : pending) {
+			upload.get();
+		}
+	}
+
 	std::expected<int32_t, std::string> execute_command(Command& command, CommandContext& context) {
-		if (command.executionEngine == Engine::System) {
-			return xxlib::platform_executor::execute_command(command, context);
-		} else if (command.executionEngine == Engine::Lua) {
-			return xxlib::lua_executor::execute_command(command, context);
-		} else if (command.executionEngine == Engine::DotnetRun) {
-			return xxlib::dotnet_run_executor::execute_command(command, context);
-		} else {
-			return std::unexpected("Unknown execution engine");
+		if (context.stateDirectory.empty() || (command.inputs.empty() && command.outputs.empty())) {
+			return run_cached(command, context);
+		}
+
+		const auto options = xxlib::incremental::Options{
+			.stateDirectory = context.stateDirectory,
+			.base = std::filesystem::current_path(),
+			.hashContents = context.hashInputs,
+		};
+		const auto check = xxlib::incremental::check(command, context.extras, options, stats);
+		if (check.upToDate && !context.force) {
+			spdlog::info("'{}' is up to date", command.name);
+			return 0;
+		}
+		if (!check.upToDate) {
+			spdlog::debug("Running '{}': {}", command.name, check.reason);
+		}
+
+		const auto result = run_cached(command, context);
+		if (context.dryRun) {
+			return result;
+		}
+
+		// Whatever the alias wrote has to be looked at again.
+		stats.clear();
+		// A declined confirmation reports success as well, so only aliases that ran unasked are recorded.
+		if (result && *result == 0 && !command.requiresConfirmation) {
+			if (const auto stored = xxlib::incremental::store_state(check.statePath, check.state); !stored) {
+				spdlog::warn("Failed to record the state of '{}': {}", command.name, stored.error());
+			}
 		}
+		return result;
 	}
 } // namespace xxlib::executor
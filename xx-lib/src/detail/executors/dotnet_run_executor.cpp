@@ -76,6 +76,7 @@ namespace xxlib::dotnet_run_executor {
 		auto shellExecContext = CommandContext{
 			.dryRun = false,
 			.extras = {},
+			.output = context.output,
 		};
 
 		return xxlib::platform_executor::execute_command(shellExecCommand, shellExecContext);
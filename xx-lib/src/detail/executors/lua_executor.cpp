@@ -11,7 +11,7 @@
 #include <spdlog/spdlog.h>
 
 namespace xxlib::lua_executor {
-	void push_as_table(xxlib::luavm::LuaStatePtr& state, const std::unordered_map<std::string, std::string>& map, const std::string& tableName) {
+	void push_as_table(xxlib::luavm::LuaStatePtr& state, const xxlib::StringMap& map, const std::string& tableName) {
 		xxlib::luavm::new_table(state);
 		for (const auto& [key, value] : map) {
 			xxlib::luavm::push_string(state, key);
@@ -31,6 +31,20 @@ namespace xxlib::lua_executor {
 		xxlib::luavm::set_global(state, tableName);
 	}
 
+	std::expected<std::string, std::string> compile(const Command& command) {
+		if (command.renderEngine != xxlib::renderer::Engine::None) {
+			return std::unexpected("Commands with a render engine are rendered at run time");
+		}
+
+		std::string luaCommand;
+		for (const auto& part : command.cmd) {
+			luaCommand += part + " ";
+		}
+
+		auto state = xxlib::luavm::create();
+		return xxlib::luavm::dump(state, luaCommand);
+	}
+
 	std::expected<int32_t, std::string> execute_command(Command& command, CommandContext& context) {
 		const auto extrasResult = xxlib::helpers::split_extras(context.extras);
 		std::vector<std::string> positional;
@@ -81,6 +95,9 @@ namespace xxlib::lua_executor {
 		xxlib::luavm::add_json_library(state);
 		xxlib::luavm::add_cpr_library(state);
 		xxlib::luavm::add_fs_library(state);
+		if (context.output) {
+			xxlib::luavm::redirect_print(state, context.output);
+		}
 
 		push_as_table(state, command.templateVars, "TEMPLATE_VARS");
 		push_as_table(state, command.envs, "ENVS");
@@ -106,7 +123,18 @@ namespace xxlib::lua_executor {
 		}
 		xxlib::luavm::set_global(state, "CTX");
 
-		auto loadStatus = xxlib::luavm::loadstring(state, luaCommand);
+		auto loadStatus = 1;
+		if (!context.luaBytecode.empty() && command.renderEngine == xxlib::renderer::Engine::None) {
+			loadStatus = xxlib::luavm::loadbytecode(state, context.luaBytecode);
+			if (loadStatus != 0) {
+				spdlog::debug("Precompiled Lua chunk rejected, compiling from source: {}", xxlib::luavm::tostring(state));
+				xxlib::luavm::pop(state);
+			}
+		}
+
+		if (loadStatus != 0) {
+			loadStatus = xxlib::luavm::loadstring(state, luaCommand);
+		}
 		if (loadStatus != 0) {
 			return std::unexpected(std::string("Error executing Lua command: ") + xxlib::luavm::tostring(state));
 		}
@@ -143,6 +171,7 @@ namespace xxlib::lua_executor {
 			auto shellExecContext = CommandContext{
 				.dryRun = false,
 				.extras = {},
+				.output = context.output,
 			};
 
 			return xxlib::platform_executor::execute_command(shellExecCommand, shellExecContext);
@@ -2,14 +2,293 @@
 #include "detail/helpers.hpp"
 #include "detail/renderer.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <string>
 #include <sstream>
 #include <iostream>
 #include <cstdlib>
+#include <mutex>
+#include <csignal>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <spdlog/spdlog.h>
 
+extern char** environ;
+
 namespace xxlib::platform_executor {
+	namespace {
+		// Runs fullCommand with stdout and stderr merged into a pipe that is drained into output.
+		std::expected<int32_t, std::string> run_captured(const std::string& fullCommand, const std::function<void(std::string_view)>& output) {
+			// Redirecting in front covers every command of a compound line, not just the last one.
+			auto* pipe = popen(("exec 2>&1; " + fullCommand).c_str(), "r");
+			if (!pipe) {
+				return std::unexpected("Failed to execute command");
+			}
+
+			char chunk[4096];
+			size_t count = 0;
+			while ((count = std::fread(chunk, 1, sizeof(chunk), pipe)) > 0) {
+				output(std::string_view(chunk, count));
+			}
+
+			const auto returnCode = pclose(pipe);
+			spdlog::debug("Command exited with return code: {}", returnCode);
+			if (returnCode == -1) {
+				return std::unexpected("Failed to execute command");
+			}
+
+			return WEXITSTATUS(returnCode);
+		}
+
+		// Characters that mean the same to the shell and to execve; everything else makes the shell run the command.
+		bool is_plain(char c) {
+			return std::isalnum(static_cast<unsigned char>(c)) || std::strchr("_-+./,:@%=", c) != nullptr;
+		}
+
+		bool is_identifier(std::string_view name) {
+			if (name.empty() || std::isdigit(static_cast<unsigned char>(name.front()))) {
+				return false;
+			}
+			return std::all_of(name.begin(), name.end(), [](char c) {
+				return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+			});
+		}
+
+		// Some of these also exist as programs, but only the shell's versions do what a command line expects.
+		bool is_shell_builtin(std::string_view name) {
+			constexpr std::string_view BUILTINS[] = {"alias", "bg", "break", "cd", "command", "continue", "eval", "exec", "exit", "export", "fg", "getopts", "hash", "jobs", "read", "readonly", "return", "set", "shift", "source", "time", "times", "trap", "type", "ulimit", "umask", "unset", "wait"};
+			return std::find(std::begin(BUILTINS), std::end(BUILTINS), name) != std::end(BUILTINS);
+		}
+
+		bool is_executable(const std::string& path) {
+			struct stat info{};
+			return ::stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode) && ::access(path.c_str(), X_OK) == 0;
+		}
+
+		std::mutex interruptsMutex;
+		size_t interruptsIgnored = 0;
+		struct sigaction savedInterrupt{};
+		struct sigaction savedQuit{};
+
+		// Like std::system, ignores SIGINT and SIGQUIT while a child runs, so Ctrl-C stops the child and its status
+		// is still collected. Counted, because several children run at once with -j.
+		class IgnoreInterrupts {
+		  public:
+			IgnoreInterrupts() {
+				std::lock_guard lock(interruptsMutex);
+				if (interruptsIgnored++ == 0) {
+					struct sigaction ignore{};
+					ignore.sa_handler = SIG_IGN;
+					sigemptyset(&ignore.sa_mask);
+					sigaction(SIGINT, &ignore, &savedInterrupt);
+					sigaction(SIGQUIT, &ignore, &savedQuit);
+				}
+			}
+
+			~IgnoreInterrupts() {
+				std::lock_guard lock(interruptsMutex);
+				if (--interruptsIgnored == 0) {
+					sigaction(SIGINT, &savedInterrupt, nullptr);
+					sigaction(SIGQUIT, &savedQuit, nullptr);
+				}
+			}
+
+			IgnoreInterrupts(const IgnoreInterrupts&) = delete;
+			IgnoreInterrupts& operator=(const IgnoreInterrupts&) = delete;
+
+			// The signals the child gets its default action back for; one xx was started with ignored stays ignored.
+			[[nodiscard]] sigset_t restored() const {
+				std::lock_guard lock(interruptsMutex);
+				sigset_t signals;
+				sigemptyset(&signals);
+				if (savedInterrupt.sa_handler != SIG_IGN) {
+					sigaddset(&signals, SIGINT);
+				}
+				if (savedQuit.sa_handler != SIG_IGN) {
+					sigaddset(&signals, SIGQUIT);
+				}
+				return signals;
+			}
+		};
+
+		int open_pipe(int fds[2]) {
+#ifdef __linux__
+			return ::pipe2(fds, O_CLOEXEC);
+#else
+			if (::pipe(fds) != 0) {
+				return -1;
+			}
+			::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+			::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+			return 0;
+#endif
+		}
+	} // namespace
+
+	std::optional<DirectCommand> parse_plain(std::string_view commandLine) {
+		DirectCommand direct;
+
+		size_t position = 0;
+		while (position < commandLine.size()) {
+			if (commandLine[position] == ' ' || commandLine[position] == '\t') {
+				++position;
+				continue;
+			}
+
+			const auto end = std::min(commandLine.find_first_of(" \t", position), commandLine.size());
+			const auto word = commandLine.substr(position, end - position);
+			position = end;
+
+			if (!std::all_of(word.begin(), word.end(), is_plain)) {
+				return std::nullopt;
+			}
+
+			const auto equals = word.find('=');
+			if (direct.argv.empty() && equals != std::string_view::npos) {
+				if (!is_identifier(word.substr(0, equals))) {
+					return std::nullopt;
+				}
+				direct.assignments.emplace_back(word.substr(0, equals), word.substr(equals + 1));
+				continue;
+			}
+			direct.argv.emplace_back(word);
+		}
+
+		if (direct.argv.empty()) {
+			return std::nullopt;
+		}
+		return direct;
+	}
+
+	std::optional<std::string> find_program(const DirectCommand& direct) {
+		const auto& name = direct.argv.front();
+		if (is_shell_builtin(name)) {
+			return std::nullopt;
+		}
+		if (name.find('/') != std::string::npos) {
+			return is_executable(name) ? std::optional(name) : std::nullopt;
+		}
+
+		const auto assignsPath = std::any_of(direct.assignments.begin(), direct.assignments.end(), [](const auto& assignment) {
+			return assignment.first == "PATH";
+		});
+		const auto* path = std::getenv("PATH");
+		if (assignsPath || !path) {
+			return std::nullopt;
+		}
+
+		std::string_view directories = path;
+		while (true) {
+			const auto colon = directories.find(':');
+			const auto directory = directories.substr(0, colon);
+			auto candidate = (directory.empty() ? std::string(".") : std::string(directory)) + "/" + name;
+			if (is_executable(candidate)) {
+				return candidate;
+			}
+			if (colon == std::string_view::npos) {
+				return std::nullopt;
+			}
+			directories.remove_prefix(colon + 1);
+		}
+	}
+
+	std::expected<int32_t, std::string> spawn(const std::string& program, const DirectCommand& direct, const std::function<void(std::string_view)>& output) {
+		std::vector<std::string> environment;
+		for (auto** entry = environ; *entry; ++entry) {
+			const std::string_view variable = *entry;
+			const auto name = variable.substr(0, variable.find('='));
+			const auto overridden = std::any_of(direct.assignments.begin(), direct.assignments.end(), [name](const auto& assignment) {
+				return assignment.first == name;
+			});
+			if (!overridden) {
+				environment.emplace_back(variable);
+			}
+		}
+		for (const auto& [name, value] : direct.assignments) {
+			environment.push_back(name + "=" + value);
+		}
+
+		std::vector<char*> argv;
+		for (const auto& argument : direct.argv) {
+			argv.push_back(const_cast<char*>(argument.c_str()));
+		}
+		argv.push_back(nullptr);
+
+		std::vector<char*> envp;
+		for (const auto& variable : environment) {
+			envp.push_back(const_cast<char*>(variable.c_str()));
+		}
+		envp.push_back(nullptr);
+
+		int fds[2] = {-1, -1};
+		posix_spawn_file_actions_t actions;
+		posix_spawn_file_actions_init(&actions);
+		if (output) {
+			if (open_pipe(fds) != 0) {
+				posix_spawn_file_actions_destroy(&actions);
+				return std::unexpected(std::string("Failed to create a pipe: ") + std::strerror(errno));
+			}
+			posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+			posix_spawn_file_actions_adddup2(&actions, fds[1], STDERR_FILENO);
+		}
+
+		const IgnoreInterrupts ignoreInterrupts;
+		posix_spawnattr_t attributes;
+		posix_spawnattr_init(&attributes);
+		const auto restored = ignoreInterrupts.restored();
+		posix_spawnattr_setsigdefault(&attributes, &restored);
+		posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGDEF);
+
+		pid_t pid = 0;
+		const auto error = posix_spawn(&pid, program.c_str(), &actions, &attributes, argv.data(), envp.data());
+		posix_spawn_file_actions_destroy(&actions);
+		posix_spawnattr_destroy(&attributes);
+		if (output) {
+			::close(fds[1]);
+		}
+		if (error != 0) {
+			if (output) {
+				::close(fds[0]);
+			}
+			return std::unexpected("Failed to execute '" + program + "': " + std::strerror(error));
+		}
+
+		if (output) {
+			char chunk[4096];
+			while (true) {
+				const auto count = ::read(fds[0], chunk, sizeof(chunk));
+				if (count > 0) {
+					output(std::string_view(chunk, static_cast<size_t>(count)));
+				} else if (count == 0 || errno != EINTR) {
+					break;
+				}
+			}
+			::close(fds[0]);
+		}
+
+		int status = 0;
+		rusage usage{};
+		while (wait4(pid, &status, 0, &usage) < 0) {
+			if (errno != EINTR) {
+				return std::unexpected(std::string("Failed to wait for the command: ") + std::strerror(errno));
+			}
+		}
+		spdlog::debug("Command exited with status {} after {} ms of CPU time", status, (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000 + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000);
+
+		if (WIFSIGNALED(status)) {
+			return 128 + WTERMSIG(status);
+		}
+		return WEXITSTATUS(status);
+	}
+
 	std::string build_shell_command(const Command& command) {
 		std::ostringstream oss;
 		for (const auto& [key, value] : command.envs) {
@@ -73,11 +352,23 @@ namespace xxlib::platform_executor {
 			}
 		}
 
-		spdlog::debug("Executing system command: {}", fullCommand);
-
 		// Recommended by https://en.cppreference.com/w/cpp/utility/program/system.html
 		std::cout << std::flush;
 
+		// A line of plain words runs the same with or without a shell, so /bin/sh is skipped for it.
+		if (const auto direct = parse_plain(fullCommand)) {
+			if (const auto program = find_program(*direct)) {
+				spdlog::debug("Spawning {} directly: {}", *program, fullCommand);
+				return spawn(*program, *direct, context.output);
+			}
+		}
+
+		spdlog::debug("Executing system command: {}", fullCommand);
+
+		if (context.output) {
+			return run_captured(fullCommand, context.output);
+		}
+
 		auto returnCode = std::system(fullCommand.c_str());
 		spdlog::debug("Command exited with return code: {}", returnCode);
 		if (returnCode == -1) {
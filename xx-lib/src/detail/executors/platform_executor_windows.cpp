@@ -9,9 +9,34 @@
 #include <filesystem>
 #include <fstream>
 #include <array>
+#include <cstdio>
 #include <spdlog/spdlog.h>
 
 namespace xxlib::platform_executor {
+	namespace {
+		// Runs cmd with stdout and stderr merged into a pipe that is drained into output.
+		std::expected<int32_t, std::string> run_captured(const std::string& cmd, const std::function<void(std::string_view)>& output) {
+			auto* pipe = _popen((cmd + " 2>&1").c_str(), "rb");
+			if (!pipe) {
+				return std::unexpected("Failed to execute command");
+			}
+
+			char chunk[4096];
+			size_t count = 0;
+			while ((count = std::fread(chunk, 1, sizeof(chunk), pipe)) > 0) {
+				output(std::string_view(chunk, count));
+			}
+
+			const auto returnCode = _pclose(pipe);
+			spdlog::debug("Command exited with return code: {}", returnCode);
+			if (returnCode == -1) {
+				return std::unexpected("Failed to execute command");
+			}
+
+			return static_cast<int32_t>(returnCode);
+		}
+	} // namespace
+
 	std::string build_shell_command(const Command& command) {
 		std::ostringstream oss;
 		for (const auto& [key, value] : command.envs) {
@@ -89,6 +114,10 @@ namespace xxlib::platform_executor {
 		ofs.close();
 
 		auto cmd = "powershell -ExecutionPolicy Bypass -File \"" + tempFile.path + "\"";
+		if (context.output) {
+			return run_captured(cmd, context.output);
+		}
+
 		auto returnCode = std::system(cmd.c_str());
 		spdlog::debug("Command exited with return code: {}", returnCode);
 		if (returnCode == -1) {
@@ -0,0 +1,152 @@
+#include "detail/fuzzy.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace xxlib {
+	namespace {
+		constexpr int32_t MATCH_SCORE = 16;
+		constexpr int32_t CONSECUTIVE_BONUS = 24;
+		constexpr int32_t BOUNDARY_BONUS = 16;
+		constexpr int32_t MAX_GAP_PENALTY = 8;
+
+		char lower(char c) {
+			return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+		}
+
+		// Collisions only make the mask test less selective, never wrong.
+		uint64_t char_bit(char c) {
+			return uint64_t{1} << (static_cast<unsigned char>(c) & 63);
+		}
+
+		uint64_t char_mask(std::string_view text) {
+			uint64_t mask = 0;
+			for (const auto c : text) {
+				mask |= char_bit(c);
+			}
+			return mask;
+		}
+
+		bool is_boundary(char c) {
+			return c == '-' || c == '_' || c == ':' || c == '.' || c == '/' || c == ' ';
+		}
+	} // namespace
+
+	FuzzyIndex::FuzzyIndex(const std::vector<std::string_view>& names) : originals(names) {
+		size_t total = 0;
+		for (const auto name : names) {
+			total += name.size();
+		}
+
+		buffer.reserve(total);
+		offsets.reserve(names.size() + 1);
+		masks.reserve(names.size());
+
+		offsets.push_back(0);
+		for (const auto name : names) {
+			const auto begin = buffer.size();
+			for (const auto c : name) {
+				buffer += lower(c);
+			}
+			masks.push_back(char_mask(std::string_view(buffer).substr(begin)));
+			offsets.push_back(static_cast<uint32_t>(buffer.size()));
+		}
+	}
+
+	size_t FuzzyIndex::size() const {
+		return originals.size();
+	}
+
+	std::string_view FuzzyIndex::name(uint32_t index) const {
+		return originals[index];
+	}
+
+	std::vector<FuzzyIndex::Match> FuzzyIndex::filter(std::string_view query) const {
+		std::vector<Match> all(originals.size());
+		for (size_t i = 0; i < all.size(); ++i) {
+			all[i].index = static_cast<uint32_t>(i);
+		}
+		return filter(query, all);
+	}
+
+	std::vector<FuzzyIndex::Match> FuzzyIndex::filter(std::string_view query, std::span<const Match> candidates) const {
+		std::string lowerQuery;
+		lowerQuery.reserve(query.size());
+		for (const auto c : query) {
+			if (c != ' ') {
+				lowerQuery += lower(c);
+			}
+		}
+
+		std::vector<Match> matches;
+		if (lowerQuery.empty()) {
+			matches.reserve(candidates.size());
+			for (const auto& candidate : candidates) {
+				matches.push_back(Match{.index = candidate.index});
+			}
+			std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+				return a.index < b.index;
+			});
+			return matches;
+		}
+
+		const auto queryMask = char_mask(lowerQuery);
+		const std::string_view text = buffer;
+		for (const auto& candidate : candidates) {
+			if ((masks[candidate.index] & queryMask) != queryMask) {
+				continue;
+			}
+
+			const auto begin = offsets[candidate.index];
+			const auto value = score(text.substr(begin, offsets[candidate.index + 1] - begin), lowerQuery);
+			if (value >= 0) {
+				matches.push_back(Match{.index = candidate.index, .score = value});
+			}
+		}
+
+		std::sort(matches.begin(), matches.end(), [this](const Match& a, const Match& b) {
+			if (a.score != b.score) {
+				return a.score > b.score;
+			}
+			const auto lengthA = offsets[a.index + 1] - offsets[a.index];
+			const auto lengthB = offsets[b.index + 1] - offsets[b.index];
+			if (lengthA != lengthB) {
+				return lengthA < lengthB;
+			}
+			return a.index < b.index;
+		});
+		return matches;
+	}
+
+	int32_t FuzzyIndex::score(std::string_view lowerName, std::string_view lowerQuery) {
+		int32_t total = 0;
+		size_t position = 0;
+		size_t previous = std::string_view::npos;
+
+		for (const auto c : lowerQuery) {
+			// memchr is vectorized by the C library, which makes the gaps between matched characters cheap.
+			const auto* found = position < lowerName.size() ? static_cast<const char*>(std::memchr(lowerName.data() + position, c, lowerName.size() - position)) : nullptr;
+			if (!found) {
+				return -1;
+			}
+
+			const auto index = static_cast<size_t>(found - lowerName.data());
+			auto value = MATCH_SCORE;
+			if (previous != std::string_view::npos && index == previous + 1) {
+				value += CONSECUTIVE_BONUS;
+			} else if (previous != std::string_view::npos) {
+				value -= static_cast<int32_t>(std::min<size_t>(index - previous - 1, MAX_GAP_PENALTY));
+			}
+			if (index == 0 || is_boundary(lowerName[index - 1])) {
+				value += BOUNDARY_BONUS;
+			}
+
+			total += value;
+			previous = index;
+			position = index + 1;
+		}
+
+		return total;
+	}
+} // namespace xxlib
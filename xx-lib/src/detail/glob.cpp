@@ -0,0 +1,166 @@
+#include "detail/glob.hpp"
+
+#include <algorithm>
+#include <system_error>
+
+namespace xxlib::glob {
+	namespace {
+		bool match_class(std::string_view pattern, size_t& index, char c) {
+			// pattern[index] is '['; on return index points past the closing ']'.
+			auto i = index + 1;
+			auto negate = false;
+			if (i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^')) {
+				negate = true;
+				++i;
+			}
+
+			auto matched = false;
+			auto first = true;
+			while (i < pattern.size() && (first || pattern[i] != ']')) {
+				first = false;
+				if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+					if (pattern[i] <= c && c <= pattern[i + 2]) {
+						matched = true;
+					}
+					i += 3;
+				} else {
+					if (pattern[i] == c) {
+						matched = true;
+					}
+					++i;
+				}
+			}
+
+			index = i < pattern.size() ? i + 1 : i;
+			return matched != negate;
+		}
+
+		std::vector<std::string> split_segments(const std::string& pattern) {
+			std::vector<std::string> segments;
+			std::string current;
+
+			for (const auto c : pattern) {
+				if (c == '/' || c == '\\') {
+					if (!current.empty()) {
+						segments.emplace_back(std::move(current));
+						current.clear();
+					}
+				} else {
+					current.push_back(c);
+				}
+			}
+
+			if (!current.empty()) {
+				segments.emplace_back(std::move(current));
+			}
+
+			return segments;
+		}
+
+		void expand_segments(const std::filesystem::path& directory, const std::vector<std::string>& segments, size_t index, std::vector<std::string>& out) {
+			std::error_code ec;
+
+			if (index == segments.size()) {
+				if (std::filesystem::is_regular_file(directory, ec)) {
+					out.emplace_back(directory.lexically_normal().string());
+				}
+				return;
+			}
+
+			const auto& segment = segments[index];
+
+			if (segment == "**") {
+				expand_segments(directory, segments, index + 1, out);
+
+				for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+					const auto name = entry.path().filename().string();
+					if (!name.starts_with('.') && entry.is_directory(ec) && !entry.is_symlink(ec)) {
+						expand_segments(entry.path(), segments, index, out);
+					}
+				}
+				return;
+			}
+
+			if (!has_magic(segment)) {
+				const auto next = directory / segment;
+				if (std::filesystem::exists(next, ec)) {
+					expand_segments(next, segments, index + 1, out);
+				}
+				return;
+			}
+
+			for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+				if (match(segment, entry.path().filename().string())) {
+					expand_segments(entry.path(), segments, index + 1, out);
+				}
+			}
+		}
+	} // namespace
+
+	bool has_magic(std::string_view pattern) {
+		return pattern.find_first_of("*?[") != std::string_view::npos;
+	}
+
+	bool match(std::string_view pattern, std::string_view name) {
+		if (!name.empty() && name.front() == '.' && (pattern.empty() || pattern.front() != '.')) {
+			return false;
+		}
+
+		size_t p = 0;
+		size_t n = 0;
+		size_t starPattern = std::string_view::npos;
+		size_t starName = 0;
+
+		while (n < name.size()) {
+			if (p < pattern.size() && pattern[p] == '*') {
+				starPattern = p++;
+				starName = n;
+				continue;
+			}
+
+			if (p < pattern.size() && pattern[p] == '[') {
+				auto next = p;
+				if (match_class(pattern, next, name[n])) {
+					p = next;
+					++n;
+					continue;
+				}
+			} else if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+				++p;
+				++n;
+				continue;
+			}
+
+			if (starPattern == std::string_view::npos) {
+				return false;
+			}
+
+			p = starPattern + 1;
+			n = ++starName;
+		}
+
+		while (p < pattern.size() && pattern[p] == '*') {
+			++p;
+		}
+
+		return p == pattern.size();
+	}
+
+	std::vector<std::string> expand(const std::filesystem::path& base, const std::string& pattern) {
+		const auto patternPath = std::filesystem::path(pattern);
+
+		auto root = base;
+		if (patternPath.is_absolute()) {
+			root = patternPath.root_path();
+		}
+
+		const auto relative = patternPath.is_absolute() ? patternPath.relative_path().generic_string() : patternPath.generic_string();
+
+		std::vector<std::string> out;
+		expand_segments(root, split_segments(relative), 0, out);
+
+		std::sort(out.begin(), out.end());
+		out.erase(std::unique(out.begin(), out.end()), out.end());
+		return out;
+	}
+} // namespace xxlib::glob
@@ -0,0 +1,141 @@
+#include "detail/hash.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fmt/format.h>
+
+namespace xxlib::hash {
+	namespace {
+		constexpr std::array<uint32_t, 64> SHA256_K = {
+			0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+			0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+			0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+			0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+			0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+			0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+			0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+			0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+		};
+
+		constexpr uint32_t rotr(uint32_t value, int bits) {
+			return (value >> bits) | (value << (32 - bits));
+		}
+	} // namespace
+
+	uint64_t fnv1a64(std::string_view data, uint64_t seed) {
+		auto hash = seed;
+		for (const auto c : data) {
+			hash ^= static_cast<uint8_t>(c);
+			hash *= FNV1A64_PRIME;
+		}
+		return hash;
+	}
+
+	std::string to_hex(uint64_t value) {
+		return fmt::format("{:016x}", value);
+	}
+
+	void Sha256::update(std::string_view data) {
+		const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+		auto remaining = data.size();
+		length += remaining;
+
+		if (buffered > 0) {
+			const auto taken = std::min(remaining, buffer.size() - buffered);
+			std::memcpy(buffer.data() + buffered, bytes, taken);
+			buffered += taken;
+			bytes += taken;
+			remaining -= taken;
+			if (buffered < buffer.size()) {
+				return;
+			}
+			transform(buffer.data());
+			buffered = 0;
+		}
+
+		// Whole blocks are hashed in place instead of going through the buffer.
+		for (; remaining >= buffer.size(); bytes += buffer.size(), remaining -= buffer.size()) {
+			transform(bytes);
+		}
+
+		std::memcpy(buffer.data(), bytes, remaining);
+		buffered = remaining;
+	}
+
+	Sha256Digest Sha256::finish() {
+		const auto bitLength = length * 8;
+
+		buffer[buffered++] = 0x80;
+		if (buffered > 56) {
+			std::fill(buffer.begin() + static_cast<std::ptrdiff_t>(buffered), buffer.end(), 0);
+			transform(buffer.data());
+			buffered = 0;
+		}
+		std::fill(buffer.begin() + static_cast<std::ptrdiff_t>(buffered), buffer.begin() + 56, 0);
+		for (size_t i = 0; i < 8; ++i) {
+			buffer[56 + i] = static_cast<uint8_t>(bitLength >> (56 - 8 * i));
+		}
+		transform(buffer.data());
+
+		Sha256Digest digest;
+		for (size_t i = 0; i < state.size(); ++i) {
+			for (size_t j = 0; j < 4; ++j) {
+				digest[i * 4 + j] = static_cast<uint8_t>(state[i] >> (24 - 8 * j));
+			}
+		}
+		return digest;
+	}
+
+	void Sha256::transform(const uint8_t* block) {
+		std::array<uint32_t, 64> w;
+		for (size_t i = 0; i < 16; ++i) {
+			w[i] = (uint32_t(block[i * 4]) << 24) | (uint32_t(block[i * 4 + 1]) << 16) | (uint32_t(block[i * 4 + 2]) << 8) | uint32_t(block[i * 4 + 3]);
+		}
+		for (size_t i = 16; i < 64; ++i) {
+			const auto s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+			const auto s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+			w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+		}
+
+		auto [a, b, c, d, e, f, g, h] = state;
+		for (size_t i = 0; i < 64; ++i) {
+			const auto t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + SHA256_K[i] + w[i];
+			const auto t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+			h = g;
+			g = f;
+			f = e;
+			e = d + t1;
+			d = c;
+			c = b;
+			b = a;
+			a = t1 + t2;
+		}
+
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+		state[5] += f;
+		state[6] += g;
+		state[7] += h;
+	}
+
+	Sha256Digest sha256(std::string_view data) {
+		Sha256 hasher;
+		hasher.update(data);
+		return hasher.finish();
+	}
+
+	std::string to_hex(const Sha256Digest& digest) {
+		constexpr std::string_view DIGITS = "0123456789abcdef";
+
+		std::string hex;
+		hex.reserve(digest.size() * 2);
+		for (const auto byte : digest) {
+			hex += DIGITS[byte >> 4];
+			hex += DIGITS[byte & 0x0f];
+		}
+		return hex;
+	}
+} // namespace xxlib::hash
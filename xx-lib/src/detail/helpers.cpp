@@ -1,4 +1,5 @@
 #include "detail/helpers.hpp"
+#include <cctype>
 #include <iostream>
 
 namespace xxlib::helpers {
@@ -8,6 +9,41 @@ namespace xxlib::helpers {
 		return std::tolower(symbol) == 'y';
 	}
 
+	std::string ask_for_line(const std::string& text) {
+		std::cout << text << std::flush;
+		std::string line;
+		std::getline(std::cin, line);
+		return line;
+	}
+
+	std::vector<std::string> split_arguments(const std::string& line) {
+		std::vector<std::string> arguments;
+		std::string current;
+		bool inQuotes = false;
+		bool hasArgument = false;
+
+		for (const auto c : line) {
+			if (c == '"') {
+				inQuotes = !inQuotes;
+				hasArgument = true;
+			} else if (!inQuotes && std::isspace(static_cast<unsigned char>(c))) {
+				if (hasArgument) {
+					arguments.push_back(std::move(current));
+					current.clear();
+					hasArgument = false;
+				}
+			} else {
+				current += c;
+				hasArgument = true;
+			}
+		}
+		if (hasArgument) {
+			arguments.push_back(std::move(current));
+		}
+
+		return arguments;
+	}
+
 	ExtrasResult split_extras(const std::vector<std::string>& extras) {
 		ExtrasResult result{};
 
@@ -30,7 +66,7 @@ namespace xxlib::helpers {
 		return result;
 	}
 
-	std::vector<std::string> get_uset_vars(const std::unordered_map<std::string, std::string>& templateVars) {
+	std::vector<std::string> get_uset_vars(const xxlib::StringMap& templateVars) {
 		std::vector<std::string> unsetVars;
 		for (const auto& [key, value] : templateVars) {
 			if (value.empty()) {
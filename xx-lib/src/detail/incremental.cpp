@@ -0,0 +1,229 @@
+#include "detail/incremental.hpp"
+#include "detail/cache.hpp"
+#include "detail/glob.hpp"
+#include "detail/hash.hpp"
+#include "detail/mapped_file.hpp"
+#include "detail/serializer.hpp"
+#include "detail/thread_pool.hpp"
+#include "xxlib.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <system_error>
+
+namespace xxlib::incremental {
+	namespace {
+		// Files stamped by one thread; with fewer than twice as many, starting threads costs more than it saves.
+		constexpr size_t MIN_CHUNK = 32;
+
+		FileStamp stamp_file(const std::string& path, bool hashContents, const std::vector<FileStamp>& previous, StatCache& stats) {
+			const auto stat = stats.stat(path);
+			if (!stat) {
+				return FileStamp{.path = path};
+			}
+
+			auto stamp = *stat;
+			const auto before = std::lower_bound(previous.begin(), previous.end(), path, [](const FileStamp& entry, const std::string& value) {
+				return entry.path < value;
+			});
+			if (before != previous.end() && before->path == path && before->size == stamp.size && before->mtime == stamp.mtime) {
+				stamp.hash = before->hash;
+			}
+
+			if (hashContents && stamp.hash == 0) {
+				if (const auto file = xxlib::MappedFile::open(path)) {
+					stamp.hash = xxlib::hash::fnv1a64(file->view());
+				}
+			}
+			return stamp;
+		}
+	} // namespace
+
+	std::optional<FileStamp> StatCache::stat(const std::string& path) {
+		uint64_t startedAt = 0;
+		{
+			std::lock_guard lock(mutex);
+			if (const auto found = entries.find(path); found != entries.end()) {
+				return found->second;
+			}
+			startedAt = generation;
+		}
+
+		std::optional<FileStamp> stamp;
+		std::error_code ec;
+		const auto size = std::filesystem::file_size(path, ec);
+		if (!ec) {
+			const auto mtime = std::filesystem::last_write_time(path, ec);
+			if (!ec) {
+				stamp = FileStamp{
+					.path = path,
+					.size = static_cast<uint64_t>(size),
+					.mtime = static_cast<int64_t>(mtime.time_since_epoch().count()),
+				};
+			}
+		}
+
+		std::lock_guard lock(mutex);
+		if (generation == startedAt) {
+			entries.emplace(path, stamp);
+		}
+		return stamp;
+	}
+
+	void StatCache::clear() {
+		std::lock_guard lock(mutex);
+		entries.clear();
+		++generation;
+	}
+
+	uint64_t command_key(const Command& command, const std::vector<std::string>& extras) {
+		xxlib::serializer::Writer writer;
+		xxlib::serializer::write_command(writer, command);
+		for (const auto& extra : extras) {
+			writer.str(extra);
+		}
+		return xxlib::hash::fnv1a64(writer.buffer);
+	}
+
+	std::vector<std::string> expand_all(const std::filesystem::path& base, const std::vector<std::string>& patterns) {
+		std::vector<std::string> files;
+		for (const auto& pattern : patterns) {
+			auto matched = xxlib::glob::expand(base, pattern);
+			files.insert(files.end(), std::make_move_iterator(matched.begin()), std::make_move_iterator(matched.end()));
+		}
+
+		std::sort(files.begin(), files.end());
+		files.erase(std::unique(files.begin(), files.end()), files.end());
+		return files;
+	}
+
+	std::vector<FileStamp> fingerprint(const std::vector<std::string>& files, bool hashContents, const std::vector<FileStamp>& previous, StatCache& stats) {
+		std::vector<FileStamp> stamps(files.size());
+		xxlib::parallel_ranges(files.size(), MIN_CHUNK, [&](size_t begin, size_t end) {
+			for (auto i = begin; i < end; ++i) {
+				stamps[i] = stamp_file(files[i], hashContents, previous, stats);
+			}
+		});
+		return stamps;
+	}
+
+	std::string state_path(const std::string& stateDirectory, const std::filesystem::path& base, const std::string& name) {
+		std::error_code ec;
+		auto absoluteBase = std::filesystem::absolute(base, ec);
+		if (ec) {
+			absoluteBase = base;
+		}
+
+		const auto seed = xxlib::hash::fnv1a64(absoluteBase.lexically_normal().string() + '\0');
+		const auto key = xxlib::hash::to_hex(xxlib::hash::fnv1a64(name, seed));
+		return (std::filesystem::path(stateDirectory) / (key + ".xxs")).string();
+	}
+
+	std::expected<State, std::string> load_state(const std::string& path) {
+		const auto file = xxlib::MappedFile::open(path);
+		if (!file) {
+			return std::unexpected("No recorded state");
+		}
+
+		auto reader = xxlib::serializer::Reader{.data = file->view()};
+		if (reader.u32() != MAGIC || reader.u32() != FORMAT_VERSION || reader.str_view() != xxlib::version()) {
+			return std::unexpected("Recorded state has an incompatible format");
+		}
+
+		State state;
+		state.key = reader.u64();
+
+		const auto inputCount = reader.u32();
+		if (!reader.ok || inputCount > reader.remaining() / 4) {
+			return std::unexpected("Recorded state is corrupted");
+		}
+		state.inputs.reserve(inputCount);
+		for (uint32_t i = 0; i < inputCount && reader.ok; ++i) {
+			auto& input = state.inputs.emplace_back();
+			input.path = reader.str();
+			input.size = reader.u64();
+			input.mtime = reader.i64();
+			input.hash = reader.u64();
+		}
+
+		if (!reader.ok) {
+			return std::unexpected("Recorded state is truncated");
+		}
+		return state;
+	}
+
+	std::expected<void, std::string> store_state(const std::string& path, const State& state) {
+		xxlib::serializer::Writer writer;
+		writer.u32(MAGIC);
+		writer.u32(FORMAT_VERSION);
+		writer.str(xxlib::version());
+		writer.u64(state.key);
+		writer.u32(static_cast<uint32_t>(state.inputs.size()));
+		for (const auto& input : state.inputs) {
+			writer.str(input.path);
+			writer.u64(input.size);
+			writer.i64(input.mtime);
+			writer.u64(input.hash);
+		}
+
+		return xxlib::cache::write_atomic(path, writer.buffer);
+	}
+
+	Check check(const Command& command, const std::vector<std::string>& extras, const Options& options, StatCache& stats) {
+		auto result = Check{
+			.statePath = state_path(options.stateDirectory, options.base, command.name),
+			.state = State{.key = command_key(command, extras)},
+		};
+
+		const auto previous = load_state(result.statePath);
+		result.state.inputs = fingerprint(expand_all(options.base, command.inputs), options.hashContents, previous ? previous->inputs : std::vector<FileStamp>{}, stats);
+
+		if (!previous) {
+			result.reason = previous.error();
+			return result;
+		}
+		if (previous->key != result.state.key) {
+			result.reason = "The alias or its arguments changed";
+			return result;
+		}
+		if (previous->inputs.size() != result.state.inputs.size()) {
+			result.reason = "The set of inputs changed";
+			return result;
+		}
+
+		auto newestInput = std::numeric_limits<int64_t>::min();
+		for (size_t i = 0; i < result.state.inputs.size(); ++i) {
+			const auto& now = result.state.inputs[i];
+			const auto& before = previous->inputs[i];
+			const auto changed = options.hashContents ? now.hash != before.hash : now.mtime != before.mtime;
+			if (now.path != before.path || now.size != before.size || changed) {
+				result.reason = "Input '" + now.path + "' changed";
+				return result;
+			}
+			newestInput = std::max(newestInput, now.mtime);
+		}
+
+		for (const auto& pattern : command.outputs) {
+			const auto files = xxlib::glob::expand(options.base, pattern);
+			if (files.empty()) {
+				result.reason = "No file matches output '" + pattern + "'";
+				return result;
+			}
+
+			for (const auto& file : files) {
+				const auto stamp = stats.stat(file);
+				if (!stamp) {
+					result.reason = "Output '" + file + "' is gone";
+					return result;
+				}
+				if (!options.hashContents && stamp->mtime < newestInput) {
+					result.reason = "Output '" + file + "' is older than the inputs";
+					return result;
+				}
+			}
+		}
+
+		result.upToDate = true;
+		return result;
+	}
+} // namespace xxlib::incremental
@@ -0,0 +1,176 @@
+#include "detail/listing.hpp"
+
+namespace xxlib::listing {
+	namespace {
+		constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+		void append_text_line(std::string& out, const Command& command, std::string_view cmdText) {
+			out += "-- ";
+			if (command.userScope) {
+				out += "[User] ";
+			}
+			out += command.name;
+			out += ": ";
+			out += cmdText;
+		}
+	} // namespace
+
+	Format string_to_format(const std::string& format) {
+		if (format == "json") {
+			return Format::Json;
+		} else if (format == "ndjson") {
+			return Format::Ndjson;
+		} else {
+			return Format::Text;
+		}
+	}
+
+	void append_json_string(std::string& out, std::string_view value) {
+		constexpr char HEX[] = "0123456789abcdef";
+
+		out += '"';
+		for (const auto c : value) {
+			switch (c) {
+			case '"':
+				out += "\\\"";
+				break;
+			case '\\':
+				out += "\\\\";
+				break;
+			case '\n':
+				out += "\\n";
+				break;
+			case '\r':
+				out += "\\r";
+				break;
+			case '\t':
+				out += "\\t";
+				break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					out += "\\u00";
+					out += HEX[(c >> 4) & 0xf];
+					out += HEX[c & 0xf];
+				} else {
+					out += c;
+				}
+			}
+		}
+		out += '"';
+	}
+
+	Writer::Writer(std::FILE* out, Format format) : out(out), format(format) {
+		buffer.reserve(FLUSH_THRESHOLD * 2);
+		if (format == Format::Text) {
+			buffer += "Commands available for the current environment:\n";
+		} else if (format == Format::Json) {
+			buffer += '[';
+		}
+	}
+
+	Writer::~Writer() {
+		finish();
+	}
+
+	void Writer::add(const Command& command, bool available) {
+		if (format == Format::Text) {
+			add_text(command, available);
+		} else {
+			add_json(command, available);
+		}
+		++count;
+		flush_if_full();
+	}
+
+	void Writer::finish() {
+		if (finished) {
+			return;
+		}
+		finished = true;
+
+		if (format == Format::Text && !unavailable.empty()) {
+			buffer += "Commands not available for the current environment: (due to constraints)\n";
+			buffer += unavailable;
+		} else if (format == Format::Json) {
+			buffer += count == 0 ? "]\n" : "\n]\n";
+		}
+
+		std::fwrite(buffer.data(), 1, buffer.size(), out);
+		std::fflush(out);
+		buffer.clear();
+	}
+
+	void Writer::add_text(const Command& command, bool available) {
+		const auto cmdText = xxlib::command::join_cmd(command);
+		if (available) {
+			append_text_line(buffer, command, cmdText);
+			buffer += '\n';
+			return;
+		}
+
+		append_text_line(unavailable, command, cmdText);
+		unavailable += " [Constraints: ";
+		unavailable += xxlib::command::join_constraints(command);
+		unavailable += "]\n";
+	}
+
+	void Writer::add_json(const Command& command, bool available) {
+		if (format == Format::Json) {
+			buffer += count == 0 ? "\n" : ",\n";
+		}
+
+		buffer += "{\"name\":";
+		append_json_string(buffer, command.name);
+		buffer += ",\"scope\":";
+		buffer += command.userScope ? "\"user\"" : "\"project\"";
+		buffer += ",\"render_engine\":";
+		append_json_string(buffer, xxlib::renderer::render_engine_to_string(command.renderEngine));
+		buffer += ",\"execution_engine\":";
+		append_json_string(buffer, xxlib::executor::execution_engine_to_string(command.executionEngine));
+		buffer += ",\"available\":";
+		buffer += available ? "true" : "false";
+
+		buffer += ",\"constraints\":[";
+		for (size_t i = 0; i < command.constraints.size(); ++i) {
+			buffer += i == 0 ? "{\"key\":" : ",{\"key\":";
+			append_json_string(buffer, command.constraints[i].first);
+			buffer += ",\"value\":";
+			append_json_string(buffer, command.constraints[i].second);
+			buffer += '}';
+		}
+
+		buffer += "],\"template_vars\":[";
+		auto first = true;
+		for (const auto& [key, value] : command.templateVars) {
+			if (!first) {
+				buffer += ',';
+			}
+			first = false;
+			append_json_string(buffer, key);
+		}
+
+		buffer += "],\"depends_on\":[";
+		for (size_t i = 0; i < command.dependsOn.size(); ++i) {
+			if (i > 0) {
+				buffer += ',';
+			}
+			append_json_string(buffer, command.dependsOn[i]);
+		}
+
+		buffer += "],\"cmd\":";
+		append_json_string(buffer, xxlib::command::join_cmd(command));
+		buffer += '}';
+
+		if (format == Format::Ndjson) {
+			buffer += '\n';
+		}
+	}
+
+	void Writer::flush_if_full() {
+		if (buffer.size() < FLUSH_THRESHOLD) {
+			return;
+		}
+		std::fwrite(buffer.data(), 1, buffer.size(), out);
+		buffer.clear();
+	}
+} // namespace xxlib::listing
@@ -0,0 +1,295 @@
+#include "detail/loader.hpp"
+#include "detail/cache.hpp"
+#include "detail/glob.hpp"
+#include "detail/parser.hpp"
+#include "detail/thread_pool.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <future>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <spdlog/spdlog.h>
+
+namespace xxlib::loader {
+	namespace {
+		struct IncludeNode {
+			xxlib::parser::Document document{};
+			std::vector<std::string> children{};
+		};
+
+		std::string include_key(const std::filesystem::path& path) {
+			std::error_code ec;
+			const auto canonical = std::filesystem::weakly_canonical(path, ec);
+			return ec ? path.lexically_normal().string() : canonical.string();
+		}
+
+		std::expected<xxlib::parser::Document, std::string> parse_source(const std::string& path, std::string_view buffer, const Options& options) {
+			if (!options.useCache || path == "-") {
+				// Stdin is parsed in full, so whoever needs more than the named alias does not have to read it again.
+				if (options.commandName && path != "-") {
+					return xxlib::parser::parse_document_for(buffer, *options.commandName, options.backend);
+				}
+				return xxlib::parser::parse_document(buffer, options.backend);
+			}
+
+			// Cache misses are parsed in full so the stored entry can serve any later invocation.
+			const auto cacheDirectory = options.cacheDirectory.empty() ? xxlib::cache::default_directory() : options.cacheDirectory;
+			return xxlib::cache::parse_cached(path, buffer, cacheDirectory, options.backend);
+		}
+
+		// Reads every file reachable through 'include' on a thread pool, parsing each file at most once.
+		class IncludeGraph {
+		  public:
+			explicit IncludeGraph(const Options& options) : options(options) {
+			}
+
+			std::expected<std::vector<Command>, std::string> load(const std::string& rootKey, xxlib::parser::Document rootDocument, const std::string& rootPath) {
+				auto children = resolve_includes(rootPath, rootDocument.includes);
+				if (!children) {
+					return std::unexpected(children.error());
+				}
+
+				{
+					std::lock_guard lock(mutex);
+					nodes.emplace(rootKey, IncludeNode{.document = std::move(rootDocument), .children = *children});
+				}
+
+				{
+					ThreadPool pool;
+					for (const auto& child : *children) {
+						schedule(pool, child);
+					}
+
+					std::unique_lock lock(mutex);
+					finished.wait(lock, [this]() {
+						return pending == 0;
+					});
+				}
+
+				if (!firstError.empty()) {
+					return std::unexpected(firstError);
+				}
+
+				std::vector<Command> commands;
+				std::unordered_map<std::string, uint8_t> state;
+				std::vector<std::string> stack;
+				if (auto flattened = flatten(rootKey, state, stack, commands); !flattened) {
+					return std::unexpected(flattened.error());
+				}
+
+				return commands;
+			}
+
+		  private:
+			void schedule(ThreadPool& pool, const std::string& key) {
+				{
+					std::lock_guard lock(mutex);
+					if (!nodes.emplace(key, IncludeNode{}).second) {
+						return;
+					}
+					++pending;
+				}
+
+				auto _ = pool.submit([this, &pool, key]() {
+					process(pool, key);
+				});
+			}
+
+			void process(ThreadPool& pool, const std::string& key) {
+				// The pool swallows exceptions, so one escaping here would leave pending above zero for good.
+				std::expected<std::vector<std::string>, std::string> children;
+				try {
+					children = read(key);
+					if (children) {
+						// Children are scheduled before this node is marked done so pending never drops to zero early.
+						for (const auto& child : *children) {
+							schedule(pool, child);
+						}
+					}
+				} catch (const std::exception& e) {
+					children = std::unexpected("Error loading included file " + key + ": " + e.what());
+				}
+
+				std::lock_guard lock(mutex);
+				if (!children && firstError.empty()) {
+					firstError = children.error();
+				}
+				if (--pending == 0) {
+					finished.notify_all();
+				}
+			}
+
+			std::expected<std::vector<std::string>, std::string> read(const std::string& key) {
+				const auto buffer = xxlib::parser::map_file(key, options.maxFileSize);
+				if (!buffer) {
+					return std::unexpected("Error reading included file: " + buffer.error());
+				}
+
+				auto document = parse_source(key, buffer->view(), options);
+				if (!document) {
+					return std::unexpected("Error parsing included file " + key + ": " + document.error());
+				}
+
+				auto children = resolve_includes(key, document->includes);
+				if (!children) {
+					return std::unexpected(children.error());
+				}
+
+				spdlog::debug("Loaded {} commands from included file {}", document->commands.size(), key);
+
+				std::lock_guard lock(mutex);
+				auto& node = nodes[key];
+				node.document = std::move(*document);
+				node.children = *children;
+				return children;
+			}
+
+			// Depth-first: a file's own commands come before those of its includes, each file is emitted once.
+			std::expected<void, std::string> flatten(const std::string& key, std::unordered_map<std::string, uint8_t>& state, std::vector<std::string>& stack, std::vector<Command>& commands) {
+				constexpr uint8_t VISITING = 1;
+				constexpr uint8_t DONE = 2;
+
+				stack.push_back(key);
+				state[key] = VISITING;
+
+				auto& node = nodes.at(key);
+				commands.insert(commands.end(), std::make_move_iterator(node.document.commands.begin()), std::make_move_iterator(node.document.commands.end()));
+
+				for (const auto& child : node.children) {
+					const auto childState = state[child];
+					if (childState == VISITING) {
+						std::string cycle;
+						for (auto it = std::find(stack.begin(), stack.end(), child); it != stack.end(); ++it) {
+							cycle += *it + " -> ";
+						}
+						return std::unexpected("Include cycle detected: " + cycle + child);
+					}
+
+					if (childState == DONE) {
+						continue;
+					}
+
+					if (auto result = flatten(child, state, stack, commands); !result) {
+						return result;
+					}
+				}
+
+				state[key] = DONE;
+				stack.pop_back();
+				return {};
+			}
+
+			const Options& options;
+			std::mutex mutex{};
+			std::condition_variable finished{};
+			std::unordered_map<std::string, IncludeNode> nodes{};
+			size_t pending = 0;
+			std::string firstError{};
+		};
+	} // namespace
+
+	std::expected<std::vector<std::string>, std::string> resolve_includes(const std::string& path, const std::vector<std::string>& includes) {
+		const auto base = path == "-" ? std::filesystem::current_path() : std::filesystem::path(path).parent_path();
+
+		std::vector<std::string> resolved;
+		for (const auto& include : includes) {
+			if (xxlib::glob::has_magic(include)) {
+				for (const auto& match : xxlib::glob::expand(base, include)) {
+					resolved.emplace_back(include_key(match));
+				}
+				continue;
+			}
+
+			const auto includePath = std::filesystem::path(include).is_absolute() ? std::filesystem::path(include) : base / include;
+
+			std::error_code ec;
+			if (!std::filesystem::is_regular_file(includePath, ec)) {
+				return std::unexpected("Included file not found: " + includePath.string() + " (included from " + path + ")");
+			}
+
+			resolved.emplace_back(include_key(includePath));
+		}
+
+		return resolved;
+	}
+
+	std::expected<std::vector<Command>, std::string> load_source(const Source& source, const Options& options) {
+		const auto buffer = xxlib::parser::map_file(source.path, options.maxFileSize);
+		if (!buffer) {
+			spdlog::debug("Error reading configuration file: {}", buffer.error());
+			return std::vector<Command>{};
+		}
+
+		auto document = parse_source(source.path, buffer->view(), options);
+		if (!document) {
+			return std::unexpected(document.error());
+		}
+
+		std::vector<Command> commands;
+		if (document->includes.empty()) {
+			commands = std::move(document->commands);
+		} else {
+			auto graph = IncludeGraph(options);
+			auto loaded = graph.load(include_key(source.path), std::move(*document), source.path);
+			if (!loaded) {
+				return std::unexpected(loaded.error());
+			}
+			commands = std::move(*loaded);
+		}
+
+		if (source.userScope) {
+			for (auto& command : commands) {
+				command.userScope = true;
+			}
+		}
+
+		spdlog::debug("Loaded {} commands from {}", commands.size(), source.path);
+		return commands;
+	}
+
+	std::expected<std::vector<Command>, std::string> load_sources(const std::vector<Source>& sources, const Options& options) {
+		std::vector<std::future<std::expected<std::vector<Command>, std::string>>> pending;
+		pending.reserve(sources.size());
+
+		// The first source is loaded on the calling thread while the rest run in the background.
+		for (size_t i = 1; i < sources.size(); ++i) {
+			pending.emplace_back(std::async(std::launch::async, [&source = sources[i], &options]() {
+				return load_source(source, options);
+			}));
+		}
+
+		std::vector<Command> commands;
+		std::unordered_set<std::string> definedNames;
+
+		for (size_t i = 0; i < sources.size(); ++i) {
+			auto result = i == 0 ? load_source(sources[i], options) : pending[i - 1].get();
+			if (!result) {
+				if (sources[i].strict) {
+					return std::unexpected("Error parsing configuration " + sources[i].path + ": " + result.error());
+				}
+
+				spdlog::debug("Error parsing configuration {}: {}", sources[i].path, result.error());
+				continue;
+			}
+
+			if (sources[i].inherited) {
+				std::erase_if(*result, [&definedNames](const Command& command) {
+					return definedNames.contains(command.name);
+				});
+			}
+
+			for (const auto& command : *result) {
+				definedNames.insert(command.name);
+			}
+
+			commands.insert(commands.end(), std::make_move_iterator(result->begin()), std::make_move_iterator(result->end()));
+		}
+
+		return commands;
+	}
+} // namespace xxlib::loader
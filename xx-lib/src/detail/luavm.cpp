@@ -35,6 +35,32 @@ namespace xxlib::luavm {
 		auto _ = mod_fs::luaopen_fs(luaState.get());
 	}
 
+	void redirect_print(LuaStatePtr& luaState, const std::function<void(std::string_view)>& output) {
+		const auto print = [](lua_State* state) -> int {
+			const auto& sink = *static_cast<const std::function<void(std::string_view)>*>(lua_touserdata(state, lua_upvalueindex(1)));
+
+			std::string line;
+			const auto count = lua_gettop(state);
+			for (int i = 1; i <= count; ++i) {
+				size_t length = 0;
+				const auto* text = luaL_tolstring(state, i, &length);
+				if (i > 1) {
+					line += '\t';
+				}
+				line.append(text, length);
+				lua_pop(state, 1);
+			}
+			line += '\n';
+
+			sink(line);
+			return 0;
+		};
+
+		lua_pushlightuserdata(luaState.get(), const_cast<std::function<void(std::string_view)>*>(&output));
+		lua_pushcclosure(luaState.get(), print, 1);
+		lua_setglobal(luaState.get(), "print");
+	}
+
 	std::string version() {
 		return LUA_RELEASE;
 	}
@@ -43,6 +69,32 @@ namespace xxlib::luavm {
 		return luaL_loadstring(luaState.get(), code.c_str());
 	}
 
+	int32_t loadbytecode(LuaStatePtr& luaState, std::string_view bytecode) {
+		return luaL_loadbufferx(luaState.get(), bytecode.data(), bytecode.size(), "=bundle", "b");
+	}
+
+	std::expected<std::string, std::string> dump(LuaStatePtr& luaState, const std::string& code) {
+		if (luaL_loadstring(luaState.get(), code.c_str()) != 0) {
+			std::string error = lua_tostring(luaState.get(), -1);
+			lua_pop(luaState.get(), 1);
+			return std::unexpected(error);
+		}
+
+		std::string bytecode;
+		const auto writer = [](lua_State*, const void* data, size_t size, void* userData) -> int {
+			static_cast<std::string*>(userData)->append(static_cast<const char*>(data), size);
+			return 0;
+		};
+
+		const auto status = lua_dump(luaState.get(), writer, &bytecode, 0);
+		lua_pop(luaState.get(), 1);
+		if (status != 0) {
+			return std::unexpected("Failed to dump Lua bytecode");
+		}
+
+		return bytecode;
+	}
+
 	int32_t pcall(LuaStatePtr& luaState, int32_t nargs, int32_t nresults, int32_t errfunc) {
 		return lua_pcall(luaState.get(), nargs, nresults, errfunc);
 	}
@@ -98,4 +150,8 @@ namespace xxlib::luavm {
 	void seti(LuaStatePtr& luaState, int32_t index, int64_t n) {
 		lua_seti(luaState.get(), index, static_cast<lua_Integer>(n));
 	}
+
+	void pop(LuaStatePtr& luaState, int32_t n) {
+		lua_pop(luaState.get(), n);
+	}
 } // namespace xxlib::luavm
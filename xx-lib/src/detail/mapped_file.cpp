@@ -0,0 +1,239 @@
+#include "detail/mapped_file.hpp"
+
+#include <cstdio>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace xxlib {
+	namespace {
+		std::string format_size(size_t size) {
+			constexpr size_t MB = 1024 * 1024;
+			if (size % MB == 0) {
+				return std::to_string(size / MB) + " MB";
+			}
+			return std::to_string(size) + " bytes";
+		}
+
+		std::expected<std::string, std::string> read_stream(std::FILE* stream, const std::string& path, size_t maxSize) {
+			std::string content;
+			char chunk[64 * 1024];
+
+			while (true) {
+				const auto read = std::fread(chunk, 1, sizeof(chunk), stream);
+				if (read == 0) {
+					break;
+				}
+
+				content.append(chunk, read);
+				if (maxSize != 0 && content.size() > maxSize) {
+					return std::unexpected("File size exceeds " + format_size(maxSize) + " limit: " + path);
+				}
+			}
+
+			if (std::ferror(stream)) {
+				return std::unexpected("Failed to read file: " + path);
+			}
+
+			return content;
+		}
+	} // namespace
+
+	MappedFile::~MappedFile() {
+		release();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+		: data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)), mapped(std::exchange(other.mapped, false)), owned(std::move(other.owned)) {
+		if (!mapped) {
+			data = owned.data();
+		}
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		if (this != &other) {
+			release();
+
+			data = std::exchange(other.data, nullptr);
+			size = std::exchange(other.size, 0);
+			mapped = std::exchange(other.mapped, false);
+			owned = std::move(other.owned);
+
+			if (!mapped) {
+				data = owned.data();
+			}
+		}
+		return *this;
+	}
+
+	std::string_view MappedFile::view() const {
+		return size == 0 ? std::string_view{} : std::string_view{data, size};
+	}
+
+	bool MappedFile::is_mapped() const {
+		return mapped;
+	}
+
+	void MappedFile::release() {
+		if (mapped && data) {
+#ifdef _WIN32
+			UnmapViewOfFile(data);
+#else
+			munmap(const_cast<char*>(data), size);
+#endif
+		}
+
+		data = nullptr;
+		size = 0;
+		mapped = false;
+		owned.clear();
+	}
+
+	std::expected<MappedFile, std::string> MappedFile::open(const std::string& path, size_t maxSize) {
+		MappedFile file;
+
+		if (path == "-") {
+			// Stdin can only be read once, so later opens of "-" get a copy of what the first one read.
+			static std::mutex stdinMutex;
+			static std::optional<std::string> stdinContent;
+			std::lock_guard lock(stdinMutex);
+			if (!stdinContent) {
+				auto content = read_stream(stdin, "<stdin>", maxSize);
+				if (!content) {
+					return std::unexpected(content.error());
+				}
+				stdinContent = std::move(*content);
+			}
+
+			file.owned = *stdinContent;
+			file.data = file.owned.data();
+			file.size = file.owned.size();
+			return file;
+		}
+
+#ifdef _WIN32
+		const auto handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (handle == INVALID_HANDLE_VALUE) {
+			return std::unexpected("Failed to open file: " + path);
+		}
+
+		if (GetFileType(handle) != FILE_TYPE_DISK) {
+			CloseHandle(handle);
+
+			auto* stream = std::fopen(path.c_str(), "rb");
+			if (!stream) {
+				return std::unexpected("Failed to open file: " + path);
+			}
+
+			auto content = read_stream(stream, path, maxSize);
+			std::fclose(stream);
+			if (!content) {
+				return std::unexpected(content.error());
+			}
+
+			file.owned = std::move(*content);
+			file.data = file.owned.data();
+			file.size = file.owned.size();
+			return file;
+		}
+
+		LARGE_INTEGER fileSize{};
+		if (!GetFileSizeEx(handle, &fileSize)) {
+			CloseHandle(handle);
+			return std::unexpected("Failed to stat file: " + path);
+		}
+
+		const auto size = static_cast<size_t>(fileSize.QuadPart);
+		if (maxSize != 0 && size > maxSize) {
+			CloseHandle(handle);
+			return std::unexpected("File size exceeds " + format_size(maxSize) + " limit: " + path);
+		}
+
+		if (size == 0) {
+			CloseHandle(handle);
+			return file;
+		}
+
+		const auto mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(handle);
+		if (!mapping) {
+			return std::unexpected("Failed to map file: " + path);
+		}
+
+		const auto* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if (!view) {
+			return std::unexpected("Failed to map file: " + path);
+		}
+
+		file.data = static_cast<const char*>(view);
+		file.size = size;
+		file.mapped = true;
+		return file;
+#else
+		const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd == -1) {
+			return std::unexpected("Failed to open file: " + path);
+		}
+
+		struct stat st{};
+		if (fstat(fd, &st) == -1) {
+			::close(fd);
+			return std::unexpected("Failed to stat file: " + path);
+		}
+
+		if (!S_ISREG(st.st_mode)) {
+			auto* stream = fdopen(fd, "rb");
+			if (!stream) {
+				::close(fd);
+				return std::unexpected("Failed to open file: " + path);
+			}
+
+			auto content = read_stream(stream, path, maxSize);
+			std::fclose(stream);
+			if (!content) {
+				return std::unexpected(content.error());
+			}
+
+			file.owned = std::move(*content);
+			file.data = file.owned.data();
+			file.size = file.owned.size();
+			return file;
+		}
+
+		const auto size = static_cast<size_t>(st.st_size);
+		if (maxSize != 0 && size > maxSize) {
+			::close(fd);
+			return std::unexpected("File size exceeds " + format_size(maxSize) + " limit: " + path);
+		}
+
+		if (size == 0) {
+			::close(fd);
+			return file;
+		}
+
+		auto* mappedData = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (mappedData == MAP_FAILED) {
+			return std::unexpected("Failed to map file: " + path + ": " + std::strerror(errno));
+		}
+
+		file.data = static_cast<const char*>(mappedData);
+		file.size = size;
+		file.mapped = true;
+		return file;
+#endif
+	}
+} // namespace xxlib
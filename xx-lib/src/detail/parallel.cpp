@@ -0,0 +1,179 @@
+#include "detail/parallel.hpp"
+#include "detail/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+namespace xxlib::parallel {
+	namespace {
+		// Serializes writes from the jobs so the output of one never lands in the middle of another's.
+		class SharedOutput {
+		  public:
+			explicit SharedOutput(FILE* out) : out(out) {}
+
+			void write(std::string_view text) {
+				if (text.empty()) {
+					return;
+				}
+				std::lock_guard lock(mutex);
+				std::fwrite(text.data(), 1, text.size(), out);
+				std::fflush(out);
+			}
+
+		  private:
+			FILE* out;
+			std::mutex mutex{};
+		};
+
+		// Collects the output of one job and forwards it to the shared output as the mode requires.
+		class JobOutput {
+		  public:
+			JobOutput(SharedOutput& shared, Output mode, std::string prefix) : shared(shared), mode(mode), prefix(std::move(prefix)) {}
+
+			void append(std::string_view chunk) {
+				pending += chunk;
+				if (mode != Output::Prefixed) {
+					return;
+				}
+
+				const auto end = pending.rfind('\n');
+				if (end == std::string::npos) {
+					return;
+				}
+				shared.write(prefixed(std::string_view(pending).substr(0, end + 1)));
+				pending.erase(0, end + 1);
+			}
+
+			void finish(std::string_view header) {
+				if (!pending.empty() && pending.back() != '\n') {
+					pending += '\n';
+				}
+
+				if (mode == Output::Prefixed) {
+					shared.write(prefixed(pending));
+				} else if (!pending.empty()) {
+					shared.write(std::string(header) + pending);
+				}
+				pending.clear();
+			}
+
+		  private:
+			std::string prefixed(std::string_view lines) const {
+				std::string result;
+				result.reserve(lines.size() + prefix.size() * 8);
+				while (!lines.empty()) {
+					const auto end = lines.find('\n') + 1;
+					result += prefix;
+					result += lines.substr(0, end);
+					lines.remove_prefix(end);
+				}
+				return result;
+			}
+
+			SharedOutput& shared;
+			Output mode;
+			std::string prefix;
+			std::string pending{};
+		};
+	} // namespace
+
+	Output string_to_output(const std::string& outputStr) {
+		if (outputStr == "grouped") {
+			return Output::Grouped;
+		} else if (outputStr == "prefixed") {
+			return Output::Prefixed;
+		} else {
+			throw std::invalid_argument("Unknown output mode: " + outputStr);
+		}
+	}
+
+	std::vector<Result> run(std::vector<Job> jobs, const Options& options, FILE* out, const Execute& execute) {
+		std::vector<Result> results(jobs.size());
+		if (jobs.empty()) {
+			return results;
+		}
+
+		size_t nameWidth = 0;
+		std::vector<std::vector<size_t>> dependents(jobs.size());
+		std::vector<std::atomic<size_t>> waitingFor(jobs.size());
+		for (size_t i = 0; i < jobs.size(); ++i) {
+			nameWidth = std::max(nameWidth, jobs[i].command.name.size());
+			waitingFor[i] = jobs[i].dependsOn.size();
+			for (const auto dependency : jobs[i].dependsOn) {
+				dependents[dependency].push_back(i);
+			}
+		}
+
+		auto shared = SharedOutput(out);
+		std::atomic<bool> failed = false;
+		// Created after dispatch and destroyed before it, so jobs still draining can call it.
+		std::optional<xxlib::WorkStealingPool> pool;
+
+		// Runs job i, then hands every dependent whose last dependency this was to the pool.
+		std::function<void(size_t)> dispatch = [&](size_t i) {
+			auto& job = jobs[i];
+			auto& result = results[i];
+
+			const auto dependencyFailed = std::any_of(job.dependsOn.begin(), job.dependsOn.end(), [&results](size_t dependency) {
+				return results[dependency].status != Status::Succeeded;
+			});
+			if (!dependencyFailed && (options.keepGoing || !failed)) {
+				auto prefix = job.command.name;
+				prefix.resize(nameWidth, ' ');
+				auto output = JobOutput(shared, options.output, prefix + " | ");
+				job.context.output = [&output](std::string_view chunk) {
+					output.append(chunk);
+				};
+
+				try {
+					const auto executed = execute(job.command, job.context);
+					if (!executed) {
+						result = Result{.status = Status::Error, .exitCode = -1, .error = executed.error()};
+					} else {
+						result = Result{.status = *executed == 0 ? Status::Succeeded : Status::Failed, .exitCode = *executed};
+					}
+				} catch (const std::exception& e) {
+					result = Result{.status = Status::Error, .exitCode = -1, .error = e.what()};
+				}
+
+				if (result.status != Status::Succeeded) {
+					failed = true;
+				}
+				output.finish("==> " + job.command.name + " <==\n");
+			}
+
+			for (const auto dependent : dependents[i]) {
+				if (waitingFor[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+					pool->submit([&dispatch, dependent]() {
+						dispatch(dependent);
+					});
+				}
+			}
+		};
+
+		pool.emplace(std::min(options.jobs == 0 ? std::max(1u, std::thread::hardware_concurrency()) : options.jobs, jobs.size()));
+		for (size_t i = 0; i < jobs.size(); ++i) {
+			if (jobs[i].dependsOn.empty()) {
+				pool->submit([&dispatch, i]() {
+					dispatch(i);
+				});
+			}
+		}
+		pool.reset();
+
+		return results;
+	}
+
+	int32_t combined_exit_code(const std::vector<Result>& results) {
+		for (const auto& result : results) {
+			if (result.status == Status::Failed || result.status == Status::Error) {
+				return result.exitCode;
+			}
+		}
+		return 0;
+	}
+} // namespace xxlib::parallel
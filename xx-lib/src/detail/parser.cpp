@@ -1,211 +1,497 @@
 #include "detail/parser.hpp"
+#include "detail/constraint.hpp"
 #include "detail/renderer.hpp"
+#include "detail/yaml_events.hpp"
 
-#include <fstream>
-#include <iostream>
+#include <array>
+#include <bitset>
+#include <istream>
+#include <optional>
+#include <streambuf>
 #include <spdlog/spdlog.h>
 #include <yaml-cpp/yaml.h>
 
 namespace xxlib::parser {
-	std::expected<std::string, std::string> read_file(const std::string& path) {
-		try {
-			std::ifstream file(path);
-			if (!file.is_open()) {
-				return std::unexpected("Failed to open file: " + path);
+	namespace {
+		using EventNode = xxlib::yaml_events::Node;
+
+		// Lets yaml-cpp consume a mapped buffer in place instead of copying it into a stringstream.
+		struct ViewStreamBuffer : public std::streambuf {
+			explicit ViewStreamBuffer(std::string_view view) {
+				auto* begin = const_cast<char*>(view.data());
+				setg(begin, begin, begin + view.size());
 			}
+		};
 
-			file.seekg(0, std::ios::end);
-			std::streamsize size = file.tellg();
-			if (size > 1024 * 1024) {
-				return std::unexpected("File size exceeds 1 MB limit: " + path);
-			}
-			file.seekg(0, std::ios::beg);
+		// Uniform accessors, so the schema walk below runs on yaml-cpp DOM nodes and on event-built nodes alike.
+		bool is_null(const YAML::Node& node) {
+			return node.IsNull();
+		}
 
-			std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-			return content;
-		} catch (const std::exception& e) {
-			return std::unexpected(std::string("Error reading file: ") + e.what());
+		bool is_scalar(const YAML::Node& node) {
+			return node.IsScalar();
 		}
-	}
 
-	std::expected<Command, std::string> parse_command(const YAML::Node& node) {
-		Command command;
+		bool is_sequence(const YAML::Node& node) {
+			return node.IsSequence();
+		}
 
-		try {
-			if (!node["cmd"]) {
-				return std::unexpected("Missing 'cmd' field");
+		bool is_map(const YAML::Node& node) {
+			return node.IsMap();
+		}
+
+		const std::string& scalar(const YAML::Node& node) {
+			return node.Scalar();
+		}
+
+		size_t size(const YAML::Node& node) {
+			return node.size();
+		}
+
+		const YAML::Node& items(const YAML::Node& node) {
+			return node;
+		}
+
+		const YAML::Node& entries(const YAML::Node& node) {
+			return node;
+		}
+
+		std::optional<YAML::Node> lookup(const YAML::Node& node, const char* key) {
+			auto child = node[key];
+			return child ? std::optional(child) : std::nullopt;
+		}
+
+		bool is_null(const EventNode& node) {
+			return node.kind == EventNode::Kind::Null;
+		}
+
+		bool is_scalar(const EventNode& node) {
+			return node.kind == EventNode::Kind::Scalar;
+		}
+
+		bool is_sequence(const EventNode& node) {
+			return node.kind == EventNode::Kind::Sequence;
+		}
+
+		bool is_map(const EventNode& node) {
+			return node.kind == EventNode::Kind::Map;
+		}
+
+		const std::string& scalar(const EventNode& node) {
+			return node.scalar;
+		}
+
+		size_t size(const EventNode& node) {
+			return is_map(node) ? node.entries.size() : node.items.size();
+		}
+
+		const std::vector<EventNode>& items(const EventNode& node) {
+			return node.items;
+		}
+
+		const std::vector<std::pair<EventNode, EventNode>>& entries(const EventNode& node) {
+			return node.entries;
+		}
+
+		const EventNode* lookup(const EventNode& node, const char* key) {
+			for (const auto& [entryKey, value] : node.entries) {
+				if (is_scalar(entryKey) && entryKey.scalar == key) {
+					return &value;
+				}
 			}
+			return nullptr;
+		}
 
-			const auto& cmdNode = node["cmd"];
-			if (cmdNode.IsScalar()) {
-				command.cmd.emplace_back(cmdNode.as<std::string>());
-			} else if (cmdNode.IsSequence()) {
-				for (const auto& item : cmdNode) {
-					if (!item.IsScalar()) {
+		template <typename Node>
+		using FieldParser = std::expected<void, std::string> (*)(const Node& value, Command& command);
+
+		template <typename Node>
+		std::expected<void, std::string> parse_cmd(const Node& value, Command& command) {
+			if (is_scalar(value)) {
+				command.cmd.emplace_back(scalar(value));
+			} else if (is_sequence(value)) {
+				command.cmd.reserve(size(value));
+				for (const auto& item : items(value)) {
+					if (!is_scalar(item)) {
 						return std::unexpected("Invalid element inside 'cmd' array – must be a string");
 					}
 
-					command.cmd.emplace_back(item.as<std::string>());
+					command.cmd.emplace_back(scalar(item));
 				}
 			} else {
 				return std::unexpected("'cmd' must be either a scalar or an array of scalars");
 			}
+			return {};
+		}
 
-			if (auto renderEngine = node["render_engine"]; renderEngine && renderEngine.IsScalar()) {
-				command.renderEngine = xxlib::renderer::string_to_render_engine(renderEngine.as<std::string>());
-			} else if (renderEngine) {
+		template <typename Node>
+		std::expected<void, std::string> parse_render_engine(const Node& value, Command& command) {
+			if (!is_scalar(value)) {
 				return std::unexpected("'render_engine' must be a string");
 			}
+			command.renderEngine = xxlib::renderer::string_to_render_engine(scalar(value));
+			return {};
+		}
 
-			if (auto executionEngine = node["execution_engine"]; executionEngine && executionEngine.IsScalar()) {
-				command.executionEngine = xxlib::executor::string_to_execution_engine(executionEngine.as<std::string>());
-			} else if (executionEngine) {
+		template <typename Node>
+		std::expected<void, std::string> parse_execution_engine(const Node& value, Command& command) {
+			if (!is_scalar(value)) {
 				return std::unexpected("'execution_engine' must be a string");
 			}
+			command.executionEngine = xxlib::executor::string_to_execution_engine(scalar(value));
+			return {};
+		}
 
-			if (auto templateVars = node["template_vars"]; templateVars && templateVars.IsMap()) {
-				for (const auto& kv : templateVars) {
-					if (!kv.second.IsScalar() && !kv.second.IsNull()) {
-						return std::unexpected("All values in 'template_vars' must be strings or null");
-					}
+		template <typename Node>
+		std::expected<void, std::string> parse_template_vars(const Node& value, Command& command) {
+			if (!is_map(value)) {
+				return std::unexpected("'template_vars' must be a map");
+			}
 
-					auto valueStr = kv.second.IsNull() ? "" : kv.second.as<std::string>();
-					command.templateVars.emplace(kv.first.as<std::string>(), valueStr);
+			command.templateVars.reserve(size(value));
+			for (const auto& kv : entries(value)) {
+				if (!is_scalar(kv.second) && !is_null(kv.second)) {
+					return std::unexpected("All values in 'template_vars' must be strings or null");
 				}
-			} else if (templateVars) {
-				return std::unexpected("'template_vars' must be a map");
+
+				command.templateVars.emplace(scalar(kv.first), is_null(kv.second) ? "" : scalar(kv.second));
 			}
+			return {};
+		}
 
-			if (auto env = node["env"]; env && env.IsMap()) {
-				for (const auto& kv : env) {
-					if (!kv.second.IsScalar()) {
-						return std::unexpected("All values in 'env' must be strings");
-					}
+		template <typename Node>
+		std::expected<void, std::string> parse_env(const Node& value, Command& command) {
+			if (!is_map(value)) {
+				return std::unexpected("'env' must be a map");
+			}
 
-					command.envs.emplace(kv.first.as<std::string>(), kv.second.as<std::string>());
+			command.envs.reserve(size(value));
+			for (const auto& kv : entries(value)) {
+				if (!is_scalar(kv.second)) {
+					return std::unexpected("All values in 'env' must be strings");
 				}
-			} else if (env) {
-				return std::unexpected("'env' must be a map");
+
+				command.envs.emplace(scalar(kv.first), scalar(kv.second));
 			}
+			return {};
+		}
 
-			if (auto constraints = node["constraints"]; constraints && constraints.IsSequence()) {
-				for (auto i = 0; i < constraints.size(); ++i) {
-					const auto& item = constraints[i];
+		template <typename Node>
+		std::expected<void, std::string> parse_constraints(const Node& value, Command& command) {
+			if (!is_sequence(value)) {
+				return std::unexpected("'constraints' must be a sequence");
+			}
 
-					if (!item.IsMap() || item.size() != 1) {
-						return std::unexpected("Each constraint must be a map with a single key/value pair");
-					}
+			command.constraints.reserve(size(value));
+			for (const auto& item : items(value)) {
+				if (!is_map(item) || size(item) != 1) {
+					return std::unexpected("Each constraint must be a map with a single key/value pair");
+				}
 
-					const auto pair = item.begin();
+				const auto pair = *entries(item).begin();
 
-					const auto key = pair->first;
-					const auto value = pair->second;
+				const auto& key = pair.first;
+				const auto& constraintValue = pair.second;
 
-					if (!key.IsScalar() || !value.IsScalar()) {
-						return std::unexpected("Constraint keys and values must be strings");
-					}
+				if (!is_scalar(key)) {
+					return std::unexpected("Constraint keys and values must be strings");
+				}
 
-					command.constraints.emplace_back(key.Scalar(), value.Scalar());
+				if (is_scalar(constraintValue)) {
+					command.constraints.emplace_back(scalar(key), scalar(constraintValue));
+					continue;
 				}
-			} else if (constraints) {
-				return std::unexpected("'constraints' must be a sequence");
+
+				// A list of values matches any of them and is kept in the comma-separated form constraint::compile reads.
+				if (!is_sequence(constraintValue) || size(constraintValue) == 0) {
+					return std::unexpected("Constraint values must be strings or non-empty lists of strings");
+				}
+
+				std::string joined;
+				for (const auto& alternative : items(constraintValue)) {
+					if (!is_scalar(alternative)) {
+						return std::unexpected("Constraint values must be strings or non-empty lists of strings");
+					}
+					if (!joined.empty()) {
+						joined += ',';
+					}
+					joined += scalar(alternative);
+				}
+				command.constraints.emplace_back(scalar(key), std::move(joined));
 			}
+			return {};
+		}
 
-			if (auto requiresConfirmation = node["requires_confirmation"]; requiresConfirmation && requiresConfirmation.IsScalar()) {
-				const auto raw = requiresConfirmation.Scalar();
-				if (raw == "true") {
-					command.requiresConfirmation = true;
-				} else if (raw == "false") {
-					command.requiresConfirmation = false;
-				} else {
-					return std::unexpected("'requires_confirmation' must be a boolean (true/false)");
+		template <typename Node>
+		std::expected<void, std::string> parse_names(const Node& value, std::string_view key, std::string_view what, std::vector<std::string>& names) {
+			if (is_scalar(value)) {
+				names.emplace_back(scalar(value));
+			} else if (is_sequence(value)) {
+				names.reserve(size(value));
+				for (const auto& item : items(value)) {
+					if (!is_scalar(item)) {
+						return std::unexpected("Invalid element inside '" + std::string(key) + "' array – must be " + std::string(what));
+					}
+
+					names.emplace_back(scalar(item));
 				}
-			} else if (requiresConfirmation) {
+			} else {
+				return std::unexpected("'" + std::string(key) + "' must be either " + std::string(what) + " or an array of them");
+			}
+			return {};
+		}
+
+		template <typename Node>
+		std::expected<void, std::string> parse_depends_on(const Node& value, Command& command) {
+			return parse_names(value, "depends_on", "an alias name", command.dependsOn);
+		}
+
+		template <typename Node>
+		std::expected<void, std::string> parse_inputs(const Node& value, Command& command) {
+			return parse_names(value, "inputs", "a glob pattern", command.inputs);
+		}
+
+		template <typename Node>
+		std::expected<void, std::string> parse_outputs(const Node& value, Command& command) {
+			return parse_names(value, "outputs", "a glob pattern", command.outputs);
+		}
+
+		template <typename Node>
+		std::expected<void, std::string> parse_cache_env(const Node& value, Command& command) {
+			return parse_names(value, "cache_env", "a variable name", command.cacheEnv);
+		}
+
+		template <typename Node>
+		std::expected<void, std::string> parse_requires_confirmation(const Node& value, Command& command) {
+			if (!is_scalar(value)) {
 				return std::unexpected("'requires_confirmation' must be a boolean");
 			}
-		} catch (const YAML::Exception& e) {
-			return std::unexpected(std::string("YAML parsing error: ") + e.what());
-		} catch (const std::exception& e) {
-			return std::unexpected(e.what());
+
+			const auto& raw = scalar(value);
+			if (raw == "true") {
+				command.requiresConfirmation = true;
+			} else if (raw == "false") {
+				command.requiresConfirmation = false;
+			} else {
+				return std::unexpected("'requires_confirmation' must be a boolean (true/false)");
+			}
+			return {};
 		}
 
-		if (command.cmd.empty()) {
-			return std::unexpected("Command 'cmd' cannot be empty");
+		template <typename Node>
+		std::expected<void, std::string> parse_cache(const Node& value, Command& command) {
+			if (!is_scalar(value)) {
+				return std::unexpected("'cache' must be a boolean");
+			}
+
+			const auto& raw = scalar(value);
+			if (raw == "true") {
+				command.cacheResults = true;
+			} else if (raw == "false") {
+				command.cacheResults = false;
+			} else {
+				return std::unexpected("'cache' must be a boolean (true/false)");
+			}
+			return {};
 		}
 
-		return command;
-	}
+		template <typename Node>
+		struct Field {
+			std::string_view key;
+			FieldParser<Node> parse;
+		};
+
+		// Every key accepted inside an alias definition. 'name' belongs to the flat 'aliases' format and is read by the caller.
+		template <typename Node>
+		constexpr std::array FIELDS{
+			Field<Node>{"cmd", parse_cmd<Node>},
+			Field<Node>{"render_engine", parse_render_engine<Node>},
+			Field<Node>{"execution_engine", parse_execution_engine<Node>},
+			Field<Node>{"template_vars", parse_template_vars<Node>},
+			Field<Node>{"env", parse_env<Node>},
+			Field<Node>{"constraints", parse_constraints<Node>},
+			Field<Node>{"requires_confirmation", parse_requires_confirmation<Node>},
+			Field<Node>{"depends_on", parse_depends_on<Node>},
+			Field<Node>{"inputs", parse_inputs<Node>},
+			Field<Node>{"outputs", parse_outputs<Node>},
+			Field<Node>{"cache", parse_cache<Node>},
+			Field<Node>{"cache_env", parse_cache_env<Node>},
+			Field<Node>{"name", nullptr},
+		};
+
+		template <typename Node>
+		constexpr const Field<Node>* find_field(std::string_view key) {
+			for (const auto& field : FIELDS<Node>) {
+				if (field.key == key) {
+					return &field;
+				}
+			}
+			return nullptr;
+		}
 
-	std::expected<std::vector<Command>, std::string> parse_buffer(const std::string& buffer) {
-		try {
-			const YAML::Node root = YAML::Load(buffer);
-			if (!root.IsMap()) {
+		static_assert(find_field<YAML::Node>("cmd") == &FIELDS<YAML::Node>[0]);
+
+		template <typename Node>
+		std::expected<Command, std::string> parse_command(const Node& node, std::string_view aliasName) {
+			Command command;
+			auto hasCmd = false;
+			// A repeated key is read once, from its first occurrence, as a lookup by key would.
+			std::bitset<FIELDS<Node>.size()> seen;
+
+			try {
+				for (const auto& entry : entries(node)) {
+					const auto& key = scalar(entry.first);
+
+					const auto* field = find_field<Node>(key);
+					if (!field) {
+						spdlog::warn("Ignoring unknown key '{}' in alias '{}'", key, aliasName);
+						continue;
+					}
+
+					if (!field->parse) {
+						continue;
+					}
+
+					const auto index = static_cast<size_t>(field - FIELDS<Node>.data());
+					if (seen.test(index)) {
+						continue;
+					}
+					seen.set(index);
+
+					if (const auto parsed = field->parse(entry.second, command); !parsed) {
+						return std::unexpected(parsed.error());
+					}
+
+					hasCmd = hasCmd || field->key == "cmd";
+				}
+			} catch (const YAML::Exception& e) {
+				return std::unexpected(std::string("YAML parsing error: ") + e.what());
+			} catch (const std::exception& e) {
+				return std::unexpected(e.what());
+			}
+
+			if (!hasCmd) {
+				return std::unexpected("Missing 'cmd' field");
+			}
+
+			if (command.cmd.empty()) {
+				return std::unexpected("Command 'cmd' cannot be empty");
+			}
+
+			std::vector<std::string> warnings;
+			command.constraintMask = xxlib::constraint::compile(command.constraints, warnings);
+			for (const auto& warning : warnings) {
+				spdlog::warn("{} in alias '{}'", warning, aliasName);
+			}
+
+			return command;
+		}
+
+		// When onlyName is set, aliases with any other name are skipped before parse_command touches them.
+		template <typename Node>
+		std::expected<Document, std::string> walk_root(const Node& root, std::optional<std::string_view> onlyName) {
+			if (!is_map(root)) {
 				return std::unexpected("Root of the config must be a map");
 			}
 
-			const auto aliasNode = root["alias"];
+			Document document;
+
+			const auto includeNode = lookup(root, "include");
+			if (includeNode && is_scalar(*includeNode)) {
+				document.includes.emplace_back(scalar(*includeNode));
+			} else if (includeNode && is_sequence(*includeNode)) {
+				for (const auto& item : items(*includeNode)) {
+					if (!is_scalar(item)) {
+						return std::unexpected("Each element of 'include' must be a string");
+					}
+
+					document.includes.emplace_back(scalar(item));
+				}
+			} else if (includeNode && !is_null(*includeNode)) {
+				return std::unexpected("'include' must be a string or an array of strings");
+			}
+
+			const auto aliasNode = lookup(root, "alias");
 			if (!aliasNode) {
-				const auto flatNode = root["aliases"];
-				if (!flatNode || !flatNode.IsSequence()) {
+				const auto flatNode = lookup(root, "aliases");
+				if (!flatNode && includeNode) {
+					return document;
+				}
+
+				if (!flatNode || !is_sequence(*flatNode)) {
 					return std::unexpected("No 'alias' (or 'aliases') section found in config");
 				}
 
-				std::vector<Command> cmds;
+				auto& cmds = document.commands;
 
-				for (const auto& entry : flatNode) {
-					if (!entry.IsMap()) {
+				for (const auto& entry : items(*flatNode)) {
+					if (!is_map(entry)) {
 						return std::unexpected("Each element of 'aliases' must be a map");
 					}
 
-					const auto nameNode = entry["name"];
-					if (!nameNode || !nameNode.IsScalar()) {
+					const auto nameNode = lookup(entry, "name");
+					if (!nameNode || !is_scalar(*nameNode)) {
 						return std::unexpected("Alias entry is missing a string 'name' field");
 					}
 
-					const auto aliasName = nameNode.as<std::string>();
+					const auto& aliasName = scalar(*nameNode);
+					if (onlyName && aliasName != *onlyName) {
+						continue;
+					}
 
-					auto opt = parse_command(entry);
+					auto opt = parse_command<Node>(entry, aliasName);
 					if (!opt) {
 						spdlog::error("Error parsing command for alias '{}': {}", aliasName, opt.error());
 						continue;
 					}
 
-					auto cmd = *opt;
+					auto cmd = std::move(*opt);
 					cmd.name = aliasName;
 					cmds.emplace_back(std::move(cmd));
 				}
-				return cmds;
+				return document;
 			}
 
-			std::vector<Command> commands;
+			if (is_sequence(*aliasNode)) {
+				return std::unexpected("'alias' must be a map of alias names to definitions");
+			}
 
-			for (const auto& aliasPair : aliasNode) {
-				const auto aliasName = aliasPair.first.as<std::string>();
-				const auto aliasVal = aliasPair.second;
+			auto& commands = document.commands;
+			if (!onlyName) {
+				commands.reserve(size(*aliasNode));
+			}
+
+			for (const auto& aliasPair : entries(*aliasNode)) {
+				const auto& aliasName = scalar(aliasPair.first);
+				if (onlyName && aliasName != *onlyName) {
+					continue;
+				}
 
-				if (aliasVal.IsMap()) {
-					auto opt = parse_command(aliasVal);
+				const auto& aliasVal = aliasPair.second;
+
+				if (is_map(aliasVal)) {
+					auto opt = parse_command<Node>(aliasVal, aliasName);
 					if (!opt) {
 						spdlog::error("Error parsing command for alias '{}': {}", aliasName, opt.error());
-                        continue;
+						continue;
 					}
 
-					auto cmd = *opt;
+					auto cmd = std::move(*opt);
 					cmd.name = aliasName;
 					commands.emplace_back(std::move(cmd));
-				} else if (aliasVal.IsSequence()) {
-					for (const auto& item : aliasVal) {
-						if (!item.IsMap()) {
+				} else if (is_sequence(aliasVal)) {
+					for (const auto& item : items(aliasVal)) {
+						if (!is_map(item)) {
 							return std::unexpected("Each element of alias." + aliasName + " must be a table");
 						}
 
-						auto opt = parse_command(item);
+						auto opt = parse_command<Node>(item, aliasName);
 						if (!opt) {
 							spdlog::error("Error parsing command for alias '{}': {}", aliasName, opt.error());
-                            continue;
+							continue;
 						}
 
-						auto cmd = *opt;
+						auto cmd = std::move(*opt);
 						cmd.name = aliasName;
 						commands.emplace_back(std::move(cmd));
 					}
@@ -214,12 +500,79 @@ namespace xxlib::parser {
 				}
 			}
 
-			return commands;
-		} catch (const YAML::ParserException& e) {
-			return std::unexpected(std::string("YAML parse error: ") + e.what());
+			return document;
+		}
+
+		std::expected<Document, std::string> parse_root(std::string_view buffer, std::optional<std::string_view> onlyName, Backend backend) {
+			try {
+				if (backend == Backend::Events) {
+					ViewStreamBuffer streamBuffer(buffer);
+					std::istream stream(&streamBuffer);
+
+					if (const auto root = xxlib::yaml_events::load(stream, onlyName)) {
+						return walk_root(*root, onlyName);
+					}
+					spdlog::debug("Configuration refers to an anchor inside a skipped alias, falling back to the DOM parser");
+				}
+
+				ViewStreamBuffer streamBuffer(buffer);
+				std::istream stream(&streamBuffer);
+
+				const YAML::Node root = YAML::Load(stream);
+				return walk_root(root, onlyName);
+			} catch (const YAML::ParserException& e) {
+				return std::unexpected(std::string("YAML parse error: ") + e.what());
+			} catch (const std::exception& e) {
+				return std::unexpected(std::string("Error parsing buffer: ") + e.what());
+			}
+		}
+	} // namespace
+
+	Backend string_to_backend(const std::string& backendStr) {
+		if (backendStr == "dom") {
+			return Backend::Dom;
+		}
+		return Backend::Events;
+	}
+
+	std::expected<xxlib::MappedFile, std::string> map_file(const std::string& path, size_t maxSize) {
+		try {
+			return xxlib::MappedFile::open(path, maxSize);
 		} catch (const std::exception& e) {
-			return std::unexpected(std::string("Error parsing buffer: ") + e.what());
+			return std::unexpected(std::string("Error reading file: ") + e.what());
+		}
+	}
+
+	std::expected<std::string, std::string> read_file(const std::string& path, size_t maxSize) {
+		auto file = map_file(path, maxSize);
+		if (!file) {
+			return std::unexpected(file.error());
 		}
+
+		return std::string(file->view());
+	}
+
+	std::expected<Document, std::string> parse_document(std::string_view buffer, Backend backend) {
+		return parse_root(buffer, std::nullopt, backend);
+	}
+
+	std::expected<Document, std::string> parse_document_for(std::string_view buffer, std::string_view commandName, Backend backend) {
+		return parse_root(buffer, commandName, backend);
 	}
 
+	std::expected<std::vector<Command>, std::string> parse_buffer(std::string_view buffer, Backend backend) {
+		auto document = parse_root(buffer, std::nullopt, backend);
+		if (!document) {
+			return std::unexpected(document.error());
+		}
+		return std::move(document->commands);
+	}
+
+	std::expected<std::vector<Command>, std::string> parse_buffer_for(std::string_view buffer, std::string_view commandName, Backend backend) {
+		auto document = parse_root(buffer, commandName, backend);
+		if (!document) {
+			return std::unexpected(document.error());
+		}
+		return std::move(document->commands);
+	}
 } // namespace xxlib::parser
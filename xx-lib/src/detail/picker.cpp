@@ -0,0 +1,324 @@
+#include "detail/picker.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace xxlib::picker {
+	namespace {
+		constexpr char ESCAPE = '\x1b';
+		constexpr std::string_view PROMPT = "> ";
+		constexpr std::string_view HIGHLIGHT = "\x1b[7m";
+		constexpr std::string_view RESET = "\x1b[0m";
+
+		// Raw, unechoed access to the controlling terminal for the lifetime of the object.
+		class Terminal {
+		  public:
+			Terminal() {
+#ifdef _WIN32
+				input = GetStdHandle(STD_INPUT_HANDLE);
+				output = GetStdHandle(STD_OUTPUT_HANDLE);
+				if (!GetConsoleMode(input, &inputMode) || !GetConsoleMode(output, &outputMode)) {
+					error = "Not running in a console";
+					return;
+				}
+				SetConsoleMode(input, ENABLE_VIRTUAL_TERMINAL_INPUT);
+				SetConsoleMode(output, outputMode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+#else
+				fd = ::open("/dev/tty", O_RDWR | O_CLOEXEC);
+				if (fd < 0 || tcgetattr(fd, &original) != 0) {
+					error = "No terminal available";
+					return;
+				}
+				auto raw = original;
+				raw.c_iflag &= ~static_cast<tcflag_t>(BRKINT | ICRNL | INPCK | ISTRIP | IXON);
+				raw.c_lflag &= ~static_cast<tcflag_t>(ECHO | ICANON | IEXTEN | ISIG);
+				raw.c_cc[VMIN] = 1;
+				raw.c_cc[VTIME] = 0;
+				tcsetattr(fd, TCSAFLUSH, &raw);
+#endif
+				write("\x1b[?1049h");
+			}
+
+			~Terminal() {
+				if (!error.empty()) {
+#ifndef _WIN32
+					if (fd >= 0) {
+						::close(fd);
+					}
+#endif
+					return;
+				}
+
+				write("\x1b[?1049l");
+#ifdef _WIN32
+				SetConsoleMode(input, inputMode);
+				SetConsoleMode(output, outputMode);
+#else
+				tcsetattr(fd, TCSAFLUSH, &original);
+				::close(fd);
+#endif
+			}
+
+			Terminal(const Terminal&) = delete;
+			Terminal& operator=(const Terminal&) = delete;
+
+			[[nodiscard]] std::string read() const {
+				char chunk[64];
+#ifdef _WIN32
+				DWORD count = 0;
+				if (!ReadFile(input, chunk, sizeof(chunk), &count, nullptr)) {
+					return {};
+				}
+#else
+				const auto count = ::read(fd, chunk, sizeof(chunk));
+				if (count <= 0) {
+					return {};
+				}
+#endif
+				return std::string(chunk, static_cast<size_t>(count));
+			}
+
+			void write(std::string_view data) const {
+#ifdef _WIN32
+				DWORD written = 0;
+				WriteFile(output, data.data(), static_cast<DWORD>(data.size()), &written, nullptr);
+#else
+				while (!data.empty()) {
+					const auto written = ::write(fd, data.data(), data.size());
+					if (written <= 0) {
+						return;
+					}
+					data.remove_prefix(static_cast<size_t>(written));
+				}
+#endif
+			}
+
+			// Rows and columns, with a conservative default when the size is unknown.
+			[[nodiscard]] std::pair<size_t, size_t> size() const {
+#ifdef _WIN32
+				CONSOLE_SCREEN_BUFFER_INFO info;
+				if (GetConsoleScreenBufferInfo(output, &info)) {
+					return {static_cast<size_t>(info.srWindow.Bottom - info.srWindow.Top + 1), static_cast<size_t>(info.srWindow.Right - info.srWindow.Left + 1)};
+				}
+#else
+				winsize window{};
+				if (ioctl(fd, TIOCGWINSZ, &window) == 0 && window.ws_row > 0 && window.ws_col > 0) {
+					return {window.ws_row, window.ws_col};
+				}
+#endif
+				return {24, 80};
+			}
+
+			std::string error{};
+
+		  private:
+#ifdef _WIN32
+			HANDLE input = nullptr;
+			HANDLE output = nullptr;
+			DWORD inputMode = 0;
+			DWORD outputMode = 0;
+#else
+			int fd = -1;
+			termios original{};
+#endif
+		};
+	} // namespace
+
+	std::vector<Key> decode_keys(std::string_view input) {
+		std::vector<Key> keys;
+
+		for (size_t i = 0; i < input.size(); ++i) {
+			const auto c = input[i];
+
+			if (c == ESCAPE) {
+				if (i + 2 < input.size() && (input[i + 1] == '[' || input[i + 1] == 'O')) {
+					const auto code = input[i + 2];
+					if (code == 'A') {
+						keys.push_back({.kind = KeyKind::Up});
+					} else if (code == 'B') {
+						keys.push_back({.kind = KeyKind::Down});
+					}
+					// Skip the parameters and final byte of any other CSI sequence.
+					i += 2;
+					while (i < input.size() && (input[i] < 0x40 || input[i] > 0x7e)) {
+						++i;
+					}
+					continue;
+				}
+				keys.push_back({.kind = KeyKind::Cancel});
+				continue;
+			}
+
+			switch (c) {
+			case '\r':
+			case '\n':
+				keys.push_back({.kind = KeyKind::Accept});
+				break;
+			case 0x03: // Ctrl-C
+			case 0x07: // Ctrl-G
+				keys.push_back({.kind = KeyKind::Cancel});
+				break;
+			case 0x7f:
+			case 0x08:
+				keys.push_back({.kind = KeyKind::Backspace});
+				break;
+			case 0x15: // Ctrl-U
+				keys.push_back({.kind = KeyKind::ClearQuery});
+				break;
+			case 0x10: // Ctrl-P
+				keys.push_back({.kind = KeyKind::Up});
+				break;
+			case 0x0e: // Ctrl-N
+				keys.push_back({.kind = KeyKind::Down});
+				break;
+			default:
+				if (static_cast<unsigned char>(c) >= 0x20) {
+					keys.push_back({.kind = KeyKind::Character, .character = c});
+				}
+			}
+		}
+
+		return keys;
+	}
+
+	Picker::Picker(const xxlib::FuzzyIndex& index) : index(index) {
+		levels.push_back(index.filter(""));
+	}
+
+	Action Picker::handle(const Key& key) {
+		switch (key.kind) {
+		case KeyKind::Character:
+			currentQuery += key.character;
+			levels.push_back(index.filter(currentQuery, levels.back()));
+			cursor = 0;
+			return Action::Continue;
+		case KeyKind::Backspace:
+			if (!currentQuery.empty()) {
+				currentQuery.pop_back();
+				levels.pop_back();
+				cursor = 0;
+			}
+			return Action::Continue;
+		case KeyKind::ClearQuery:
+			currentQuery.clear();
+			levels.resize(1);
+			cursor = 0;
+			return Action::Continue;
+		case KeyKind::Up:
+			cursor = cursor > 0 ? cursor - 1 : 0;
+			return Action::Continue;
+		case KeyKind::Down:
+			if (cursor + 1 < matches().size()) {
+				++cursor;
+			}
+			return Action::Continue;
+		case KeyKind::Accept:
+			return selected() ? Action::Accept : Action::Continue;
+		case KeyKind::Cancel:
+			return Action::Cancel;
+		}
+		return Action::Continue;
+	}
+
+	std::string_view Picker::query() const {
+		return currentQuery;
+	}
+
+	std::span<const xxlib::FuzzyIndex::Match> Picker::matches() const {
+		return levels.back();
+	}
+
+	std::optional<uint32_t> Picker::selected() const {
+		const auto current = matches();
+		if (cursor >= current.size()) {
+			return std::nullopt;
+		}
+		return current[cursor].index;
+	}
+
+	std::vector<std::string> Picker::frame(size_t height, size_t width) const {
+		const auto fit = [width](std::string_view text) {
+			return std::string(text.substr(0, width));
+		};
+
+		std::vector<std::string> lines;
+		lines.push_back(fit(std::string(PROMPT) + currentQuery));
+		if (height < 2) {
+			return lines;
+		}
+		lines.push_back(fit("  " + std::to_string(matches().size()) + "/" + std::to_string(index.size())));
+
+		const auto rows = height - 2;
+		const auto current = matches();
+		// Scrolls just enough to keep the cursor on screen.
+		const auto first = cursor >= rows ? cursor - rows + 1 : 0;
+		for (size_t i = first; i < current.size() && i < first + rows; ++i) {
+			const auto line = fit((i == cursor ? "> " : "  ") + std::string(index.name(current[i].index)));
+			lines.push_back(i == cursor ? std::string(HIGHLIGHT) + line + std::string(RESET) : line);
+		}
+
+		return lines;
+	}
+
+	std::string ScreenDiff::render(const std::vector<std::string>& frame, size_t cursorRow, size_t cursorColumn) {
+		std::string out;
+
+		for (size_t row = 0; row < std::max(frame.size(), previous.size()); ++row) {
+			if (row < frame.size() && row < previous.size() && frame[row] == previous[row]) {
+				continue;
+			}
+
+			out += "\x1b[" + std::to_string(row + 1) + ";1H";
+			if (row < frame.size()) {
+				out += frame[row];
+			}
+			out += "\x1b[K";
+		}
+
+		out += "\x1b[" + std::to_string(cursorRow + 1) + ";" + std::to_string(cursorColumn + 1) + "H";
+		previous = frame;
+		return out;
+	}
+
+	std::expected<std::optional<uint32_t>, std::string> run(const xxlib::FuzzyIndex& index) {
+		const Terminal terminal;
+		if (!terminal.error.empty()) {
+			return std::unexpected(terminal.error);
+		}
+
+		auto picker = Picker(index);
+		auto screen = ScreenDiff();
+		terminal.write("\x1b[2J");
+
+		while (true) {
+			const auto [height, width] = terminal.size();
+			const auto cursorColumn = std::min(PROMPT.size() + picker.query().size(), width > 0 ? width - 1 : 0);
+			terminal.write(screen.render(picker.frame(height, width), 0, cursorColumn));
+
+			const auto input = terminal.read();
+			if (input.empty()) {
+				return std::nullopt;
+			}
+
+			for (const auto& key : decode_keys(input)) {
+				switch (picker.handle(key)) {
+				case Action::Accept:
+					return picker.selected();
+				case Action::Cancel:
+					return std::nullopt;
+				case Action::Continue:
+					break;
+				}
+			}
+		}
+	}
+} // namespace xxlib::picker
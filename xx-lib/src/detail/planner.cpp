@@ -1,33 +1,110 @@
 #include "detail/planner.hpp"
-#include "detail/platform.hpp"
+#include "detail/constraint.hpp"
 
-#include <functional>
+#include <algorithm>
+#include <unordered_map>
+#include <spdlog/spdlog.h>
 
 namespace xxlib::planner {
-	bool matches_constraints(const Command& command) {
-		for (const auto& [key, value] : command.constraints) {
-			if (key == "os") {
-				if (xxlib::platform::string_to_os(value) != xxlib::platform::get_current_os()) {
-					return false;
+	namespace {
+		std::string join_names(const std::vector<std::string_view>& names) {
+			constexpr size_t MAX_LISTED = 8;
+
+			std::string joined;
+			for (size_t i = 0; i < names.size() && i < MAX_LISTED; ++i) {
+				if (i > 0) {
+					joined += ", ";
 				}
-			} else if (key == "arch") {
-				if (xxlib::platform::string_to_architecture(value) != xxlib::platform::get_current_architecture()) {
-					return false;
+				joined += names[i];
+			}
+			if (names.size() > MAX_LISTED) {
+				joined += ", ...";
+			}
+			return joined;
+		}
+
+		// Depth-first walk over depends_on that appends every step after the steps it depends on.
+		class GraphBuilder {
+		  public:
+			GraphBuilder(const xxlib::CommandRegistry& registry, std::unordered_map<const Command*, const std::vector<std::string>*> requestedExtras)
+				: registry(registry), requestedExtras(std::move(requestedExtras)) {}
+
+			std::expected<size_t, std::string> visit(const Command* command) {
+				if (const auto found = stepOf.find(command); found != stepOf.end()) {
+					return found->second;
 				}
-			} else if (key == "osfamily") {
-				if (xxlib::platform::string_to_os_family(value) != xxlib::platform::get_current_os_family()) {
-					return false;
+
+				if (const auto onPath = std::find(path.begin(), path.end(), command); onPath != path.end()) {
+					std::string cycle;
+					for (auto it = onPath; it != path.end(); ++it) {
+						cycle += (*it)->name + " -> ";
+					}
+					return std::unexpected("Dependency cycle: " + cycle + command->name);
 				}
-			} else {
-				return false;
+
+				path.push_back(command);
+				std::vector<size_t> dependsOn;
+				for (const auto& name : command->dependsOn) {
+					if (registry.candidates(name).empty()) {
+						return std::unexpected("Alias '" + command->name + "' depends on unknown alias '" + name + "'");
+					}
+					const auto dependency = plan_single(registry, name);
+					if (!dependency) {
+						return std::unexpected("Alias '" + command->name + "' depends on '" + name + "': " + dependency.error());
+					}
+
+					const auto index = visit(*dependency);
+					if (!index) {
+						return index;
+					}
+					if (std::find(dependsOn.begin(), dependsOn.end(), *index) == dependsOn.end()) {
+						dependsOn.push_back(*index);
+					}
+				}
+				path.pop_back();
+
+				auto step = Step{.command = command, .dependsOn = std::move(dependsOn)};
+				if (const auto extras = requestedExtras.find(command); extras != requestedExtras.end()) {
+					step.extras = *extras->second;
+				}
+				steps.push_back(std::move(step));
+				stepOf.emplace(command, steps.size() - 1);
+				return steps.size() - 1;
+			}
+
+			std::vector<Step> steps{};
+
+		  private:
+			const xxlib::CommandRegistry& registry;
+			std::unordered_map<const Command*, const std::vector<std::string>*> requestedExtras;
+			std::unordered_map<const Command*, size_t> stepOf{};
+			std::vector<const Command*> path{};
+		};
+
+		// Appends the comma separated items of text to extras, skipping empty ones.
+		void append_items(std::string_view text, std::vector<std::string>& extras) {
+			while (!text.empty()) {
+				const auto comma = text.find(',');
+				if (const auto item = text.substr(0, comma); !item.empty()) {
+					extras.emplace_back(item);
+				}
+				text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
 			}
 		}
+	} // namespace
 
-		return true;
+	bool matches_constraints(const Command& command) {
+		const auto mask = command.constraintMask != xxlib::constraint::NOT_COMPILED ? command.constraintMask : xxlib::constraint::compile(command.constraints);
+
+		// Probes run only for aliases the platform already allows.
+		if (!xxlib::constraint::matches(mask)) {
+			return false;
+		}
+		return (mask & xxlib::constraint::DYNAMIC) == 0 || xxlib::constraint::matches_dynamic(command.constraints);
 	}
 
-	std::expected<Command, std::string> plan_single(const std::vector<Command>& commands, const std::string& commandName) {
-		std::vector<std::reference_wrapper<const Command>> matchedCommands;
+	std::expected<const Command*, std::string> plan_single(const std::vector<Command>& commands, const std::string& commandName) {
+		const Command* matchedCommand = nullptr;
 
 		for (const auto& command : commands) {
 			if (command.name != commandName) {
@@ -35,16 +112,156 @@ namespace xxlib::planner {
 			}
 
 			if (matches_constraints(command)) {
-				matchedCommands.push_back(std::cref(command));
+				if (matchedCommand) {
+					return std::unexpected("Multiple matching commands found for name: " + commandName);
+				}
+				matchedCommand = &command;
 			}
 		}
 
-		if (matchedCommands.size() == 1) {
-			return matchedCommands.front().get();
-		} else if (matchedCommands.size() > 1) {
-			return std::unexpected("Multiple matching commands found for name: " + commandName);
+		if (matchedCommand) {
+			return matchedCommand;
 		}
 
 		return std::unexpected("No matching command found for name: " + commandName);
 	}
+
+	std::expected<const Command*, std::string> plan_single(const xxlib::CommandRegistry& registry, const std::string& commandName) {
+		const Command* matchedCommand = nullptr;
+
+		const auto candidates = registry.candidates(commandName);
+		for (const auto index : candidates) {
+			if (!registry.satisfied(index)) {
+				continue;
+			}
+
+			if (matchedCommand) {
+				return std::unexpected("Multiple matching commands found for name: " + commandName);
+			}
+			matchedCommand = &registry.commands()[index];
+		}
+
+		if (matchedCommand) {
+			return matchedCommand;
+		}
+
+		if (!candidates.empty()) {
+			return std::unexpected("No matching command found for name: " + commandName);
+		}
+
+		// An unknown name may abbreviate exactly one alias; otherwise the closest names are suggested.
+		const auto prefixed = registry.names_with_prefix(commandName);
+		if (prefixed.size() == 1) {
+			spdlog::debug("Resolved '{}' to alias '{}'", commandName, prefixed.front());
+			return plan_single(registry, std::string(prefixed.front()));
+		}
+		if (prefixed.size() > 1) {
+			return std::unexpected("Ambiguous command name '" + commandName + "', it could be: " + join_names(prefixed));
+		}
+
+		const auto suggestions = registry.suggestions(commandName);
+		if (suggestions.empty()) {
+			return std::unexpected("No matching command found for name: " + commandName);
+		}
+		return std::unexpected("No matching command found for name: " + commandName + ", did you mean: " + join_names(suggestions) + "?");
+	}
+
+	std::expected<std::vector<Invocation>, std::string> parse_invocations(const std::vector<std::string>& words) {
+		std::vector<Invocation> invocations;
+
+		for (size_t i = 0; i < words.size(); ++i) {
+			const std::string_view word = words[i];
+			const auto bracket = word.find('[');
+
+			if (bracket == std::string_view::npos) {
+				if (word.find('=') == std::string_view::npos) {
+					invocations.push_back(Invocation{.name = std::string(word)});
+				} else if (invocations.empty()) {
+					return std::unexpected("Expected a command name before '" + std::string(word) + "'");
+				} else {
+					invocations.back().extras.emplace_back(word);
+				}
+				continue;
+			}
+
+			if (bracket == 0) {
+				return std::unexpected("Expected a command name before '" + std::string(word) + "'");
+			}
+
+			// The brackets may span several words when the shell split them at spaces.
+			auto invocation = Invocation{.name = std::string(word.substr(0, bracket))};
+			auto rest = word.substr(bracket + 1);
+			while (!rest.ends_with(']')) {
+				append_items(rest, invocation.extras);
+				if (++i == words.size()) {
+					return std::unexpected("Missing ']' after the arguments of '" + invocation.name + "'");
+				}
+				rest = words[i];
+			}
+			append_items(rest.substr(0, rest.size() - 1), invocation.extras);
+			invocations.push_back(std::move(invocation));
+		}
+
+		return invocations;
+	}
+
+	std::expected<std::vector<const Command*>, std::string> plan_all(const xxlib::CommandRegistry& registry, const std::vector<Invocation>& invocations) {
+		std::vector<const Command*> planned;
+		planned.reserve(invocations.size());
+
+		for (const auto& invocation : invocations) {
+			// With several names, a word that names no alias is more likely a positional argument written the old way
+			// than an abbreviation, and resolving it could run an unrelated alias.
+			if (invocations.size() > 1 && registry.candidates(invocation.name).empty()) {
+				auto error = "No command is named '" + invocation.name + "'. When running several commands, name each one exactly and pass positional arguments after --";
+				auto similar = registry.names_with_prefix(invocation.name);
+				if (similar.empty()) {
+					similar = registry.suggestions(invocation.name);
+				}
+				if (!similar.empty()) {
+					error += "; did you mean: " + join_names(similar) + "?";
+				}
+				return std::unexpected(error);
+			}
+
+			auto command = plan_single(registry, invocation.name);
+			if (!command) {
+				return std::unexpected(command.error());
+			}
+			planned.push_back(*command);
+		}
+
+		return planned;
+	}
+
+	std::expected<std::vector<Step>, std::string> plan_graph(const xxlib::CommandRegistry& registry, const std::vector<Invocation>& invocations) {
+		const auto requested = plan_all(registry, invocations);
+		if (!requested) {
+			return std::unexpected(requested.error());
+		}
+
+		// A dependency that is also named on the command line runs with the extras it was named with first.
+		std::unordered_map<const Command*, const std::vector<std::string>*> requestedExtras;
+		for (size_t i = 0; i < invocations.size(); ++i) {
+			requestedExtras.emplace((*requested)[i], &invocations[i].extras);
+		}
+
+		auto builder = GraphBuilder(registry, std::move(requestedExtras));
+		for (size_t i = 0; i < invocations.size(); ++i) {
+			const auto index = builder.visit((*requested)[i]);
+			if (!index) {
+				return std::unexpected(index.error());
+			}
+
+			auto& steps = builder.steps;
+			const auto sameRun = std::any_of(steps.begin(), steps.end(), [&](const Step& step) {
+				return step.command == (*requested)[i] && step.extras == invocations[i].extras;
+			});
+			if (!sameRun) {
+				steps.push_back(Step{.command = (*requested)[i], .extras = invocations[i].extras, .dependsOn = steps[*index].dependsOn});
+			}
+		}
+
+		return std::move(builder.steps);
+	}
 } // namespace xxlib::planner
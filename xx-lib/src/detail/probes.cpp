@@ -0,0 +1,177 @@
+#include "detail/probes.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace xxlib::probes {
+	namespace {
+#if _WIN32
+		constexpr char PATH_SEPARATOR = ';';
+#else
+		constexpr char PATH_SEPARATOR = ':';
+#endif
+
+		struct Memo {
+			std::mutex mutex{};
+			std::unordered_map<std::string, std::optional<std::string>> envs{};
+			std::unordered_map<std::string, bool> paths{};
+			std::unordered_map<std::string, bool> binaries{};
+			std::optional<std::vector<std::filesystem::path>> pathDirectories{};
+			size_t resolved = 0;
+		};
+
+		Memo& memo() {
+			static Memo instance;
+			return instance;
+		}
+
+		std::optional<std::string> read_env(const std::string& name) {
+			const auto* value = std::getenv(name.c_str());
+			if (!value) {
+				return std::nullopt;
+			}
+			return std::string(value);
+		}
+
+		std::vector<std::filesystem::path> split_path() {
+			std::vector<std::filesystem::path> directories;
+
+			const auto path = read_env("PATH").value_or("");
+			size_t start = 0;
+			while (start <= path.size()) {
+				auto end = path.find(PATH_SEPARATOR, start);
+				if (end == std::string::npos) {
+					end = path.size();
+				}
+				// An empty entry stands for the current directory.
+				directories.emplace_back(end == start ? std::string(".") : path.substr(start, end - start));
+				start = end + 1;
+			}
+
+			return directories;
+		}
+
+		bool is_executable(const std::filesystem::path& path) {
+			std::error_code ec;
+			const auto status = std::filesystem::status(path, ec);
+			if (ec || !std::filesystem::is_regular_file(status)) {
+				return false;
+			}
+#if _WIN32
+			return true;
+#else
+			using std::filesystem::perms;
+			return (status.permissions() & (perms::owner_exec | perms::group_exec | perms::others_exec)) != perms::none;
+#endif
+		}
+
+		bool resolve_binary(const std::string& binary, const std::vector<std::filesystem::path>& directories) {
+#if _WIN32
+			std::vector<std::string> extensions{""};
+			const auto pathExt = read_env("PATHEXT").value_or(".COM;.EXE;.BAT;.CMD");
+			size_t start = 0;
+			while (start < pathExt.size()) {
+				auto end = pathExt.find(';', start);
+				if (end == std::string::npos) {
+					end = pathExt.size();
+				}
+				if (end > start) {
+					extensions.emplace_back(pathExt.substr(start, end - start));
+				}
+				start = end + 1;
+			}
+#else
+			const std::vector<std::string> extensions{""};
+#endif
+
+			const auto candidates = [&](const std::filesystem::path& base) {
+				for (const auto& extension : extensions) {
+					if (is_executable(base.string() + extension)) {
+						return true;
+					}
+				}
+				return false;
+			};
+
+			if (binary.find('/') != std::string::npos || binary.find(std::filesystem::path::preferred_separator) != std::string::npos) {
+				return candidates(binary);
+			}
+
+			for (const auto& directory : directories) {
+				if (candidates(directory / binary)) {
+					return true;
+				}
+			}
+			return false;
+		}
+	} // namespace
+
+	std::optional<std::string> env(std::string_view name) {
+		auto& state = memo();
+		std::lock_guard lock(state.mutex);
+
+		auto key = std::string(name);
+		if (const auto it = state.envs.find(key); it != state.envs.end()) {
+			return it->second;
+		}
+
+		++state.resolved;
+		auto value = read_env(key);
+		state.envs.emplace(std::move(key), value);
+		return value;
+	}
+
+	bool exists(std::string_view path) {
+		auto& state = memo();
+		std::lock_guard lock(state.mutex);
+
+		auto key = std::string(path);
+		if (const auto it = state.paths.find(key); it != state.paths.end()) {
+			return it->second;
+		}
+
+		++state.resolved;
+		std::error_code ec;
+		const auto found = std::filesystem::exists(std::filesystem::path(key), ec);
+		state.paths.emplace(std::move(key), found);
+		return found;
+	}
+
+	bool which(std::string_view binary) {
+		auto& state = memo();
+		std::lock_guard lock(state.mutex);
+
+		auto key = std::string(binary);
+		if (const auto it = state.binaries.find(key); it != state.binaries.end()) {
+			return it->second;
+		}
+
+		if (!state.pathDirectories) {
+			state.pathDirectories = split_path();
+		}
+
+		++state.resolved;
+		const auto found = resolve_binary(key, *state.pathDirectories);
+		state.binaries.emplace(std::move(key), found);
+		return found;
+	}
+
+	size_t resolved_count() {
+		auto& state = memo();
+		std::lock_guard lock(state.mutex);
+		return state.resolved;
+	}
+
+	void clear() {
+		auto& state = memo();
+		std::lock_guard lock(state.mutex);
+		state.envs.clear();
+		state.paths.clear();
+		state.binaries.clear();
+		state.pathDirectories.reset();
+		state.resolved = 0;
+	}
+} // namespace xxlib::probes
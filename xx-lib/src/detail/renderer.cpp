@@ -14,7 +14,16 @@ namespace xxlib::renderer {
 		}
 	}
 
-	std::string render(const std::string& templateStr, const std::unordered_map<std::string, std::string>& templateVars, Engine renderEngine) {
+	std::string render_engine_to_string(Engine renderEngine) {
+		switch (renderEngine) {
+		case Engine::Inja:
+			return "inja";
+		default:
+			return "none";
+		}
+	}
+
+	std::string render(const std::string& templateStr, const xxlib::StringMap& templateVars, Engine renderEngine) {
 		if (renderEngine == Engine::Inja) {
 			return xxlib::inja_renderer::render(templateStr, templateVars);
 		} else {
@@ -4,7 +4,7 @@
 #include <string>
 
 namespace xxlib::inja_renderer {
-	std::string render(const std::string& templateStr, const std::unordered_map<std::string, std::string>& templateVars) {
+	std::string render(const std::string& templateStr, const xxlib::StringMap& templateVars) {
 		inja::json data;
 
 		for (const auto& [key, value] : templateVars) {
@@ -0,0 +1,252 @@
+#include "detail/search_index.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <regex>
+
+namespace xxlib {
+	namespace {
+		constexpr std::array<std::pair<std::string_view, SearchIndex::Field>, 4> FIELD_PREFIXES{{
+			{"name:", SearchIndex::Name},
+			{"cmd:", SearchIndex::Cmd},
+			{"env:", SearchIndex::Env},
+			{"var:", SearchIndex::TemplateVars},
+		}};
+
+		std::string to_lower(std::string_view text) {
+			std::string lower(text);
+			std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) {
+				return static_cast<char>(std::tolower(c));
+			});
+			return lower;
+		}
+
+		uint32_t trigram_key(uint8_t field, std::string_view text, size_t position) {
+			return (static_cast<uint32_t>(field) << 24) | (static_cast<uint32_t>(static_cast<unsigned char>(text[position])) << 16) | (static_cast<uint32_t>(static_cast<unsigned char>(text[position + 1])) << 8) | static_cast<uint32_t>(static_cast<unsigned char>(text[position + 2]));
+		}
+
+		void append_value(std::string& field, std::string_view value) {
+			if (!field.empty()) {
+				field += '\n';
+			}
+			field += value;
+		}
+
+		std::vector<uint32_t> intersect(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+			std::vector<uint32_t> result;
+			std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+			return result;
+		}
+
+		std::vector<uint32_t> unite(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+			std::vector<uint32_t> result;
+			std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+			return result;
+		}
+	} // namespace
+
+	SearchIndex::SearchIndex(const std::vector<Command>& commands) {
+		texts.resize(commands.size());
+		lowerTexts.resize(commands.size());
+
+		for (size_t i = 0; i < commands.size(); ++i) {
+			const auto& command = commands[i];
+			auto& fields = texts[i];
+
+			fields[Name] = command.name;
+			for (const auto& line : command.cmd) {
+				append_value(fields[Cmd], line);
+			}
+			for (const auto& [key, value] : command.envs) {
+				append_value(fields[Env], key + "=" + value);
+			}
+			for (const auto& [key, value] : command.templateVars) {
+				append_value(fields[TemplateVars], key + "=" + value);
+			}
+
+			const auto document = static_cast<uint32_t>(i);
+			for (uint8_t field = 0; field < FIELD_COUNT; ++field) {
+				auto& lower = lowerTexts[i][field];
+				lower = to_lower(fields[field]);
+
+				for (size_t position = 0; position + 3 <= lower.size(); ++position) {
+					auto& posting = postings[trigram_key(field, lower, position)];
+					if (posting.empty() || posting.back() != document) {
+						posting.push_back(document);
+					}
+				}
+			}
+		}
+	}
+
+	std::expected<std::vector<uint32_t>, std::string> SearchIndex::search(std::string_view query, const Options& options) const {
+		std::vector<uint32_t> matches;
+
+		if (options.regex) {
+			auto flags = std::regex::ECMAScript | std::regex::optimize;
+			if (options.ignoreCase) {
+				flags |= std::regex::icase;
+			}
+
+			std::regex pattern;
+			try {
+				pattern = std::regex(query.begin(), query.end(), flags);
+			} catch (const std::regex_error& e) {
+				return std::unexpected("Invalid regular expression '" + std::string(query) + "': " + e.what());
+			}
+
+			for (size_t i = 0; i < texts.size(); ++i) {
+				const auto found = std::any_of(texts[i].begin(), texts[i].end(), [&pattern](const std::string& text) {
+					return std::regex_search(text, pattern);
+				});
+				if (found) {
+					matches.push_back(static_cast<uint32_t>(i));
+				}
+			}
+			return matches;
+		}
+
+		auto terms = parse_query(query);
+		if (!terms) {
+			return std::unexpected(terms.error());
+		}
+
+		if (options.ignoreCase) {
+			for (auto& term : *terms) {
+				term.text = to_lower(term.text);
+			}
+		}
+
+		if (terms->empty()) {
+			matches.resize(texts.size());
+			for (size_t i = 0; i < matches.size(); ++i) {
+				matches[i] = static_cast<uint32_t>(i);
+			}
+			return matches;
+		}
+
+		// The term with the fewest candidates drives the verification.
+		std::vector<std::vector<uint32_t>> termCandidates;
+		termCandidates.reserve(terms->size());
+		for (const auto& term : *terms) {
+			termCandidates.push_back(candidates(term));
+		}
+		const auto narrowest = std::min_element(termCandidates.begin(), termCandidates.end(), [](const auto& a, const auto& b) {
+			return a.size() < b.size();
+		});
+
+		for (const auto document : *narrowest) {
+			const auto all = std::all_of(terms->begin(), terms->end(), [&](const Term& term) {
+				return term_matches(document, term, options.ignoreCase);
+			});
+			if (all) {
+				matches.push_back(document);
+			}
+		}
+		return matches;
+	}
+
+	std::expected<std::vector<SearchIndex::Term>, std::string> SearchIndex::parse_query(std::string_view query) {
+		std::vector<Term> terms;
+
+		size_t position = 0;
+		while (position < query.size()) {
+			if (std::isspace(static_cast<unsigned char>(query[position]))) {
+				++position;
+				continue;
+			}
+
+			Term term;
+			for (const auto& [prefix, field] : FIELD_PREFIXES) {
+				if (query.substr(position).starts_with(prefix)) {
+					term.field = field;
+					position += prefix.size();
+					break;
+				}
+			}
+
+			if (position < query.size() && query[position] == '"') {
+				const auto closing = query.find('"', position + 1);
+				if (closing == std::string_view::npos) {
+					return std::unexpected("Unterminated quote in search query: " + std::string(query));
+				}
+				term.text = std::string(query.substr(position + 1, closing - position - 1));
+				position = closing + 1;
+			} else {
+				const auto start = position;
+				while (position < query.size() && !std::isspace(static_cast<unsigned char>(query[position]))) {
+					++position;
+				}
+				term.text = std::string(query.substr(start, position - start));
+			}
+
+			if (!term.text.empty()) {
+				terms.push_back(std::move(term));
+			}
+		}
+
+		return terms;
+	}
+
+	std::vector<uint32_t> SearchIndex::candidates(const Term& term) const {
+		const auto lower = to_lower(term.text);
+
+		std::vector<uint32_t> result;
+		for (uint8_t field = 0; field < FIELD_COUNT; ++field) {
+			if (term.field != FIELD_COUNT && term.field != field) {
+				continue;
+			}
+
+			// Terms shorter than a trigram cannot be narrowed down.
+			if (lower.size() < 3) {
+				result.resize(texts.size());
+				for (size_t i = 0; i < result.size(); ++i) {
+					result[i] = static_cast<uint32_t>(i);
+				}
+				return result;
+			}
+
+			// Intersecting from the shortest posting list keeps the intermediate results small.
+			std::vector<const std::vector<uint32_t>*> lists;
+			for (size_t position = 0; position + 3 <= lower.size(); ++position) {
+				const auto it = postings.find(trigram_key(field, lower, position));
+				if (it == postings.end()) {
+					lists.clear();
+					break;
+				}
+				lists.push_back(&it->second);
+			}
+			if (lists.empty()) {
+				continue;
+			}
+			std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) {
+				return a->size() < b->size();
+			});
+
+			auto fieldResult = *lists.front();
+			for (size_t i = 1; i < lists.size() && !fieldResult.empty(); ++i) {
+				if (lists[i] != lists[i - 1]) {
+					fieldResult = intersect(fieldResult, *lists[i]);
+				}
+			}
+
+			result = unite(result, fieldResult);
+		}
+
+		return result;
+	}
+
+	bool SearchIndex::term_matches(uint32_t document, const Term& term, bool ignoreCase) const {
+		const auto& fields = ignoreCase ? lowerTexts[document] : texts[document];
+
+		for (uint8_t field = 0; field < FIELD_COUNT; ++field) {
+			if (term.field != FIELD_COUNT && term.field != field) {
+				continue;
+			}
+			if (fields[field].find(term.text) != std::string::npos) {
+				return true;
+			}
+		}
+		return false;
+	}
+} // namespace xxlib
@@ -0,0 +1,253 @@
+#include "detail/serializer.hpp"
+
+namespace xxlib::serializer {
+	void Writer::u8(uint8_t value) {
+		buffer.push_back(static_cast<char>(value));
+	}
+
+	void Writer::u32(uint32_t value) {
+		for (auto i = 0; i < 4; ++i) {
+			buffer.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+		}
+	}
+
+	void Writer::u64(uint64_t value) {
+		for (auto i = 0; i < 8; ++i) {
+			buffer.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+		}
+	}
+
+	void Writer::i64(int64_t value) {
+		u64(static_cast<uint64_t>(value));
+	}
+
+	void Writer::str(std::string_view value) {
+		u32(static_cast<uint32_t>(value.size()));
+		buffer.append(value);
+	}
+
+	uint8_t Reader::u8() {
+		if (!ok || remaining() < 1) {
+			ok = false;
+			return 0;
+		}
+		return static_cast<uint8_t>(data[offset++]);
+	}
+
+	uint32_t Reader::u32() {
+		if (!ok || remaining() < 4) {
+			ok = false;
+			return 0;
+		}
+
+		uint32_t value = 0;
+		for (auto i = 0; i < 4; ++i) {
+			value |= static_cast<uint32_t>(static_cast<uint8_t>(data[offset++])) << (i * 8);
+		}
+		return value;
+	}
+
+	uint64_t Reader::u64() {
+		if (!ok || remaining() < 8) {
+			ok = false;
+			return 0;
+		}
+
+		uint64_t value = 0;
+		for (auto i = 0; i < 8; ++i) {
+			value |= static_cast<uint64_t>(static_cast<uint8_t>(data[offset++])) << (i * 8);
+		}
+		return value;
+	}
+
+	int64_t Reader::i64() {
+		return static_cast<int64_t>(u64());
+	}
+
+	std::string_view Reader::str_view() {
+		const auto size = u32();
+		if (!ok || remaining() < size) {
+			ok = false;
+			return {};
+		}
+
+		const auto view = data.substr(offset, size);
+		offset += size;
+		return view;
+	}
+
+	std::string Reader::str() {
+		return std::string(str_view());
+	}
+
+	size_t Reader::remaining() const {
+		return data.size() - offset;
+	}
+
+	void write_command(Writer& writer, const Command& command) {
+		writer.str(command.name);
+
+		writer.u32(static_cast<uint32_t>(command.cmd.size()));
+		for (const auto& part : command.cmd) {
+			writer.str(part);
+		}
+
+		writer.u32(static_cast<uint32_t>(command.templateVars.size()));
+		for (const auto& [key, value] : command.templateVars) {
+			writer.str(key);
+			writer.str(value);
+		}
+
+		writer.u32(static_cast<uint32_t>(command.envs.size()));
+		for (const auto& [key, value] : command.envs) {
+			writer.str(key);
+			writer.str(value);
+		}
+
+		writer.u32(static_cast<uint32_t>(command.constraints.size()));
+		for (const auto& [key, value] : command.constraints) {
+			writer.str(key);
+			writer.str(value);
+		}
+		writer.u32(command.constraintMask);
+
+		writer.u32(static_cast<uint32_t>(command.dependsOn.size()));
+		for (const auto& dependency : command.dependsOn) {
+			writer.str(dependency);
+		}
+		writer.u32(static_cast<uint32_t>(command.inputs.size()));
+		for (const auto& input : command.inputs) {
+			writer.str(input);
+		}
+		writer.u32(static_cast<uint32_t>(command.outputs.size()));
+		for (const auto& output : command.outputs) {
+			writer.str(output);
+		}
+		writer.u32(static_cast<uint32_t>(command.cacheEnv.size()));
+		for (const auto& variable : command.cacheEnv) {
+			writer.str(variable);
+		}
+
+		writer.u8(static_cast<uint8_t>(command.renderEngine));
+		writer.u8(static_cast<uint8_t>(command.executionEngine));
+		writer.u8(command.requiresConfirmation ? 1 : 0);
+		writer.u8(command.cacheResults ? 1 : 0);
+		writer.u8(command.userScope ? 1 : 0);
+	}
+
+	bool read_command(Reader& reader, Command& command) {
+		command.name = reader.str();
+
+		// Every element takes at least four bytes, which bounds the counts of a corrupted entry.
+		const auto cmdCount = reader.u32();
+		if (cmdCount > reader.remaining() / 4) {
+			return false;
+		}
+		command.cmd.reserve(cmdCount);
+		for (uint32_t i = 0; i < cmdCount && reader.ok; ++i) {
+			command.cmd.emplace_back(reader.str());
+		}
+
+		const auto templateVarsCount = reader.u32();
+		if (templateVarsCount > reader.remaining() / 8) {
+			return false;
+		}
+		command.templateVars.reserve(templateVarsCount);
+		for (uint32_t i = 0; i < templateVarsCount && reader.ok; ++i) {
+			auto key = reader.str();
+			command.templateVars.emplace(std::move(key), reader.str());
+		}
+
+		const auto envsCount = reader.u32();
+		if (envsCount > reader.remaining() / 8) {
+			return false;
+		}
+		command.envs.reserve(envsCount);
+		for (uint32_t i = 0; i < envsCount && reader.ok; ++i) {
+			auto key = reader.str();
+			command.envs.emplace(std::move(key), reader.str());
+		}
+
+		const auto constraintsCount = reader.u32();
+		if (constraintsCount > reader.remaining() / 8) {
+			return false;
+		}
+		command.constraints.reserve(constraintsCount);
+		for (uint32_t i = 0; i < constraintsCount && reader.ok; ++i) {
+			auto key = reader.str();
+			command.constraints.emplace_back(std::move(key), reader.str());
+		}
+		command.constraintMask = reader.u32();
+
+		const auto dependsOnCount = reader.u32();
+		if (dependsOnCount > reader.remaining() / 4) {
+			return false;
+		}
+		command.dependsOn.reserve(dependsOnCount);
+		for (uint32_t i = 0; i < dependsOnCount && reader.ok; ++i) {
+			command.dependsOn.emplace_back(reader.str());
+		}
+
+		const auto inputCount = reader.u32();
+		if (inputCount > reader.remaining() / 4) {
+			return false;
+		}
+		command.inputs.reserve(inputCount);
+		for (uint32_t i = 0; i < inputCount && reader.ok; ++i) {
+			command.inputs.emplace_back(reader.str());
+		}
+
+		const auto outputCount = reader.u32();
+		if (outputCount > reader.remaining() / 4) {
+			return false;
+		}
+		command.outputs.reserve(outputCount);
+		for (uint32_t i = 0; i < outputCount && reader.ok; ++i) {
+			command.outputs.emplace_back(reader.str());
+		}
+
+		const auto cacheEnvCount = reader.u32();
+		if (cacheEnvCount > reader.remaining() / 4) {
+			return false;
+		}
+		command.cacheEnv.reserve(cacheEnvCount);
+		for (uint32_t i = 0; i < cacheEnvCount && reader.ok; ++i) {
+			command.cacheEnv.emplace_back(reader.str());
+		}
+
+		command.renderEngine = static_cast<xxlib::renderer::Engine>(reader.u8());
+		command.executionEngine = static_cast<xxlib::executor::Engine>(reader.u8());
+		command.requiresConfirmation = reader.u8() != 0;
+		command.cacheResults = reader.u8() != 0;
+		command.userScope = reader.u8() != 0;
+
+		return reader.ok;
+	}
+
+	void write_commands(Writer& writer, const std::vector<Command>& commands) {
+		writer.u32(static_cast<uint32_t>(commands.size()));
+		for (const auto& command : commands) {
+			write_command(writer, command);
+		}
+	}
+
+	std::expected<std::vector<Command>, std::string> read_commands(Reader& reader) {
+		const auto count = reader.u32();
+		if (!reader.ok || count > reader.remaining()) {
+			return std::unexpected("Invalid command count");
+		}
+
+		std::vector<Command> commands;
+		commands.reserve(count);
+
+		for (uint32_t i = 0; i < count; ++i) {
+			Command command;
+			if (!read_command(reader, command)) {
+				return std::unexpected("Truncated or corrupted command data");
+			}
+			commands.emplace_back(std::move(command));
+		}
+
+		return commands;
+	}
+} // namespace xxlib::serializer
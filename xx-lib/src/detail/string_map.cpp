@@ -0,0 +1,65 @@
+#include "detail/string_map.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace xxlib {
+	namespace {
+		template <typename Iterator>
+		Iterator find_position(Iterator begin, Iterator end, std::string_view key) {
+			return std::lower_bound(begin, end, key, [](const StringMap::value_type& entry, std::string_view value) {
+				return entry.first < value;
+			});
+		}
+	} // namespace
+
+	StringMap::StringMap(std::initializer_list<value_type> entries) {
+		this->entries.reserve(entries.size());
+		for (const auto& [key, value] : entries) {
+			emplace(key, value);
+		}
+	}
+
+	StringMap::iterator StringMap::find(std::string_view key) {
+		const auto it = find_position(entries.begin(), entries.end(), key);
+		return it != entries.end() && it->first == key ? it : entries.end();
+	}
+
+	StringMap::const_iterator StringMap::find(std::string_view key) const {
+		const auto it = find_position(entries.begin(), entries.end(), key);
+		return it != entries.end() && it->first == key ? it : entries.end();
+	}
+
+	bool StringMap::contains(std::string_view key) const {
+		return find(key) != entries.end();
+	}
+
+	const std::string& StringMap::at(std::string_view key) const {
+		const auto it = find(key);
+		if (it == entries.end()) {
+			throw std::out_of_range("StringMap::at: key not found: " + std::string(key));
+		}
+		return it->second;
+	}
+
+	std::string& StringMap::operator[](std::string_view key) {
+		if (const auto it = find(key); it != entries.end()) {
+			return it->second;
+		}
+		return emplace(std::string(key), std::string()).first->second;
+	}
+
+	std::pair<StringMap::iterator, bool> StringMap::emplace(std::string key, std::string value) {
+		// Entries usually arrive already sorted (serialized commands), which makes this an append.
+		if (entries.empty() || entries.back().first < key) {
+			entries.emplace_back(std::move(key), std::move(value));
+			return {std::prev(entries.end()), true};
+		}
+
+		const auto it = find_position(entries.begin(), entries.end(), key);
+		if (it != entries.end() && it->first == key) {
+			return {it, false};
+		}
+		return {entries.emplace(it, std::move(key), std::move(value)), true};
+	}
+} // namespace xxlib
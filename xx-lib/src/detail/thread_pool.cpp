@@ -0,0 +1,198 @@
+#include "detail/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace xxlib {
+	ThreadPool::ThreadPool(size_t threadCount) {
+		if (threadCount == 0) {
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+		}
+
+		workers.reserve(threadCount);
+		for (size_t i = 0; i < threadCount; ++i) {
+			workers.emplace_back([this]() {
+				worker_loop();
+			});
+		}
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard lock(mutex);
+			stopping = true;
+		}
+		condition.notify_all();
+
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+
+	size_t ThreadPool::size() const {
+		return workers.size();
+	}
+
+	void ThreadPool::enqueue(std::function<void()> job) {
+		{
+			std::lock_guard lock(mutex);
+			jobs.emplace_back(std::move(job));
+		}
+		condition.notify_one();
+	}
+
+	void ThreadPool::worker_loop() {
+		while (true) {
+			std::function<void()> job;
+			{
+				std::unique_lock lock(mutex);
+				condition.wait(lock, [this]() {
+					return stopping || !jobs.empty();
+				});
+
+				if (jobs.empty()) {
+					return;
+				}
+
+				job = std::move(jobs.front());
+				jobs.pop_front();
+			}
+
+			job();
+		}
+	}
+
+	namespace {
+		// The pool and queue index of the worker running on this thread, if any.
+		thread_local const WorkStealingPool* currentPool = nullptr;
+		thread_local size_t currentQueue = 0;
+	} // namespace
+
+	void parallel_ranges(size_t count, size_t minChunk, const std::function<void(size_t, size_t)>& body) {
+		if (count < 2 * minChunk) {
+			body(0, count);
+			return;
+		}
+
+		ThreadPool pool;
+		const auto chunk = std::max(minChunk, count / (pool.size() * 4) + 1);
+		std::vector<std::future<void>> pending;
+		for (size_t begin = 0; begin < count; begin += chunk) {
+			pending.push_back(pool.submit([&body, begin, end = std::min(begin + chunk, count)]() {
+				body(begin, end);
+			}));
+		}
+		for (auto& future : pending) {
+			future.get();
+		}
+	}
+
+	WorkStealingPool::WorkStealingPool(size_t threadCount) {
+		if (threadCount == 0) {
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+		}
+
+		queues.reserve(threadCount);
+		for (size_t i = 0; i < threadCount; ++i) {
+			queues.push_back(std::make_unique<Queue>());
+		}
+
+		workers.reserve(threadCount);
+		for (size_t i = 0; i < threadCount; ++i) {
+			workers.emplace_back([this, i]() {
+				worker_loop(i);
+			});
+		}
+	}
+
+	WorkStealingPool::~WorkStealingPool() {
+		{
+			std::lock_guard lock(mutex);
+			stopping = true;
+		}
+		condition.notify_all();
+
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+
+	size_t WorkStealingPool::size() const {
+		return workers.size();
+	}
+
+	void WorkStealingPool::submit(std::function<void()> job) {
+		// Counted before it is queued, so queued never drops below the number of jobs in the queues.
+		{
+			std::lock_guard lock(mutex);
+			++queued;
+		}
+
+		// Jobs from outside the pool go to the far end, so a worker takes them in the order they were submitted.
+		const auto internal = currentPool == this;
+		const auto target = internal ? currentQueue : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+		{
+			std::lock_guard lock(queues[target]->mutex);
+			if (internal) {
+				queues[target]->jobs.push_back(std::move(job));
+			} else {
+				queues[target]->jobs.push_front(std::move(job));
+			}
+		}
+		condition.notify_one();
+	}
+
+	bool WorkStealingPool::try_take(size_t self, std::function<void()>& job) {
+		{
+			auto& own = *queues[self];
+			std::lock_guard lock(own.mutex);
+			if (!own.jobs.empty()) {
+				job = std::move(own.jobs.back());
+				own.jobs.pop_back();
+				return true;
+			}
+		}
+
+		for (size_t offset = 1; offset < queues.size(); ++offset) {
+			auto& victim = *queues[(self + offset) % queues.size()];
+			std::lock_guard lock(victim.mutex);
+			if (!victim.jobs.empty()) {
+				job = std::move(victim.jobs.front());
+				victim.jobs.pop_front();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void WorkStealingPool::worker_loop(size_t self) {
+		currentPool = this;
+		currentQueue = self;
+
+		while (true) {
+			std::function<void()> job;
+			if (try_take(self, job)) {
+				{
+					std::lock_guard lock(mutex);
+					--queued;
+					++running;
+				}
+				job();
+
+				std::lock_guard lock(mutex);
+				if (--running == 0 && stopping && queued == 0) {
+					condition.notify_all();
+				}
+				continue;
+			}
+
+			std::unique_lock lock(mutex);
+			condition.wait(lock, [this]() {
+				return queued > 0 || (stopping && running == 0);
+			});
+			if (stopping && queued == 0 && running == 0) {
+				return;
+			}
+		}
+	}
+} // namespace xxlib
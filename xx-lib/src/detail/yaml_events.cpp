@@ -0,0 +1,175 @@
+#include "detail/yaml_events.hpp"
+
+#include <unordered_map>
+#include <yaml-cpp/eventhandler.h>
+#include <yaml-cpp/yaml.h>
+
+namespace xxlib::yaml_events {
+	namespace {
+		struct Frame {
+			Node node{};
+			YAML::anchor_t anchor = YAML::NullAnchor;
+			// Maps receive keys and values as consecutive events; the key waits here for its value.
+			std::optional<Node> key{};
+		};
+
+		class Builder : public YAML::EventHandler {
+		  public:
+			explicit Builder(std::optional<std::string_view> onlyAlias) : onlyAlias(onlyAlias) {
+			}
+
+			void OnDocumentStart(const YAML::Mark&) override {
+			}
+
+			void OnDocumentEnd() override {
+			}
+
+			void OnNull(const YAML::Mark&, YAML::anchor_t anchor) override {
+				if (skipping) {
+					skip_leaf();
+					return;
+				}
+				add(Node{}, anchor);
+			}
+
+			void OnAlias(const YAML::Mark&, YAML::anchor_t anchor) override {
+				if (skipping) {
+					skip_leaf();
+					return;
+				}
+
+				const auto it = anchors.find(anchor);
+				if (it == anchors.end()) {
+					unresolved = true;
+					add(Node{}, YAML::NullAnchor);
+					return;
+				}
+				add(Node(it->second), YAML::NullAnchor);
+			}
+
+			void OnScalar(const YAML::Mark&, const std::string&, YAML::anchor_t anchor, const std::string& value) override {
+				if (skipping) {
+					skip_leaf();
+					return;
+				}
+				add(Node{.kind = Node::Kind::Scalar, .scalar = value}, anchor);
+			}
+
+			void OnSequenceStart(const YAML::Mark&, const std::string&, YAML::anchor_t anchor, YAML::EmitterStyle::value) override {
+				if (skipping) {
+					++skipDepth;
+					return;
+				}
+				stack.push_back(Frame{.node = Node{.kind = Node::Kind::Sequence}, .anchor = anchor});
+			}
+
+			void OnSequenceEnd() override {
+				if (skipping) {
+					skip_end();
+					return;
+				}
+				close();
+			}
+
+			void OnMapStart(const YAML::Mark&, const std::string&, YAML::anchor_t anchor, YAML::EmitterStyle::value) override {
+				if (skipping) {
+					++skipDepth;
+					return;
+				}
+				stack.push_back(Frame{.node = Node{.kind = Node::Kind::Map}, .anchor = anchor});
+			}
+
+			void OnMapEnd() override {
+				if (skipping) {
+					skip_end();
+					return;
+				}
+				close();
+			}
+
+			Node root{};
+			bool unresolved = false;
+
+		  private:
+			void add(Node node, YAML::anchor_t anchor) {
+				if (anchor != YAML::NullAnchor) {
+					anchors[anchor] = node;
+				}
+
+				if (stack.empty()) {
+					root = std::move(node);
+					return;
+				}
+
+				auto& top = stack.back();
+				if (top.node.kind == Node::Kind::Sequence) {
+					top.node.items.emplace_back(std::move(node));
+					return;
+				}
+
+				if (!top.key) {
+					top.key = std::move(node);
+					skipping = skips_value();
+					skipDepth = 0;
+					return;
+				}
+
+				top.node.entries.emplace_back(std::move(*top.key), std::move(node));
+				top.key.reset();
+			}
+
+			void close() {
+				auto frame = std::move(stack.back());
+				stack.pop_back();
+				add(std::move(frame.node), frame.anchor);
+			}
+
+			// True when the key just read names an entry of the root 'alias' map other than onlyAlias.
+			bool skips_value() const {
+				if (!onlyAlias || stack.size() != 2 || stack[1].node.kind != Node::Kind::Map) {
+					return false;
+				}
+
+				const auto& sectionKey = stack[0].key;
+				const auto& aliasKey = stack[1].key;
+				return sectionKey && sectionKey->kind == Node::Kind::Scalar && sectionKey->scalar == "alias" &&
+					aliasKey->kind == Node::Kind::Scalar && aliasKey->scalar != *onlyAlias;
+			}
+
+			void skip_leaf() {
+				if (skipDepth == 0) {
+					finish_skip();
+				}
+			}
+
+			void skip_end() {
+				if (--skipDepth == 0) {
+					finish_skip();
+				}
+			}
+
+			void finish_skip() {
+				skipping = false;
+				stack.back().key.reset();
+			}
+
+			std::optional<std::string_view> onlyAlias;
+			std::vector<Frame> stack{};
+			std::unordered_map<YAML::anchor_t, Node> anchors{};
+			bool skipping = false;
+			size_t skipDepth = 0;
+		};
+	} // namespace
+
+	std::optional<Node> load(std::istream& stream, std::optional<std::string_view> onlyAlias) {
+		Builder builder(onlyAlias);
+
+		YAML::Parser parser(stream);
+		parser.HandleNextDocument(builder);
+
+		if (builder.unresolved) {
+			return std::nullopt;
+		}
+		return std::move(builder.root);
+	}
+} // namespace xxlib::yaml_events
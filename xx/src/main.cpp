@@ -1,10 +1,13 @@
 #include "xxlib.hpp"
 
+#include <algorithm>
 #include <cstdio>
 #include <filesystem>
-#include <sstream>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <optional>
+#include <unordered_set>
 #include <CLI/CLI.hpp>
 #include <spdlog/spdlog.h>
 #include <cpr/cpr.h>
@@ -14,107 +17,162 @@ struct GlobalArgs {
 	std::string configFile;
 	std::string userConfigFile;
 	bool upFlag = false;
+	bool upAllFlag = false;
 	bool verboseFlag = false;
 	bool userConfigOnlyFlag = false;
 	bool projectOnlyFlag = false;
+	bool noCacheFlag = false;
+	size_t maxConfigSize = 0;
+	std::string yamlParser;
 };
 
 namespace {
-	std::optional<std::string> find_config(const std::string& startPath, const std::string_view configFile, bool upFlag) {
-		if (upFlag) {
-			std::filesystem::path currentPath = startPath;
+	// Project configuration files that apply to startPath, closest first.
+	std::vector<std::string> find_configs(const std::string& startPath, const GlobalArgs& globalArgs) {
+		if (globalArgs.configFile == "-") {
+			return {globalArgs.configFile};
+		}
 
-			std::string configFileName{configFile};
-			if (const auto path = std::filesystem::path(configFile); path.has_parent_path()) {
-				configFileName = path.filename().string();
+		if (globalArgs.upFlag || globalArgs.upAllFlag) {
+			const auto firstOnly = !globalArgs.upAllFlag;
+			if (globalArgs.noCacheFlag) {
+				return xxlib::discovery::find_configs(startPath, globalArgs.configFile, firstOnly).configs;
 			}
+			return xxlib::discovery::find_configs_cached(startPath, globalArgs.configFile, firstOnly, xxlib::cache::default_directory());
+		}
 
-			try {
-				while (true) {
-					std::filesystem::path configPath = currentPath / configFile;
-					if (std::filesystem::exists(configPath)) {
-						return configPath.string();
-					}
-
-					if (currentPath.has_parent_path() && currentPath != currentPath.parent_path()) {
-						currentPath = currentPath.parent_path();
-					} else {
-						break;
-					}
-				}
-			} catch (const std::filesystem::filesystem_error& e) {
-				spdlog::error("Filesystem error while searching for config: {}", e.what());
-				return std::nullopt;
-			}
-		} else {
-			std::filesystem::path configPath = std::filesystem::path(startPath) / configFile;
-			if (std::filesystem::exists(configPath)) {
-				return configPath.string();
-			}
+		std::filesystem::path configPath = std::filesystem::path(startPath) / globalArgs.configFile;
+		if (std::filesystem::exists(configPath)) {
+			return {configPath.string()};
 		}
 
-		return std::nullopt;
+		return {};
 	}
 
-	void load_project_configuration(std::vector<Command>& commands, const std::string& configFile, const bool upFlag, const std::string& workdir) {
-		spdlog::debug("Loading configuration from workdir: {}", workdir);
+	std::vector<xxlib::loader::Source> find_sources(const GlobalArgs& globalArgs, const std::string& workdir) {
+		std::vector<xxlib::loader::Source> sources;
 
-		auto configPathOpt = find_config(workdir, configFile, upFlag);
-		if (configPathOpt) {
-			spdlog::debug("Configuration file found at: {}", *configPathOpt);
+		if (!globalArgs.userConfigOnlyFlag) {
+			spdlog::debug("Loading configuration from workdir: {}", workdir);
 
-			const auto buffer = xxlib::parser::read_file(*configPathOpt);
-			if (buffer) {
-				auto parseResult = xxlib::parser::parse_buffer(*buffer);
-				if (!parseResult) {
-					throw std::runtime_error("Error parsing configuration: " + parseResult.error());
-				}
+			const auto configPaths = find_configs(workdir, globalArgs);
+			for (size_t i = 0; i < configPaths.size(); ++i) {
+				spdlog::debug("Configuration file found at: {}", configPaths[i]);
+				sources.push_back({.path = configPaths[i], .userScope = false, .strict = true, .inherited = i > 0});
+			}
 
-				commands.insert(commands.end(), parseResult->begin(), parseResult->end());
-				spdlog::debug("Loaded {} project commands.", parseResult->size());
-			} else {
-				spdlog::debug("Error reading configuration file: {}", buffer.error());
+			if (configPaths.empty()) {
+				spdlog::debug("No configuration file found.");
 			}
-		} else {
-			spdlog::debug("No configuration file found.");
 		}
+
+		if (!globalArgs.projectOnlyFlag) {
+			sources.push_back({.path = globalArgs.userConfigFile, .userScope = true, .strict = false});
+		}
+
+		return sources;
 	}
 
-	void load_user_configuration(std::vector<Command>& commands, const std::string& userConfigFile) {
-		const auto userConfigFilePath = std::filesystem::path(userConfigFile);
-		const auto userBuffer = xxlib::parser::read_file(userConfigFilePath.string());
-		if (userBuffer) {
-			spdlog::debug("User configuration found: {}", userConfigFilePath.string());
-
-			auto userParseResult = xxlib::parser::parse_buffer(*userBuffer);
-			if (userParseResult) {
-				auto& userCommands = *userParseResult;
-				for (auto& cmd : userCommands) {
-					cmd.userScope = true;
-				}
+	// With a commandName only that alias has to be materialized; other commands may be omitted from the result.
+	std::vector<Command> load_commands(const GlobalArgs& globalArgs, const std::string& workdir, const std::optional<std::string>& commandName = std::nullopt) {
+		const auto sources = find_sources(globalArgs, workdir);
 
-				commands.insert(commands.end(), userCommands.begin(), userCommands.end());
-				spdlog::debug("Loaded {} user commands.", userCommands.size());
-			} else {
-				spdlog::debug("Error parsing user configuration: {}", userParseResult.error());
-			}
-		} else {
-			spdlog::debug("No user configuration file found at: {}", userConfigFilePath.string());
+		const auto options = xxlib::loader::Options{
+			.useCache = !globalArgs.noCacheFlag,
+			.maxFileSize = globalArgs.maxConfigSize,
+			.backend = xxlib::parser::string_to_backend(globalArgs.yamlParser),
+			.commandName = commandName,
+		};
+
+		auto commands = xxlib::loader::load_sources(sources, options);
+		if (!commands) {
+			throw std::runtime_error(commands.error());
 		}
-	}
 
-	std::vector<Command> load_commands(const GlobalArgs& globalArgs, const std::string& workdir) {
-		std::vector<Command> commands;
+		return std::move(*commands);
+	}
 
-		if (!globalArgs.userConfigOnlyFlag) {
-			load_project_configuration(commands, globalArgs.configFile, globalArgs.upFlag, workdir);
+	// How the planned aliases are run, shared by run and pick.
+	struct RunSettings {
+		bool dryRun = false;
+		bool yolo = false;
+		bool force = false;
+		bool hashInputs = false;
+		std::string remoteCacheUrl{};
+	};
+
+	// One job per planned step, with sharedExtras appended to the arguments of each.
+	std::vector<xxlib::parallel::Job> make_jobs(const std::vector<xxlib::planner::Step>& steps, const std::vector<std::string>& sharedExtras, const RunSettings& settings) {
+		std::shared_ptr<xxlib::action_cache::Backend> actionCache;
+		if (!settings.remoteCacheUrl.empty()) {
+			actionCache = std::make_shared<xxlib::action_cache::HttpBackend>(settings.remoteCacheUrl);
+		} else {
+			actionCache = std::make_shared<xxlib::action_cache::DiskBackend>((std::filesystem::path(xxlib::cache::default_directory()) / "actions").string());
 		}
 
-		if (!globalArgs.projectOnlyFlag) {
-			load_user_configuration(commands, globalArgs.userConfigFile);
+		std::vector<xxlib::parallel::Job> jobs;
+		for (const auto& step : steps) {
+			auto job = xxlib::parallel::Job{
+				.command = *step.command,
+				.context = CommandContext{
+					.dryRun = settings.dryRun,
+					.extras = step.extras,
+					.stateDirectory = (std::filesystem::path(xxlib::cache::default_directory()) / "state").string(),
+					.hashInputs = settings.hashInputs,
+					.force = settings.force,
+					.actionCache = actionCache,
+				},
+				.dependsOn = step.dependsOn,
+			};
+			job.context.extras.insert(job.context.extras.end(), sharedExtras.begin(), sharedExtras.end());
+
+			if (settings.yolo) {
+				job.command.requiresConfirmation = false;
+				spdlog::debug("yolo flag is set, requiresConfirmation will be ignored.");
+			}
+
+			jobs.push_back(std::move(job));
 		}
+		return jobs;
+	}
 
-		return commands;
+	// Runs the jobs one after another, skipping those whose dependencies failed. Returns the exit code of the first
+	// failure.
+	int32_t run_in_order(std::vector<xxlib::parallel::Job>& jobs, bool keepGoing) {
+		int32_t exitCode = 0;
+		std::vector<bool> succeeded(jobs.size(), false);
+		for (size_t i = 0; i < jobs.size(); ++i) {
+			auto& [commandToRun, execContext, dependsOn] = jobs[i];
+			const auto ready = std::all_of(dependsOn.begin(), dependsOn.end(), [&succeeded](size_t dependency) {
+				return succeeded[dependency];
+			});
+			if (!ready) {
+				spdlog::error("Skipping '{}' because a command it depends on failed", commandToRun.name);
+				continue;
+			}
+
+			auto execResult = xxlib::executor::execute_command(commandToRun, execContext);
+
+			if (!execResult) {
+				spdlog::error("Error executing command '{}': {}", commandToRun.name, execResult.error());
+			}
+
+			const auto code = execResult.value_or(-1);
+			if (code == 0) {
+				succeeded[i] = true;
+				continue;
+			}
+			if (exitCode == 0) {
+				exitCode = code;
+			}
+			if (!keepGoing) {
+				if (i + 1 < jobs.size()) {
+					spdlog::error("Command '{}' failed with exit code {}, skipping the remaining commands", commandToRun.name, code);
+				}
+				break;
+			}
+		}
+		return exitCode;
 	}
 } // namespace
 
@@ -122,7 +180,7 @@ int main(int argc, char** argv) {
 	CLI::App app{"xx – Per‑project alias & preset tool"};
 	GlobalArgs globalArgs{};
 
-	app.add_option("-c,--config", globalArgs.configFile, "Path to project configuration file")->default_val(".xx.yaml");
+	app.add_option("-c,--config", globalArgs.configFile, "Path to project configuration file, or - to read it from stdin")->default_val(".xx.yaml");
 	app.add_option("-u,--user-config", globalArgs.userConfigFile, "Path to user configuration file")
 #ifdef _WIN32
 		->default_val(std::getenv("APPDATA") + std::string("\\xx\\xx.yaml"));
@@ -132,9 +190,13 @@ int main(int argc, char** argv) {
 		static_assert(false, "Unsupported platform");
 #endif
 	app.add_flag("--up", globalArgs.upFlag, "Instead of using the current directory to locate the project configuration file, search parent directories");
+	app.add_flag("--up-all", globalArgs.upAllFlag, "Merge project configuration files from the current and all parent directories, closer ones overriding aliases of the same name");
 	app.add_flag("-v,--verbose", globalArgs.verboseFlag, "Enable verbose output");
 	app.add_flag("--user", globalArgs.userConfigOnlyFlag, "Load only user configuration, ignoring project configuration");
 	app.add_flag("--project", globalArgs.projectOnlyFlag, "Load only project configuration, ignoring user configuration");
+	app.add_flag("--no-cache", globalArgs.noCacheFlag, "Always parse configuration files, bypassing the precompiled configuration cache");
+	app.add_option("--max-config-size", globalArgs.maxConfigSize, "Maximum size of a configuration file in bytes, 0 for no limit")->default_val(0);
+	app.add_option("--yaml-parser", globalArgs.yamlParser, "YAML parser used for configuration files: events or dom")->default_val("events")->check(CLI::IsMember({"events", "dom"}));
 
 	app.parse_complete_callback([&]() {
 		if (globalArgs.verboseFlag) {
@@ -153,9 +215,15 @@ int main(int argc, char** argv) {
 		if (globalArgs.projectOnlyFlag && globalArgs.upFlag) {
 			spdlog::warn("The --up flag has no effect when --project flag is used.");
 		}
+
+		if (globalArgs.upFlag && globalArgs.upAllFlag) {
+			spdlog::warn("The --up flag has no effect when --up-all flag is used.");
+		}
 	});
 
 	const auto workdir = std::filesystem::current_path().string();
+	int32_t exitCode = -1;
+	std::vector<std::string> separatedExtras;
 
 	app.add_subcommand("version", "Show version information")->callback([&]() {
 		spdlog::info(xxlib::detailed_version_text());
@@ -208,93 +276,300 @@ int main(int argc, char** argv) {
 
 	auto* list = app.add_subcommand("list", "List all available commands");
 	std::string listGrep;
-	list->add_option("--grep", listGrep, "Filter commands by name containing the specified substring");
+	std::string listFormat;
+	bool listIgnoreCase = false;
+	bool listRegex = false;
+	list->add_option("--grep", listGrep, "Filter commands by terms that must all occur in the name, cmd, env or template_vars (prefix a term with name:, cmd:, env: or var: to search one field)");
+	list->add_flag("-i,--ignore-case", listIgnoreCase, "Match --grep case-insensitively");
+	list->add_flag("--regex", listRegex, "Treat --grep as a regular expression");
+	list->add_option("--format", listFormat, "Output format: text, json or ndjson")->default_val("text")->check(CLI::IsMember({"text", "json", "ndjson"}));
 	list->callback([&]() {
-		const auto user_tag = [](const Command& cmd) -> std::string {
-			return cmd.userScope ? "[User] " : "";
-		};
-
-		const auto commands = load_commands(globalArgs, workdir);
+		const auto registry = xxlib::CommandRegistry(load_commands(globalArgs, workdir));
+		const auto& commands = registry.commands();
+
+		std::vector<uint32_t> selected;
+		if (listGrep.empty()) {
+			selected.resize(commands.size());
+			for (size_t i = 0; i < selected.size(); ++i) {
+				selected[i] = static_cast<uint32_t>(i);
+			}
+		} else {
+			const auto index = xxlib::SearchIndex(commands);
+			auto found = index.search(listGrep, {.ignoreCase = listIgnoreCase, .regex = listRegex});
+			if (!found) {
+				spdlog::error("{}", found.error());
+				exitCode = 1;
+				return;
+			}
+			selected = std::move(*found);
+		}
 
-		std::vector<std::string> constraintSatisfiedCommands;
-		std::vector<std::string> constraintUnsatisfiedCommands;
-		for (const auto& cmd : commands) {
-			auto cmdText = xxlib::command::join_cmd(cmd);
+		auto writer = xxlib::listing::Writer(stdout, xxlib::listing::string_to_format(listFormat));
+		for (const auto i : selected) {
+			writer.add(commands[i], registry.satisfied(i));
+		}
+		writer.finish();
+	});
 
-			if (!listGrep.empty() && (cmd.name.find(listGrep) == std::string::npos && cmdText.find(listGrep) == std::string::npos)) {
-				continue;
-			}
+	app.add_subcommand("user-config-path", "Show the path to the user configuration file")->callback([&]() {
+		spdlog::info("{}", globalArgs.userConfigFile);
+	});
 
-			std::ostringstream fullText;
-			fullText << user_tag(cmd) << cmd.name << ": " << cmdText;
+	auto* completion = app.add_subcommand("completion", "Print a shell completion script for bash, zsh or fish");
+	std::string completionShell;
+	completion->add_option("shell", completionShell, "Shell to print the completion script for")->required()->check(CLI::IsMember({"bash", "zsh", "fish"}));
+	completion->callback([&]() {
+		const auto text = xxlib::completion::script(xxlib::completion::string_to_shell(completionShell));
+		std::fwrite(text.data(), 1, text.size(), stdout);
+	});
 
-			if (xxlib::planner::matches_constraints(cmd)) {
-				constraintSatisfiedCommands.push_back(fullText.str());
-			} else {
-				fullText << " [Constraints: " << xxlib::command::join_constraints(cmd) << "]";
-				constraintUnsatisfiedCommands.push_back(fullText.str());
-			}
+	// Called by the completion scripts with the words typed after 'run'. Answers from the name indices of the
+	// configuration cache when they are fresh, and prints nothing but candidates.
+	auto* complete = app.add_subcommand("__complete", "")->group("");
+	complete->prefix_command();
+	complete->callback([&]() {
+		if (!globalArgs.verboseFlag) {
+			spdlog::set_level(spdlog::level::off);
 		}
 
-		spdlog::info("Commands available for the current environment:");
-		for (const auto& str : constraintSatisfiedCommands) {
-			spdlog::info("-- {}", str);
+		const auto words = complete->remaining();
+
+		std::vector<std::string> paths;
+		for (const auto& source : find_sources(globalArgs, workdir)) {
+			paths.push_back(source.path);
 		}
 
-		if (!constraintUnsatisfiedCommands.empty()) {
-			spdlog::info("Commands not available for the current environment: (due to constraints)");
-			for (const auto& str : constraintUnsatisfiedCommands) {
-				spdlog::info("-- {}", str);
+		std::expected<std::vector<xxlib::completion::Entry>, std::string> entries = std::unexpected("The cache is disabled");
+		if (!globalArgs.noCacheFlag) {
+			entries = xxlib::completion::read_indexed(paths, xxlib::cache::default_directory());
+		}
+		if (!entries) {
+			spdlog::debug("Loading configuration for completion: {}", entries.error());
+			try {
+				entries = xxlib::completion::entries_of(load_commands(globalArgs, workdir));
+			} catch (const std::exception& e) {
+				spdlog::debug("Cannot complete: {}", e.what());
+				return;
 			}
 		}
-	});
 
-	app.add_subcommand("user-config-path", "Show the path to the user configuration file")->callback([&]() {
-		spdlog::info("{}", globalArgs.userConfigFile);
+		std::string output;
+		for (const auto& candidate : xxlib::completion::complete(*entries, words)) {
+			output += candidate;
+			output += '\n';
+		}
+		std::fwrite(output.data(), 1, output.size(), stdout);
 	});
 
-	int32_t exitCode = -1;
+	auto* compile = app.add_subcommand("compile", "Compile the configuration into a bundle that runs without parsing");
+	std::string compileOutput;
+	compile->add_option("-o,--output", compileOutput, "Path of the bundle to write")->required();
+	compile->callback([&]() {
+		const auto commands = load_commands(globalArgs, workdir);
+
+		if (const auto written = xxlib::bundle::write(compileOutput, commands); !written) {
+			spdlog::error("Error writing bundle '{}': {}", compileOutput, written.error());
+			exitCode = 1;
+			return;
+		}
+
+		spdlog::info("Compiled {} commands into {}", commands.size(), compileOutput);
+		exitCode = 0;
+	});
 
-	auto* run = app.add_subcommand("run", "Run a specified command");
-	std::string commandName;
+	auto* run = app.add_subcommand("run", "Run one or more commands, one after another, stopping at the first failure");
+	std::vector<std::string> commandWords;
+	std::string bundlePath;
 	bool yoloFlag = false;
 	bool dryRunFlag = false;
-	run->add_option("command", commandName, "Name of the command to run")->required();
+	bool keepGoingFlag = false;
+	bool alwaysFlag = false;
+	bool hashInputsFlag = false;
+	size_t jobCount = 1;
+	std::string outputMode;
+	std::string remoteCacheUrl;
+	run->add_option("commands", commandWords, "Names of the commands to run, each optionally followed by its arguments as name[k=v,...] or k=v words; arguments after -- go to every command")->required();
+	run->add_option("--bundle", bundlePath, "Run from a bundle written by 'xx compile' instead of the configuration files");
 	run->add_flag("-y,--yolo", yoloFlag, "Run the command without confirmation, even if it requires confirmation");
 	run->add_flag("-n,--dry", dryRunFlag, "Perform a dry run without executing commands, act like they succeeded");
+	run->add_option("-j,--jobs", jobCount, "Run up to this many commands at the same time, capturing their output (0 for one per CPU)")->default_val(1);
+	run->add_flag("--keep-going", keepGoingFlag, "Keep running the remaining commands after one fails");
+	run->add_flag("--always", alwaysFlag, "Run commands with inputs or outputs even when they are up to date or cached");
+	run->add_flag("--hash-inputs", hashInputsFlag, "Compare inputs by content instead of modification time, e.g. on a fresh checkout");
+	run->add_option("--remote-cache", remoteCacheUrl, "Share the results of commands with cache: true through this HTTP cache instead of the local one")->envname("XX_REMOTE_CACHE");
+	run->add_option("--output-mode", outputMode, "How the output of commands run with -j is shown: grouped or prefixed")->default_val("grouped")->check(CLI::IsMember({"grouped", "prefixed"}));
 	run->allow_extras();
 	run->callback([&]() {
-		const auto commands = load_commands(globalArgs, workdir);
+		auto invocations = xxlib::planner::parse_invocations(commandWords);
+		if (!invocations) {
+			spdlog::error("{}", invocations.error());
+			exitCode = 1;
+			return;
+		}
+
+		std::optional<xxlib::bundle::Bundle> bundle;
+		xxlib::CommandRegistry registry;
+		if (!bundlePath.empty()) {
+			auto loadedBundle = xxlib::bundle::load(bundlePath);
+			if (!loadedBundle) {
+				spdlog::error("Error loading bundle '{}': {}", bundlePath, loadedBundle.error());
+				return;
+			}
+			bundle = std::move(*loadedBundle);
+			registry = xxlib::CommandRegistry(std::move(bundle->commands));
+		} else if (invocations->size() == 1) {
+			const auto& commandName = invocations->front().name;
+			registry = xxlib::CommandRegistry(load_commands(globalArgs, workdir, commandName));
+			// Prefix resolution, suggestions and depends_on need every alias, which a targeted load skips.
+			const auto candidates = registry.candidates(commandName);
+			const auto hasDependencies = std::any_of(candidates.begin(), candidates.end(), [&registry](size_t index) {
+				return !registry.commands()[index].dependsOn.empty();
+			});
+			if (candidates.empty() || hasDependencies) {
+				registry = xxlib::CommandRegistry(load_commands(globalArgs, workdir));
+			}
+		} else {
+			registry = xxlib::CommandRegistry(load_commands(globalArgs, workdir));
+		}
 
-		auto plannedCommand = xxlib::planner::plan_single(commands, commandName);
-		if (!plannedCommand.has_value()) {
-			spdlog::error("Error planning command '{}': {}", commandName, plannedCommand.error());
+		auto steps = xxlib::planner::plan_graph(registry, *invocations);
+		if (!steps.has_value()) {
+			spdlog::error("Error planning command: {}", steps.error());
 			return;
 		}
 
-		auto& commandToRun = plannedCommand.value();
+		// Unknown options and everything after -- are passed to every command.
+		auto sharedExtras = run->remaining();
+		sharedExtras.insert(sharedExtras.end(), separatedExtras.begin(), separatedExtras.end());
 
-		if (yoloFlag) {
-			commandToRun.requiresConfirmation = false;
-			spdlog::debug("yolo flag is set, requiresConfirmation will be ignored.");
+		auto jobs = make_jobs(*steps, sharedExtras, {.dryRun = dryRunFlag, .yolo = yoloFlag, .force = alwaysFlag, .hashInputs = hashInputsFlag, .remoteCacheUrl = remoteCacheUrl});
+		if (bundle) {
+			for (size_t i = 0; i < jobs.size(); ++i) {
+				jobs[i].context.luaBytecode = bundle->luaChunks[(*steps)[i].command - registry.commands().data()];
+			}
 		}
 
-		auto execContext = CommandContext{
-			.dryRun = dryRunFlag,
-			.extras = run->remaining(),
+		if (jobCount == 1 || jobs.size() == 1) {
+			exitCode = run_in_order(jobs, keepGoingFlag);
+			return;
+		}
+
+		// Commands running side by side cannot share the terminal for prompts, so confirmations are asked up front. A
+		// declined command keeps requiresConfirmation and counts as done without running, as a declined prompt does.
+		if (!dryRunFlag) {
+			for (auto& job : jobs) {
+				if (job.command.requiresConfirmation && xxlib::helpers::ask_for_confirmation("'" + job.command.name + "' wants to run: \n" + xxlib::command::join_cmd(job.command))) {
+					job.command.requiresConfirmation = false;
+				}
+			}
+		}
+		const auto execute = [](Command& command, CommandContext& context) -> std::expected<int32_t, std::string> {
+			if (command.requiresConfirmation && !context.dryRun) {
+				return 0;
+			}
+			return xxlib::executor::execute_command(command, context);
+		};
+
+		std::vector<std::string> names;
+		for (const auto& job : jobs) {
+			names.push_back(job.command.name);
+		}
+
+		const auto options = xxlib::parallel::Options{
+			.jobs = jobCount,
+			.keepGoing = keepGoingFlag,
+			.output = xxlib::parallel::string_to_output(outputMode),
 		};
+		const auto results = xxlib::parallel::run(std::move(jobs), options, stdout, execute);
+
+		size_t failures = 0;
+		size_t skipped = 0;
+		for (size_t i = 0; i < results.size(); ++i) {
+			const auto& result = results[i];
+			if (result.status == xxlib::parallel::Status::Error) {
+				spdlog::error("Error executing command '{}': {}", names[i], result.error);
+				++failures;
+			} else if (result.status == xxlib::parallel::Status::Failed) {
+				spdlog::error("Command '{}' failed with exit code {}", names[i], result.exitCode);
+				++failures;
+			} else if (result.status == xxlib::parallel::Status::Skipped) {
+				++skipped;
+			}
+		}
+		if (failures > 0) {
+			spdlog::error("{} of {} commands failed{}", failures, results.size(), skipped > 0 ? fmt::format(", {} skipped", skipped) : "");
+		}
 
-		auto execResult = xxlib::executor::execute_command(commandToRun, execContext);
+		exitCode = xxlib::parallel::combined_exit_code(results);
+	});
 
-		if (!execResult) {
-			spdlog::error("Error executing command '{}': {}", commandName, execResult.error());
+	auto* pick = app.add_subcommand("pick", "Pick a command to run interactively with fuzzy search");
+	bool pickYoloFlag = false;
+	bool pickDryRunFlag = false;
+	std::string pickRemoteCacheUrl;
+	pick->add_flag("-y,--yolo", pickYoloFlag, "Run the command without confirmation, even if it requires confirmation");
+	pick->add_flag("-n,--dry", pickDryRunFlag, "Perform a dry run without executing commands, act like they succeeded");
+	pick->add_option("--remote-cache", pickRemoteCacheUrl, "Share the results of commands with cache: true through this HTTP cache instead of the local one")->envname("XX_REMOTE_CACHE");
+	pick->callback([&]() {
+		const auto registry = xxlib::CommandRegistry(load_commands(globalArgs, workdir));
+
+		// Aliases defined once per platform show up once.
+		std::vector<std::string_view> names;
+		std::unordered_set<std::string_view> seen;
+		for (size_t i = 0; i < registry.commands().size(); ++i) {
+			const std::string_view name = registry.commands()[i].name;
+			if (registry.satisfied(i) && seen.insert(name).second) {
+				names.push_back(name);
+			}
+		}
+
+		const auto index = xxlib::FuzzyIndex(names);
+		const auto picked = xxlib::picker::run(index);
+		if (!picked) {
+			spdlog::error("Cannot start the picker: {}", picked.error());
+			exitCode = 1;
+			return;
+		}
+		if (!picked->has_value()) {
+			return;
+		}
+
+		const auto pickedName = std::string(index.name(**picked));
+		auto steps = xxlib::planner::plan_graph(registry, {{.name = pickedName}});
+		if (!steps.has_value()) {
+			spdlog::error("Error planning command '{}': {}", pickedName, steps.error());
 			return;
 		}
 
-		exitCode = execResult.value();
+		// The picked alias comes after everything it depends on; only it is asked for arguments.
+		auto& pickedStep = steps->back();
+		auto prompt = "Arguments for '" + pickedName + "'";
+		if (const auto unset = xxlib::helpers::get_uset_vars(pickedStep.command->templateVars); !unset.empty()) {
+			prompt += " (unset:";
+			for (const auto& var : unset) {
+				prompt += " " + var + "=";
+			}
+			prompt += ")";
+		}
+		pickedStep.extras = xxlib::helpers::split_arguments(xxlib::helpers::ask_for_line(prompt + ": "));
+
+		auto jobs = make_jobs(*steps, {}, {.dryRun = pickDryRunFlag, .yolo = pickYoloFlag, .remoteCacheUrl = pickRemoteCacheUrl});
+		exitCode = run_in_order(jobs, false);
 	});
 
+	// CLI11 would hand the words after -- to the positional command names, so they are split off before parsing.
+	// The completion words are passed through untouched.
+	for (int i = 1; i < argc && std::string_view(argv[i]) != "__complete"; ++i) {
+		if (std::string_view(argv[i]) == "--") {
+			separatedExtras.assign(argv + i + 1, argv + argc);
+			argc = i;
+			break;
+		}
+	}
+
 	CLI11_PARSE(app, argc, argv);
 
+	// Results are sent to the action cache in the background while later commands run.
+	xxlib::executor::wait_for_uploads();
 	return exitCode;
 }